@@ -213,13 +213,37 @@ class Graphics2dManager(System):
     def draw_vector(self, v:Vec2f, origin_pos:Vec2f, color:Color):
         pass
 
+class Prefab:
+    def __init__(self):
+        self.name = ""
+
+    def add_component(self, component_type, component_json=""):
+        """component_type is a Component value or an id from register_component_type"""
+        pass
+
+
 class SceneManager(System):
     def load_scene(self, scene_name):
         pass
 
+    def instantiate(self, prefab: Prefab, count: int, initializer=None) -> list:
+        """Create count entities from prefab, initializer(entity, index) is called on each of them"""
+        return []
+
 
 class Transform2dManager(System, ComponentManager):
-    pass
+    def translate_all(self, delta):
+        pass
+
+    def set_parent(self, entity, parent):
+        """Attach entity to parent keeping its local transform, 0 detaches it, returns False on a cycle"""
+        return True
+
+    def get_parent(self, entity):
+        return 0
+
+    def get_world_position(self, entity):
+        return Vec2f()
 
 
 class PythonEngine(System):
@@ -232,15 +256,66 @@ class EntityManager(System):
     def create_entity(self, wanted_entity):
         pass
 
+    def create_entities(self, count) -> list:
+        return []
+
     def destroy_entity(self, entity):
         pass
 
+    def destroy_entities(self, entities):
+        pass
+
+    def is_entity_valid(self, entity) -> bool:
+        pass
+
+    def get_entity(self, entity_name: str) -> int:
+        """Live entity with this name, 0 when there is none"""
+        return 0
+
+    def set_entity_name(self, entity, entity_name: str):
+        pass
+
+    def get_entity_name(self, entity) -> str:
+        return ""
+
     def has_components(self, entity, component):
         pass
 
+    def has_component_id(self, entity, component_type_id) -> bool:
+        pass
+
+    def add_component_id(self, entity, component_type_id):
+        pass
+
+    def remove_component_id(self, entity, component_type_id):
+        pass
+
+    def register_component_type(self, type_name) -> int:
+        """Runtime id of a component type, usable in get_view and the *_component_id methods"""
+        pass
+
+    def get_component_type_id(self, type_name) -> int:
+        pass
+
     def get_entities_with_type(self, componentType):
         pass
 
+    def get_view(self, *component_types) -> EntityView:
+        pass
+
+
+class EntityView:
+    mask = []
+
+    def __len__(self):
+        pass
+
+    def __iter__(self):
+        pass
+
+    def __contains__(self, entity):
+        pass
+
 
 class Body2dManager(System, ComponentManager):
     pass
@@ -254,10 +329,21 @@ class Configuration:
     def __init__(self):
         self.screen_size = Vec2f()
 
+class WorldSnapshot:
+    def is_empty(self) -> bool:
+        pass
+
+
 class Engine:
     def __init__(self):
         self.config = Configuration()
 
+    def save_snapshot(self, snapshot: WorldSnapshot):
+        pass
+
+    def restore_snapshot(self, snapshot: WorldSnapshot) -> bool:
+        pass
+
 
 class Component:
     Sprite = 0
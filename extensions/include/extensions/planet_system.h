@@ -76,6 +76,7 @@ private:
 	const float centerMass = 1000.0f;
 	const float planetMass = 1.0f;
 	const size_t entitiesNmb = 10'000;
+	std::vector<Entity> m_Entities;
 
 #ifndef WITH_PHYSICS
 	std::vector<Vec2f> m_Velocities{entitiesNmb};
@@ -28,6 +28,9 @@ SOFTWARE.
 #include <graphics/graphics2d.h>
 #include <physics/body2d.h>
 #include <physics/physics2d.h>
+#include <engine/scene.h>
+#include <engine/prefab.h>
+#include <engine/memory_manager.h>
 
 
 
@@ -54,58 +57,46 @@ void PlanetSystem::OnEngineInit()
 	auto config = m_Engine.GetConfig();
 	fixedDeltaTime = config->fixedDeltaTime;
 	screenSize = sf::Vector2f(config->screenResolution.x, config->screenResolution.y);
-	auto* entityManager = m_Engine.GetEntityManager();
-	entityManager->ResizeEntityNmb(entitiesNmb);
-
 #ifdef WITH_VERTEXARRAY
 	const auto textureId = m_TextureManager->LoadTexture("data/sprites/round.png");
 	texture = m_TextureManager->GetTexture(textureId);
 	textureSize = sf::Vector2f(texture->getSize().x, texture->getSize().y);
 #endif
 
-	for (auto i = 0u; i < entitiesNmb; i++)
+	//Every planet shares the same components, created in bulk from one prefab
+	Prefab planetPrefab;
+	planetPrefab.SetName("Planet");
+#ifndef MULTI_THREAD
+	planetPrefab.AddComponent(ComponentType::TRANSFORM2D);
+#endif
+#ifdef WITH_PHYSICS
+	planetPrefab.AddComponent(ComponentType::BODY2D, json{ { "body_type", p2BodyType::STATIC } });
+#endif
+#ifndef WITH_VERTEXARRAY
+	planetPrefab.AddComponent(ComponentType::SPRITE2D, json{ { "path", "data/sprites/round.png" } });
+#endif
+	//std::rand is not thread safe, the initializer runs on the main thread
+	m_Entities = m_Engine.GetSceneManager()->Instantiate(planetPrefab, entitiesNmb, [this](Entity newEntity, size_t i)
 	{
-		const auto newEntity = entityManager->CreateEntity(i + 1);
-
+		const sf::Vector2f position(std::rand() % static_cast<int>(screenSize.x), std::rand() % static_cast<int>(screenSize.y));
 #ifdef MULTI_THREAD
-		m_Positions[i] = sf::Vector2f(std::rand() % static_cast<int>(screenSize.x), std::rand() % static_cast<int>(screenSize.y));
+		(void) newEntity;
+		m_Positions[i] = position;
 #else
-		auto transformPtr = m_Transform2DManager->AddComponent(newEntity);
-		transformPtr->Position = sf::Vector2f(std::rand() % static_cast<int>(screenSize.x), std::rand() % static_cast<int>(screenSize.y));
+		m_Transform2DManager->GetComponentRef(newEntity).Position = position;
 #endif
 #ifdef WITH_PHYSICS
-		auto body = m_Body2DManager->AddComponent(newEntity);
-		body->SetLinearVelocity(CalculateInitSpeed(transformPtr->Position));
+		m_Body2DManager->GetComponentPtr(newEntity)->SetLinearVelocity(CalculateInitSpeed(position));
 #else
-#ifndef MULTI_THREAD
-		m_Velocities[i] = meter2pixel(CalculateInitSpeed(transformPtr->Position));
-#else
-
-		m_Velocities[i] = meter2pixel(CalculateInitSpeed(m_Positions[i]));
+		m_Velocities[i] = meter2pixel(CalculateInitSpeed(position));
 #endif
-#endif
-		
-#ifndef WITH_VERTEXARRAY
-		std::string texturePath = "data/sprites/round.png";
-		const auto textureId = m_TextureManager->LoadTexture(texturePath);
-		const auto texture = m_TextureManager->GetTexture(textureId);
-
-		auto sprite = m_SpriteManager->AddComponent(newEntity);
-		sprite->SetTexture(texture);
-
-		auto& spriteInfo = m_SpriteManager->GetComponentInfo(newEntity);
-		spriteInfo.name = "Sprite";
-		spriteInfo.sprite = sprite;
-		spriteInfo.textureId = textureId;
-		spriteInfo.texturePath = texturePath;
-#else
+#ifdef WITH_VERTEXARRAY
 		m_VertexArray[4 * i].texCoords = sf::Vector2f(0, 0);
 		m_VertexArray[4 * i + 1].texCoords = sf::Vector2f(textureSize.x, 0);
 		m_VertexArray[4 * i + 2].texCoords = textureSize;
 		m_VertexArray[4 * i + 3].texCoords = sf::Vector2f(0, textureSize.y);
 #endif
-
-	}
+	});
 }
 
 void PlanetSystem::OnUpdate(float dt)
@@ -142,7 +133,8 @@ void PlanetSystem::OnFixedUpdate()
 	auto& threadPool = m_Engine.GetThreadPool();
 	const auto coreNmb = threadPool.size();
 
-	std::vector<std::future<void>> joinFutures(coreNmb);
+	//Per-frame temporaries go to the frame arena of the main thread
+	std::pmr::vector<std::future<void>> joinFutures(coreNmb, &m_Engine.GetMemoryManager()->GetFrameArena());
 	for(int threadIndex = 0; threadIndex < coreNmb;threadIndex++)
 	{
 		int start = (threadIndex + 1)*entitiesNmb/ (coreNmb + 1);
@@ -160,11 +152,11 @@ void PlanetSystem::OnFixedUpdate()
 	{
 
 #ifdef WITH_PHYSICS
-		const auto transformPtr = m_Engine.GetTransform2dManager()->GetComponentPtr(i + 1);
-		auto bodyPtr = m_Engine.GetPhysicsManager()->GetBodyManager()->GetComponentPtr(i + 1);
+		const auto transformPtr = m_Transform2DManager->GetComponentPtr(m_Entities[i]);
+		auto bodyPtr = m_Body2DManager->GetComponentPtr(m_Entities[i]);
 		bodyPtr->ApplyForce(CalculateNewForce(transformPtr->Position));
 #else
-		auto transformPtr = m_Engine.GetTransform2dManager()->GetComponentPtr(i + 1);
+		auto transformPtr = m_Transform2DManager->GetComponentPtr(m_Entities[i]);
 		const auto force = meter2pixel(CalculateNewForce(transformPtr->Position));
 
 		m_Velocities[i] += force / planetMass * fixedDeltaTime;
@@ -45,5 +45,25 @@ struct p2AABB
 	* \brief Calculate the extends and return it
 	*/
 	p2Vec2 GetExtends() const;
+
+	/*
+	* The helpers below use m_BottomLeft as the minimum corner and m_TopRight as the maximum corner
+	*/
+	/**
+	* \brief Check if the two AABB overlap, touching counts as overlapping
+	*/
+	bool Overlaps(const p2AABB& aabb) const;
+	/**
+	* \brief Check if aabb is completely inside this one
+	*/
+	bool Contains(const p2AABB& aabb) const;
+	/**
+	* \brief Sum of the sides, used as the insertion cost in the p2AABBTree
+	*/
+	float GetPerimeter() const;
+	/**
+	* \brief Smallest AABB containing the two given ones
+	*/
+	static p2AABB Combine(const p2AABB& aabb1, const p2AABB& aabb2);
 };
 #endif // !SFGE_P2AABB:H
@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SFGE_P2AABBTREE_H
+#define SFGE_P2AABBTREE_H
+
+#include <vector>
+
+#include <p2aabb.h>
+#include <p2body.h>
+
+const int NULL_TREE_NODE = -1;
+/**
+* \brief Margin in meter added around the AABB stored in the tree, a body moving less than it is not reinserted
+*/
+const float AABB_TREE_MARGIN = 0.1f;
+/**
+* \brief The fat AABB is also extended in the direction of the displacement times this multiplier
+*/
+const float AABB_TREE_DISPLACEMENT_MULTIPLIER = 2.0f;
+
+/**
+* \brief Node of the p2AABBTree, leafs hold a body, free nodes are chained by next
+*/
+struct p2AABBTreeNode
+{
+	bool IsLeaf() const { return child1 == NULL_TREE_NODE; }
+
+	p2AABB aabb;
+	p2Body* body = nullptr;
+	int parent = NULL_TREE_NODE;
+	int next = NULL_TREE_NODE;
+	int child1 = NULL_TREE_NODE;
+	int child2 = NULL_TREE_NODE;
+	// Leafs have a height of 0, free nodes of -1
+	int height = -1;
+};
+
+/**
+* \brief Persistent dynamic AABB tree used as broad phase by the p2World.
+* Leafs store fat AABB so only the bodies leaving theirs are reinserted, the tree is kept balanced with rotations.
+* Nodes live in a pooled array and are addressed by index, freed nodes are reused by the next insertions
+*/
+class p2AABBTree
+{
+public:
+	p2AABBTree(float margin = AABB_TREE_MARGIN);
+	/**
+	* \brief Insert a body with its tight AABB, return the proxy id used to move and destroy it
+	*/
+	int CreateProxy(const p2AABB& aabb, p2Body* body);
+	void DestroyProxy(int proxyId);
+	/**
+	* \brief Reinsert the proxy only when aabb leaves its fat AABB
+	* \return true if the proxy was reinserted
+	*/
+	bool MoveProxy(int proxyId, const p2AABB& aabb, const p2Vec2& displacement);
+	const p2AABB& GetFatAABB(int proxyId) const;
+	p2Body* GetBody(int proxyId) const;
+	/**
+	* \brief Append every pair of overlapping fat AABB by colliding the tree against itself, each pair is given once
+	*/
+	void FindPairs(std::vector<p2BodyPair>& pairs) const;
+	/**
+	* \brief Remove all the proxies, the node pool keeps its capacity
+	*/
+	void Clear();
+	int GetHeight() const;
+	int GetProxyNmb() const;
+	size_t GetMemoryFootprint() const;
+private:
+	int AllocateNode();
+	void FreeNode(int nodeId);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	/**
+	* \brief Rotate the subtree if its children heights differ by more than one, return the new root of the subtree
+	*/
+	int Balance(int nodeId);
+	void FindPairs(int nodeId, std::vector<p2BodyPair>& pairs) const;
+	void FindPairs(int nodeA, int nodeB, std::vector<p2BodyPair>& pairs) const;
+
+	std::vector<p2AABBTreeNode> m_Nodes;
+	int m_Root = NULL_TREE_NODE;
+	int m_FreeList = NULL_TREE_NODE;
+	int m_ProxyNmb = 0;
+	float m_Margin;
+};
+
+#endif
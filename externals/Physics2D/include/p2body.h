@@ -53,6 +53,17 @@ struct p2BodyDef
 
 const size_t MAX_COLLIDER_LEN = 8;
 
+class p2Body;
+
+/**
+* \brief Two bodies whose AABB might overlap, output of the broad phase
+*/
+struct p2BodyPair
+{
+	p2Body* bodyA;
+	p2Body* bodyB;
+};
+
 /**
 * \brief Rigidbody representation
 */
@@ -73,17 +84,22 @@ public:
 	p2Vec2 GetMaxPosition();
 
 	p2Vec2 GetAABBExtends();
+	/**
+	* \brief World AABB of the body, grown by each collider created on it
+	*/
+	p2AABB GetAABB();
 
 	// Get the main collider
 	p2Collider* GetCollider();
 
 	// Get all the colliders
 	std::vector<p2Collider>* GetColliders();
+	int GetColliderNmb() const;
 
 	/**
 	* \brief Factory method creating a p2Collider
 	* \param colliderDef p2ColliderDef definition of the collider
-	* \return p2Collider collider attached to the p2Body
+	* \return p2Collider collider attached to the p2Body, nullptr when the body already has MAX_COLLIDER_LEN colliders
 	*/
 	p2Collider* CreateCollider(p2ColliderDef* colliderDef);
 	void ApplyForceToCenter(const p2Vec2& force);
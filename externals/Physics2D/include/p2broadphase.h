@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SFGE_P2BROADPHASE_H
+#define SFGE_P2BROADPHASE_H
+
+#include <vector>
+
+#include <p2body.h>
+#include <p2quadtree.h>
+#include <p2aabbtree.h>
+
+/**
+* \brief Strategy used by the p2World to find the pairs of bodies that might collide
+*/
+class p2BroadPhase
+{
+public:
+	virtual ~p2BroadPhase() = default;
+	/**
+	* \brief Append the pairs of bodies whose AABB might overlap, bodies without collider are ignored
+	* \param bodies the bodies of the p2World, only the first bodyNmb are used
+	* \param displacements movement of each body during the current step
+	*/
+	virtual void FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+		const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs) = 0;
+	/**
+	* \brief Bytes reserved by the broad phase structures
+	*/
+	virtual size_t GetMemoryFootprint() const = 0;
+	/**
+	* \brief Pairs that started or stopped overlapping during the last FindPairs.
+	* Only the broad phases keeping their pairs between steps report them, the others leave them empty
+	*/
+	const std::vector<p2BodyPair>& GetBeganPairs() const;
+	const std::vector<p2BodyPair>& GetEndedPairs() const;
+protected:
+	std::vector<p2BodyPair> m_BeganPairs;
+	std::vector<p2BodyPair> m_EndedPairs;
+};
+
+/**
+* \brief Rebuild a p2QuadTree every step and query it for each body
+*/
+class p2QuadTreeBroadPhase : public p2BroadPhase
+{
+public:
+	explicit p2QuadTreeBroadPhase(p2AABB bounds);
+	void FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+		const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs) override;
+	size_t GetMemoryFootprint() const override;
+private:
+	p2QuadTree m_ParentQuad;
+	// Bodies that could collide with the current body, keeps its capacity between steps
+	std::vector<p2Body*> m_ReturnedBodies;
+};
+
+/**
+* \brief Keep the bodies in a persistent p2AABBTree, only the bodies leaving their fat AABB are reinserted
+*/
+class p2AABBTreeBroadPhase : public p2BroadPhase
+{
+public:
+	explicit p2AABBTreeBroadPhase(float margin = AABB_TREE_MARGIN);
+	void FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+		const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs) override;
+	size_t GetMemoryFootprint() const override;
+	const p2AABBTree& GetTree() const;
+private:
+	p2AABBTree m_AABBTree;
+	// Proxy in the p2AABBTree of each body, NULL_TREE_NODE until the body has a collider
+	std::vector<int> m_BodyProxies;
+};
+
+#endif
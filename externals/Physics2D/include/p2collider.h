@@ -27,16 +27,20 @@ SOFTWARE.
 #define SFGE_P2COLLIDER_H
 
 #include <p2shape.h>
-#include "engine/entity.h"
+
+namespace sfge
+{
+struct ColliderData;
+}
 
 /**
 * \brief Struct defining a p2Collider when creating one
 */
 struct p2ColliderDef
 {
-	sfge::ColliderData* userData;
-	p2Shape* shape;
-	float restitution;
+	sfge::ColliderData* userData = nullptr;
+	p2Shape* shape = nullptr;
+	float restitution = 0.0f;
 	bool isSensor = false;
 };
 
@@ -58,12 +62,20 @@ public:
 	* \brief Return the userData
 	*/
 	sfge::ColliderData* GetUserData() const;
-	p2Shape* GetShape() const;
+	/**
+	* \brief Copy of the shape of the p2ColliderDef, nullptr if it had none
+	*/
+	const p2Shape* GetShape() const;
 	float GetRestitution() const;
 	void SetUserData(sfge::ColliderData* colliderData);
 private:
 	sfge::ColliderData* m_UserData = nullptr;
-	p2Shape m_Shape;
+	// The shape is copied so the p2ColliderDef one can be destroyed, only the member of m_ShapeType is used
+	bool m_HasShape = false;
+	ShapeType m_ShapeType = ShapeType::CIRCLE;
+	p2CircleShape m_CircleShape;
+	p2RectShape m_RectShape;
+	p2PolygonShape m_PolygonShape;
 	p2ColliderDef m_ColliderDefinition;
 };
 
@@ -25,8 +25,24 @@ SOFTWARE.
 #ifndef SFGE_P2CONTACT_H
 #define SFGE_P2CONTACT_H
 
+#include <vector>
+
 #include <p2collider.h>
 
+/**
+* \brief Contact points of two touching colliders, the normal goes from the collider A to the collider B
+*/
+struct p2Manifold
+{
+	p2Vec2 normal = p2Vec2(0.0f, 0.0f);
+	/**
+	* \brief Depth of the overlap along the normal
+	*/
+	float penetration = 0.0f;
+	p2Vec2 points[2];
+	int pointNmb = 0;
+};
+
 /**
 * \brief Representation of a contact given as argument in a p2ContactListener
 */
@@ -36,9 +52,15 @@ public:
 	p2Contact(p2Collider* col1, p2Collider* col2);
 	p2Collider* GetColliderA();
 	p2Collider* GetColliderB();
+	/**
+	* \brief Manifold of the last step, its normal goes from the collider A to the collider B of the contact
+	*/
+	const p2Manifold& GetManifold() const;
+	void SetManifold(const p2Manifold& manifold);
 private:
 	p2Collider* m_ColliderA;
 	p2Collider* m_ColliderB;
+	p2Manifold m_Manifold;
 };
 
 /**
@@ -51,19 +73,67 @@ public:
 	virtual void EndContact(p2Contact* contact) = 0;
 };
 
+const size_t CONTACT_PAGE_SIZE = 256;
+const size_t CONTACT_MIN_SLOT_NMB = 64;
+
 /**
-* \brief Managing the creation and destruction of contact between colliders
+* \brief Managing the creation and destruction of contact between colliders.
+* Contacts live in pages that never move so their address stays valid, the free ones are reused.
+* They are found with an open addressing hash map keyed on the ordered collider pair.
+* Each step stamps the contacts still touching, EndStep gives the begin and end events in one pass
 */
 class p2ContactManager
 {
 public:
+	/**
+	* \brief Create the contact if it does not exist yet and mark it as touching for the current step
+	* \return the new contact, nullptr if it already existed
+	*/
 	p2Contact* CreateContact(p2Collider* colliderA, p2Collider* colliderB);
-	int GetContactID(p2Collider* colliderA, p2Collider* colliderB);
+	/**
+	* \brief Find or create the contact and mark it as touching for the current step
+	*/
+	p2Contact* UpdateContact(p2Collider* colliderA, p2Collider* colliderB);
+	int GetContactID(p2Collider* colliderA, p2Collider* colliderB) const;
 	p2Contact* GetContactByID(int contactID);
 	void DestroyContact(p2Collider* colliderA, p2Collider* colliderB);
 	void DestroyContact(int contactID);
+	/**
+	* \brief Start a new step, the contacts not touched before EndStep end
+	*/
+	void BeginStep();
+	/**
+	* \brief Send BeginContact for the contacts created during the step, EndContact and destroy the ones not touched anymore
+	*/
+	void EndStep(p2ContactListener* contactListener);
+	int GetContactNmb() const;
+	size_t GetMemoryFootprint() const;
 private:
-	std::vector<p2Contact> m_Contacts;
-	int m_ContactIndex;
+	/**
+	* \brief Entry of the hash map, empty when contactID is -1
+	*/
+	struct Slot
+	{
+		p2Collider* colliderA = nullptr;
+		p2Collider* colliderB = nullptr;
+		int contactID = -1;
+	};
+
+	size_t GetHomeSlot(p2Collider* colliderA, p2Collider* colliderB) const;
+	/**
+	* \brief Slot holding the pair or the empty slot where it would be inserted, colliderA must be the lowest address
+	*/
+	size_t FindSlot(p2Collider* colliderA, p2Collider* colliderB) const;
+	void Rehash(size_t slotNmb);
+	p2Contact* AllocateContact(p2Collider* colliderA, p2Collider* colliderB);
+
+	std::vector<std::vector<p2Contact>> m_ContactPages;
+	// Step where each contact was created and last touched, 0 for the free contacts
+	std::vector<unsigned> m_BeginStamps;
+	std::vector<unsigned> m_TouchStamps;
+	std::vector<int> m_FreeContacts;
+	std::vector<Slot> m_Slots;
+	unsigned m_Stamp = 1;
+	int m_ContactIndex = 0;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SFGE_P2GRID_H
+#define SFGE_P2GRID_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <p2broadphase.h>
+
+const size_t GRID_MIN_BUCKET_NMB = 64;
+/**
+* \brief Cells are clamped to [-GRID_MAX_CELL, GRID_MAX_CELL], the bodies further away share the border cells
+*/
+const int GRID_MAX_CELL = 1 << 30;
+
+/**
+* \brief Broad phase hashing the bodies in a uniform grid, suited to many bodies of similar size.
+* The grid is rebuilt every step with a counting sort of the cells, the bodies of one cell being contiguous.
+* A pair is only emitted by the cell containing the bottom left corner of the overlap of the two AABB.
+* A body covering at least as many cells as there are buckets is added once to every bucket
+*/
+class p2GridBroadPhase : public p2BroadPhase
+{
+public:
+	/**
+	* \param cellSize side of a cell in meter, 0 uses the biggest side of the bodies AABB of each step
+	* \param threadNmb number of threads emitting the pairs, each one over a range of cells.
+	* The extra threads are started at the first step and wait for the next steps until the broad phase is destroyed
+	*/
+	explicit p2GridBroadPhase(float cellSize = 0.0f, int threadNmb = 1);
+	p2GridBroadPhase(const p2GridBroadPhase&) = delete;
+	p2GridBroadPhase& operator=(const p2GridBroadPhase&) = delete;
+	~p2GridBroadPhase() override;
+	void FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+		const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs) override;
+	size_t GetMemoryFootprint() const override;
+	/**
+	* \brief Cell size used during the last step
+	*/
+	float GetCellSize() const;
+	size_t GetBucketNmb() const;
+private:
+	int GetCell(float position) const;
+	size_t GetBucket(int cellX, int cellY) const;
+	void AddEntry(size_t bucket, size_t body);
+	void FindPairs(size_t firstBucket, size_t lastBucket, std::vector<p2BodyPair>& pairs) const;
+	void FindPairsParallel(std::vector<p2BodyPair>& pairs);
+	void RunWorker(int threadIndex);
+
+	float m_CellSizeDef;
+	float m_CellSize = 1.0f;
+	int m_ThreadNmb;
+	size_t m_BucketNmb = 0;
+
+	// Bodies with a collider and their AABB, indexed by the entries
+	std::vector<p2Body*> m_Bodies;
+	std::vector<p2AABB> m_AABBs;
+	// Bucket of each body and cell couple, kept for the scatter pass of the counting sort
+	std::vector<size_t> m_EntryBuckets;
+	std::vector<int> m_EntryBodies;
+	// The entries of bucket i are in m_Entries[m_BucketStarts[i], m_BucketStarts[i + 1])
+	std::vector<size_t> m_BucketStarts;
+	std::vector<size_t> m_BucketCursors;
+	// Index + 1 of the last body added to each bucket, a body covering several cells of a bucket is added once
+	std::vector<size_t> m_BucketStamps;
+	std::vector<int> m_Entries;
+	std::vector<std::vector<p2BodyPair>> m_ThreadPairs;
+
+	// Workers emitting the pairs of the other bucket ranges, woken up by a new job generation
+	std::vector<std::thread> m_Workers;
+	std::mutex m_WorkerMutex;
+	std::condition_variable m_JobStarted;
+	std::condition_variable m_JobDone;
+	size_t m_JobGeneration = 0;
+	int m_PendingWorkerNmb = 0;
+	bool m_StopWorkers = false;
+};
+
+#endif
@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SFGE_P2NARROWPHASE_H
+#define SFGE_P2NARROWPHASE_H
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+#include <p2body.h>
+#include <p2contact.h>
+
+/**
+* \brief Axis that separated two polygons, kept between steps to reject the pair with one projection
+*/
+struct p2SeparatingAxis
+{
+	// 0 when the axis is a face normal of the collider A, 1 of the collider B
+	int reference = 0;
+	int face = 0;
+	unsigned stamp = 0;
+};
+
+/*
+* Collision of two shapes at the given world positions, fill manifold when they touch.
+* The manifold normal goes from the first shape to the second one
+*/
+bool p2CollideCircles(p2Vec2 centerA, float radiusA, p2Vec2 centerB, float radiusB, p2Manifold& manifold);
+bool p2CollideRects(const p2AABB& rectA, const p2AABB& rectB, p2Manifold& manifold);
+bool p2CollideCircleRect(p2Vec2 center, float radius, const p2AABB& rect, p2Manifold& manifold);
+bool p2CollideCirclePolygon(p2Vec2 center, float radius, const p2PolygonShape& polygon, p2Vec2 polygonPosition, p2Manifold& manifold);
+/**
+* \brief SAT between two convex polygons with clipping of the incident edge, up to two points
+* \param separatingAxis written with the face that separates the polygons when they do not touch
+* \return false if the polygons are separated
+*/
+bool p2CollidePolygons(const p2PolygonShape& polygonA, p2Vec2 positionA,
+	const p2PolygonShape& polygonB, p2Vec2 positionB, p2Manifold& manifold, p2SeparatingAxis* separatingAxis = nullptr);
+/**
+* \brief Distance between the polygons along one face normal, positive when the face separates them
+*/
+float p2GetPolygonSeparation(const p2PolygonShape& polygonA, p2Vec2 positionA,
+	const p2PolygonShape& polygonB, p2Vec2 positionB, const p2SeparatingAxis& axis);
+
+/**
+* \brief Touching colliders found by the p2NarrowPhase
+*/
+struct p2ColliderManifold
+{
+	p2Collider* colliderA;
+	p2Collider* colliderB;
+	p2Manifold manifold;
+};
+
+/**
+* \brief Combination of shape types of a candidate pair, the collider with the lowest shape type is the first one
+*/
+enum class p2ShapePairType
+{
+	CIRCLE_CIRCLE,
+	CIRCLE_RECT,
+	CIRCLE_POLYGON,
+	RECT_RECT,
+	RECT_POLYGON,
+	POLYGON_POLYGON,
+	LENGTH
+};
+
+/**
+* \brief Colliders of a candidate pair with the position of their body
+*/
+struct p2ShapePair
+{
+	p2Collider* colliderA;
+	p2Collider* colliderB;
+	p2Vec2 positionA;
+	p2Vec2 positionB;
+};
+
+/**
+* \brief Exact collision of the candidate pairs of the broad phase.
+* The colliders are grouped by shape combination, circles and rects are rejected in SIMD batches
+* (8 pairs with AVX, 4 with SSE2) and only the touching ones compute their manifold.
+* The polygon pairs keep their last separating axis to reject the pair without a full SAT
+*/
+class p2NarrowPhase
+{
+public:
+	/**
+	* \brief Test the colliders of each body pair and append the touching ones with their manifold
+	*/
+	void Collide(const std::vector<p2BodyPair>& pairs, std::vector<p2ColliderManifold>& manifolds);
+	size_t GetShapePairNmb(p2ShapePairType shapePairType) const;
+	/**
+	* \brief Polygon pairs rejected by their cached separating axis during the last Collide
+	*/
+	size_t GetCachedAxisRejectNmb() const;
+	size_t GetMemoryFootprint() const;
+private:
+	struct ColliderPairHash
+	{
+		size_t operator()(const std::pair<const p2Collider*, const p2Collider*>& colliders) const;
+	};
+
+	void AddShapePair(p2Collider* colliderA, p2Collider* colliderB, p2Vec2 positionA, p2Vec2 positionB);
+	/**
+	* \brief Resize the lanes and the separations to exactly length pairs, the pairs after the last full SIMD batch are done in scalar code
+	*/
+	void ResizeBatch(size_t length);
+	void CollideCircles(std::vector<p2ColliderManifold>& manifolds);
+	void CollideCircleRects(std::vector<p2ColliderManifold>& manifolds);
+	void CollideRects(std::vector<p2ColliderManifold>& manifolds);
+	void CollideCirclePolygons(std::vector<p2ColliderManifold>& manifolds);
+	void CollidePolygons(p2ShapePairType shapePairType, std::vector<p2ColliderManifold>& manifolds);
+
+	static const int LANE_NMB = 8;
+	std::vector<p2ShapePair> m_ShapePairs[static_cast<int>(p2ShapePairType::LENGTH)];
+	// Struct-of-arrays inputs of the SIMD batches and their results, touching when <= 0
+	std::vector<float> m_Lanes[LANE_NMB];
+	std::vector<float> m_Separations;
+	std::unordered_map<std::pair<const p2Collider*, const p2Collider*>, p2SeparatingAxis, ColliderPairHash> m_SeparatingAxes;
+	unsigned m_Stamp = 0;
+	size_t m_CachedAxisRejectNmb = 0;
+};
+
+#endif
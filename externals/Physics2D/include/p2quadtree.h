@@ -40,6 +40,9 @@ public:
 	p2QuadTree();
 	p2QuadTree(int nodeLevel, p2AABB bounds);
 	~p2QuadTree();
+	// The children are owned by their parent
+	p2QuadTree(const p2QuadTree&) = delete;
+	p2QuadTree& operator=(const p2QuadTree&) = delete;
 
 	/**
 	* Remove all objects leafs and quadtrees children
@@ -59,9 +62,9 @@ public:
 	*/
 	void Insert(p2Body* obj);
 	/**
-	* Return a list of all the p2Body that might collide
+	* Append all the p2Body that might collide to returnedBodies, the caller keeps the buffer between calls
 	*/
-	std::vector<p2Body*> Retrieve(std::vector<p2Body*> returnedBodies, p2Body* body);
+	void Retrieve(std::vector<p2Body*>& returnedBodies, p2Body* body);
 	
 private:
 	static const int MAX_OBJECTS = 10;
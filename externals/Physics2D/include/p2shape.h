@@ -33,8 +33,15 @@ SOFTWARE.
 enum ShapeType
 {
 	CIRCLE,
-	RECT
+	RECT,
+	POLYGON
 };
+
+const int MAX_POLYGON_VERTICES = 8;
+/**
+* \brief Distance in meter under which polygon vertices are merged and a vertex is considered on the line of its neighbours
+*/
+const float POLYGON_LINEAR_SLOP = 0.005f;
 /**
 * \brief Abstract representation of a shape
 */
@@ -55,6 +62,7 @@ public:
 	* \brief Setter for the radius
 	*/
 	void SetRadius(float radius);
+	float GetRadius() const;
 private:
 	float m_Radius;
 };
@@ -67,13 +75,42 @@ class p2RectShape : public p2Shape
 public:
 	p2RectShape(p2Vec2 size = p2Vec2());
 	void SetSize(p2Vec2 size);
+	/**
+	* \brief Half extends of the rectangle
+	*/
+	p2Vec2 GetSize() const;
 private:
 	p2Vec2 m_Size;
 };
 
+/**
+* \brief Representation of a convex polygon, the vertices are relative to the body position
+*/
 class p2PolygonShape : public p2Shape
 {
-	
+public:
+	p2PolygonShape();
+	/**
+	* \brief Set the vertices of a convex polygon, clockwise ones are reversed. Only the first MAX_POLYGON_VERTICES are used.
+	* Duplicate and collinear vertices are dropped, with less than three vertices left or a concave polygon
+	* the shape is left empty and false is returned
+	*/
+	bool SetVertices(const p2Vec2* vertices, int vertexNmb);
+	void SetAsBox(p2Vec2 halfExtends);
+	int GetVertexNmb() const;
+	const p2Vec2& GetVertex(int index) const;
+	/**
+	* \brief Outward normal of the edge going from the vertex index to the next one
+	*/
+	const p2Vec2& GetNormal(int index) const;
+	/**
+	* \brief Biggest distance of the vertices from the body position on each axis
+	*/
+	p2Vec2 GetHalfExtends() const;
+private:
+	p2Vec2 m_Vertices[MAX_POLYGON_VERTICES];
+	p2Vec2 m_Normals[MAX_POLYGON_VERTICES];
+	int m_VertexNmb = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SFGE_P2SWEEPANDPRUNE_H
+#define SFGE_P2SWEEPANDPRUNE_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include <p2broadphase.h>
+
+/**
+* \brief Min or max of a body AABB on one axis, data holds the box index in the upper bits and the max flag in the lowest bit
+*/
+struct p2SweepEndpoint
+{
+	float value;
+	std::uint32_t data;
+
+	int GetBox() const { return static_cast<int>(data >> 1); }
+	bool IsMax() const { return (data & 1u) != 0; }
+};
+
+/**
+* \brief Body tracked by the p2SweepAndPruneBroadPhase with its AABB of the current step
+*/
+struct p2SweepBox
+{
+	p2AABB aabb;
+	p2Body* body;
+};
+
+/**
+* \brief Sort and sweep broad phase keeping the endpoints of the AABB sorted on both axes between steps.
+* The arrays are fixed with an insertion sort, close to O(n) when the bodies move little, and every swap
+* of a min and a max updates the persistent set of overlapping pairs, giving the began and ended pairs of the step.
+* Boxes exactly touching on an axis are not swapped and might not be reported
+*/
+class p2SweepAndPruneBroadPhase : public p2BroadPhase
+{
+public:
+	void FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+		const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs) override;
+	size_t GetMemoryFootprint() const override;
+	/**
+	* \brief Number of endpoint swaps done by the insertion sort during the last step
+	*/
+	size_t GetSwapNmb() const;
+private:
+	static std::uint64_t GetPairKey(int boxA, int boxB);
+	void SortAxis(int axis);
+	void AddPair(int boxA, int boxB);
+	void RemovePair(int boxA, int boxB);
+	/**
+	* \brief Remember the state of the pair before its first change of the step
+	*/
+	void MarkChanged(std::uint64_t key, bool wasOverlapping);
+
+	std::vector<p2SweepBox> m_Boxes;
+	// Box of each body, -1 until the body has a collider
+	std::vector<int> m_BodyBoxes;
+	std::vector<p2SweepEndpoint> m_Endpoints[2];
+	// Overlapping pairs, the map gives the index of a pair key in m_Pairs
+	std::vector<std::uint64_t> m_Pairs;
+	std::unordered_map<std::uint64_t, size_t> m_PairIndices;
+	// Pairs changed during the step and if they were overlapping before it
+	std::unordered_map<std::uint64_t, bool> m_ChangedPairs;
+	size_t m_SwapNmb = 0;
+};
+
+#endif
@@ -28,10 +28,45 @@ SOFTWARE.
 #include <p2vector.h>
 #include <p2body.h>
 #include <p2contact.h>
-#include <p2quadtree.h>
+#include <p2broadphase.h>
+#include <p2narrowphase.h>
+#include <memory>
 
 const size_t MAX_BODY_LEN = 256;
 
+/**
+* \brief Algorithm used by the p2World to find the pairs of bodies that might collide
+*/
+enum class p2BroadPhaseType
+{
+	QUADTREE,
+	AABB_TREE,
+	GRID,
+	SWEEP_AND_PRUNE
+};
+
+/**
+* \brief Struct defining the p2World when creating it
+*/
+struct p2WorldDef
+{
+	p2Vec2 gravity;
+	p2Vec2 screenResolution;
+	p2BroadPhaseType broadPhaseType = p2BroadPhaseType::AABB_TREE;
+	/**
+	* \brief Margin in meter of the fat AABB of the p2AABBTree
+	*/
+	float aabbMargin = AABB_TREE_MARGIN;
+	/**
+	* \brief Cell size in meter of the p2GridBroadPhase, 0 uses the biggest body
+	*/
+	float gridCellSize = 0.0f;
+	/**
+	* \brief Threads emitting the pairs of the p2GridBroadPhase
+	*/
+	int gridThreadNmb = 1;
+};
+
 /**
 * \brief Representation of the physical world in meter
 */
@@ -39,8 +74,9 @@ class p2World
 {
 public:
 	p2World(p2Vec2 gravity, p2Vec2 screenResolution);
+	explicit p2World(const p2WorldDef& worldDef);
 	/**
-	* \brief Simulate a new step of the physical world, simplify the resolution with a QuadTree, generate the new contacts
+	* \brief Simulate a new step of the physical world, simplify the resolution with the broad phase, generate the new contacts with their manifold
 	*/
 	void Step(float dt);
 	/**
@@ -51,13 +87,41 @@ public:
 	* \brief Set the contact listener
 	*/
 	void SetContactListener(p2ContactListener* contactListener);
+	/**
+	* \brief Broad phase type given in the p2WorldDef
+	*/
+	p2BroadPhaseType GetBroadPhaseType() const;
+	/**
+	* \brief Replace the broad phase, the new one starts from the current bodies at the next step
+	*/
+	void SetBroadPhase(std::unique_ptr<p2BroadPhase> broadPhase);
+	p2BroadPhase* GetBroadPhase() const;
+	/**
+	* \brief Pairs of bodies found by the broad phase during the last step
+	*/
+	const std::vector<p2BodyPair>& GetBodyPairs() const;
+	/**
+	* \brief Touching colliders found by the narrow phase during the last step
+	*/
+	const std::vector<p2ColliderManifold>& GetManifolds() const;
+	const p2NarrowPhase& GetNarrowPhase() const;
+	/**
+	* \brief Bytes reserved by the bodies, the broad phase, the narrow phase and the contacts
+	*/
+	size_t GetMemoryFootprint() const;
 private:
 	p2Vec2 m_ScreenResolution;
 	p2Vec2 m_Gravity;
 	std::vector<p2Body> m_Bodies;
-	p2QuadTree m_ParentQuad;
+	// Movement of each body during the current step, used by the broad phase
+	std::vector<p2Vec2> m_Displacements;
+	p2BroadPhaseType m_BroadPhaseType;
+	std::unique_ptr<p2BroadPhase> m_BroadPhase;
+	std::vector<p2BodyPair> m_BodyPairs;
+	p2NarrowPhase m_NarrowPhase;
+	std::vector<p2ColliderManifold> m_Manifolds;
 	p2ContactManager m_ContactManager;
-	p2ContactListener* m_ContactListener;
+	p2ContactListener* m_ContactListener = nullptr;
 	int m_BodyIndex = 0;
 };
 
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 
 #include <p2aabb.h>
+#include <algorithm>
 
 p2AABB::p2AABB(struct p2Vec2 bottomLeft, struct p2Vec2 topRight)
 {
@@ -45,3 +46,27 @@ p2Vec2 p2AABB::GetExtends() const
 {
 	return { m_BottomLeft.x + m_TopRight.x, m_BottomLeft.y + m_TopRight.y };
 }
+
+bool p2AABB::Overlaps(const p2AABB& aabb) const
+{
+	return m_BottomLeft.x <= aabb.m_TopRight.x && aabb.m_BottomLeft.x <= m_TopRight.x &&
+		m_BottomLeft.y <= aabb.m_TopRight.y && aabb.m_BottomLeft.y <= m_TopRight.y;
+}
+
+bool p2AABB::Contains(const p2AABB& aabb) const
+{
+	return m_BottomLeft.x <= aabb.m_BottomLeft.x && m_BottomLeft.y <= aabb.m_BottomLeft.y &&
+		aabb.m_TopRight.x <= m_TopRight.x && aabb.m_TopRight.y <= m_TopRight.y;
+}
+
+float p2AABB::GetPerimeter() const
+{
+	return 2.0f * ((m_TopRight.x - m_BottomLeft.x) + (m_TopRight.y - m_BottomLeft.y));
+}
+
+p2AABB p2AABB::Combine(const p2AABB& aabb1, const p2AABB& aabb2)
+{
+	return p2AABB(
+		{ std::min(aabb1.m_BottomLeft.x, aabb2.m_BottomLeft.x), std::min(aabb1.m_BottomLeft.y, aabb2.m_BottomLeft.y) },
+		{ std::max(aabb1.m_TopRight.x, aabb2.m_TopRight.x), std::max(aabb1.m_TopRight.y, aabb2.m_TopRight.y) });
+}
@@ -0,0 +1,426 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <p2aabbtree.h>
+#include <algorithm>
+
+p2AABBTree::p2AABBTree(float margin)
+{
+	m_Margin = margin;
+}
+
+int p2AABBTree::CreateProxy(const p2AABB& aabb, p2Body* body)
+{
+	const int proxyId = AllocateNode();
+
+	// Store a fat AABB so small movements do not need a reinsertion
+	const p2Vec2 margin(m_Margin, m_Margin);
+	m_Nodes[proxyId].aabb = p2AABB(aabb.m_BottomLeft - margin, aabb.m_TopRight + margin);
+	m_Nodes[proxyId].body = body;
+	m_Nodes[proxyId].height = 0;
+
+	InsertLeaf(proxyId);
+	m_ProxyNmb++;
+	return proxyId;
+}
+
+void p2AABBTree::DestroyProxy(int proxyId)
+{
+	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+	m_ProxyNmb--;
+}
+
+bool p2AABBTree::MoveProxy(int proxyId, const p2AABB& aabb, const p2Vec2& displacement)
+{
+	if (m_Nodes[proxyId].aabb.Contains(aabb))
+		return false;
+
+	RemoveLeaf(proxyId);
+
+	// Extend the AABB by the margin and in the direction of the movement
+	const p2Vec2 margin(m_Margin, m_Margin);
+	p2AABB fatAABB(aabb.m_BottomLeft - margin, aabb.m_TopRight + margin);
+	const p2Vec2 predictedDisplacement = displacement * AABB_TREE_DISPLACEMENT_MULTIPLIER;
+
+	if (predictedDisplacement.x < 0.0f)
+		fatAABB.m_BottomLeft.x += predictedDisplacement.x;
+	else
+		fatAABB.m_TopRight.x += predictedDisplacement.x;
+
+	if (predictedDisplacement.y < 0.0f)
+		fatAABB.m_BottomLeft.y += predictedDisplacement.y;
+	else
+		fatAABB.m_TopRight.y += predictedDisplacement.y;
+
+	m_Nodes[proxyId].aabb = fatAABB;
+	InsertLeaf(proxyId);
+	return true;
+}
+
+const p2AABB& p2AABBTree::GetFatAABB(int proxyId) const
+{
+	return m_Nodes[proxyId].aabb;
+}
+
+p2Body* p2AABBTree::GetBody(int proxyId) const
+{
+	return m_Nodes[proxyId].body;
+}
+
+void p2AABBTree::FindPairs(std::vector<p2BodyPair>& pairs) const
+{
+	if (m_Root != NULL_TREE_NODE)
+		FindPairs(m_Root, pairs);
+}
+
+void p2AABBTree::Clear()
+{
+	m_Nodes.clear();
+	m_Root = NULL_TREE_NODE;
+	m_FreeList = NULL_TREE_NODE;
+	m_ProxyNmb = 0;
+}
+
+int p2AABBTree::GetHeight() const
+{
+	if (m_Root == NULL_TREE_NODE)
+		return 0;
+	return m_Nodes[m_Root].height;
+}
+
+int p2AABBTree::GetProxyNmb() const
+{
+	return m_ProxyNmb;
+}
+
+size_t p2AABBTree::GetMemoryFootprint() const
+{
+	return m_Nodes.capacity() * sizeof(p2AABBTreeNode);
+}
+
+int p2AABBTree::AllocateNode()
+{
+	int nodeId;
+	if (m_FreeList == NULL_TREE_NODE)
+	{
+		// The pool grows geometrically, nodes are addressed by index so they survive the reallocation
+		m_Nodes.push_back(p2AABBTreeNode());
+		nodeId = static_cast<int>(m_Nodes.size()) - 1;
+	}
+	else
+	{
+		nodeId = m_FreeList;
+		m_FreeList = m_Nodes[nodeId].next;
+		m_Nodes[nodeId] = p2AABBTreeNode();
+	}
+	m_Nodes[nodeId].height = 0;
+	return nodeId;
+}
+
+void p2AABBTree::FreeNode(int nodeId)
+{
+	m_Nodes[nodeId].next = m_FreeList;
+	m_Nodes[nodeId].height = -1;
+	m_Nodes[nodeId].body = nullptr;
+	m_FreeList = nodeId;
+}
+
+void p2AABBTree::InsertLeaf(int leaf)
+{
+	if (m_Root == NULL_TREE_NODE)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].parent = NULL_TREE_NODE;
+		return;
+	}
+
+	// Find the best sibling by going down the cheapest branch, the cost being the growth of the perimeters
+	const p2AABB leafAABB = m_Nodes[leaf].aabb;
+	int index = m_Root;
+	while (!m_Nodes[index].IsLeaf())
+	{
+		const int child1 = m_Nodes[index].child1;
+		const int child2 = m_Nodes[index].child2;
+
+		const float perimeter = m_Nodes[index].aabb.GetPerimeter();
+		const float combinedPerimeter = p2AABB::Combine(m_Nodes[index].aabb, leafAABB).GetPerimeter();
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedPerimeter;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+		float cost1 = p2AABB::Combine(leafAABB, m_Nodes[child1].aabb).GetPerimeter() + inheritanceCost;
+		if (!m_Nodes[child1].IsLeaf())
+			cost1 -= m_Nodes[child1].aabb.GetPerimeter();
+
+		float cost2 = p2AABB::Combine(leafAABB, m_Nodes[child2].aabb).GetPerimeter() + inheritanceCost;
+		if (!m_Nodes[child2].IsLeaf())
+			cost2 -= m_Nodes[child2].aabb.GetPerimeter();
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+	const int sibling = index;
+
+	// Create a new parent for the sibling and the leaf, the node array might grow so no reference is kept over it
+	const int oldParent = m_Nodes[sibling].parent;
+	const int newParent = AllocateNode();
+	m_Nodes[newParent].parent = oldParent;
+	m_Nodes[newParent].aabb = p2AABB::Combine(leafAABB, m_Nodes[sibling].aabb);
+	m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+	m_Nodes[newParent].child1 = sibling;
+	m_Nodes[newParent].child2 = leaf;
+	m_Nodes[sibling].parent = newParent;
+	m_Nodes[leaf].parent = newParent;
+
+	if (oldParent != NULL_TREE_NODE)
+	{
+		if (m_Nodes[oldParent].child1 == sibling)
+			m_Nodes[oldParent].child1 = newParent;
+		else
+			m_Nodes[oldParent].child2 = newParent;
+	}
+	else
+	{
+		m_Root = newParent;
+	}
+
+	// Walk back up the tree fixing heights and AABB
+	index = m_Nodes[leaf].parent;
+	while (index != NULL_TREE_NODE)
+	{
+		index = Balance(index);
+
+		const int child1 = m_Nodes[index].child1;
+		const int child2 = m_Nodes[index].child2;
+		m_Nodes[index].height = 1 + std::max(m_Nodes[child1].height, m_Nodes[child2].height);
+		m_Nodes[index].aabb = p2AABB::Combine(m_Nodes[child1].aabb, m_Nodes[child2].aabb);
+
+		index = m_Nodes[index].parent;
+	}
+}
+
+void p2AABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = NULL_TREE_NODE;
+		return;
+	}
+
+	const int parent = m_Nodes[leaf].parent;
+	const int grandParent = m_Nodes[parent].parent;
+	const int sibling = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+	if (grandParent != NULL_TREE_NODE)
+	{
+		// Replace the parent by the sibling
+		if (m_Nodes[grandParent].child1 == parent)
+			m_Nodes[grandParent].child1 = sibling;
+		else
+			m_Nodes[grandParent].child2 = sibling;
+		m_Nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		// Walk back up the tree fixing heights and AABB
+		int index = grandParent;
+		while (index != NULL_TREE_NODE)
+		{
+			index = Balance(index);
+
+			const int child1 = m_Nodes[index].child1;
+			const int child2 = m_Nodes[index].child2;
+			m_Nodes[index].height = 1 + std::max(m_Nodes[child1].height, m_Nodes[child2].height);
+			m_Nodes[index].aabb = p2AABB::Combine(m_Nodes[child1].aabb, m_Nodes[child2].aabb);
+
+			index = m_Nodes[index].parent;
+		}
+	}
+	else
+	{
+		m_Root = sibling;
+		m_Nodes[sibling].parent = NULL_TREE_NODE;
+		FreeNode(parent);
+	}
+	m_Nodes[leaf].parent = NULL_TREE_NODE;
+}
+
+int p2AABBTree::Balance(int nodeId)
+{
+	p2AABBTreeNode* a = &m_Nodes[nodeId];
+	if (a->IsLeaf() || a->height < 2)
+		return nodeId;
+
+	const int indexB = a->child1;
+	const int indexC = a->child2;
+	p2AABBTreeNode* b = &m_Nodes[indexB];
+	p2AABBTreeNode* c = &m_Nodes[indexC];
+
+	const int balance = c->height - b->height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		const int indexF = c->child1;
+		const int indexG = c->child2;
+		p2AABBTreeNode* f = &m_Nodes[indexF];
+		p2AABBTreeNode* g = &m_Nodes[indexG];
+
+		// Swap A and C
+		c->child1 = nodeId;
+		c->parent = a->parent;
+		a->parent = indexC;
+
+		if (c->parent != NULL_TREE_NODE)
+		{
+			if (m_Nodes[c->parent].child1 == nodeId)
+				m_Nodes[c->parent].child1 = indexC;
+			else
+				m_Nodes[c->parent].child2 = indexC;
+		}
+		else
+		{
+			m_Root = indexC;
+		}
+
+		// Keep the highest child of C under C
+		if (f->height > g->height)
+		{
+			c->child2 = indexF;
+			a->child2 = indexG;
+			g->parent = nodeId;
+			a->aabb = p2AABB::Combine(b->aabb, g->aabb);
+			c->aabb = p2AABB::Combine(a->aabb, f->aabb);
+			a->height = 1 + std::max(b->height, g->height);
+			c->height = 1 + std::max(a->height, f->height);
+		}
+		else
+		{
+			c->child2 = indexG;
+			a->child2 = indexF;
+			f->parent = nodeId;
+			a->aabb = p2AABB::Combine(b->aabb, f->aabb);
+			c->aabb = p2AABB::Combine(a->aabb, g->aabb);
+			a->height = 1 + std::max(b->height, f->height);
+			c->height = 1 + std::max(a->height, g->height);
+		}
+		return indexC;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		const int indexD = b->child1;
+		const int indexE = b->child2;
+		p2AABBTreeNode* d = &m_Nodes[indexD];
+		p2AABBTreeNode* e = &m_Nodes[indexE];
+
+		// Swap A and B
+		b->child1 = nodeId;
+		b->parent = a->parent;
+		a->parent = indexB;
+
+		if (b->parent != NULL_TREE_NODE)
+		{
+			if (m_Nodes[b->parent].child1 == nodeId)
+				m_Nodes[b->parent].child1 = indexB;
+			else
+				m_Nodes[b->parent].child2 = indexB;
+		}
+		else
+		{
+			m_Root = indexB;
+		}
+
+		// Keep the highest child of B under B
+		if (d->height > e->height)
+		{
+			b->child2 = indexD;
+			a->child1 = indexE;
+			e->parent = nodeId;
+			a->aabb = p2AABB::Combine(c->aabb, e->aabb);
+			b->aabb = p2AABB::Combine(a->aabb, d->aabb);
+			a->height = 1 + std::max(c->height, e->height);
+			b->height = 1 + std::max(a->height, d->height);
+		}
+		else
+		{
+			b->child2 = indexE;
+			a->child1 = indexD;
+			d->parent = nodeId;
+			a->aabb = p2AABB::Combine(c->aabb, d->aabb);
+			b->aabb = p2AABB::Combine(a->aabb, e->aabb);
+			a->height = 1 + std::max(c->height, d->height);
+			b->height = 1 + std::max(a->height, e->height);
+		}
+		return indexB;
+	}
+
+	return nodeId;
+}
+
+void p2AABBTree::FindPairs(int nodeId, std::vector<p2BodyPair>& pairs) const
+{
+	const p2AABBTreeNode& node = m_Nodes[nodeId];
+	if (node.IsLeaf())
+		return;
+
+	// Pairs inside each child, then the pairs crossing the two children
+	FindPairs(node.child1, pairs);
+	FindPairs(node.child2, pairs);
+	FindPairs(node.child1, node.child2, pairs);
+}
+
+void p2AABBTree::FindPairs(int nodeA, int nodeB, std::vector<p2BodyPair>& pairs) const
+{
+	const p2AABBTreeNode& a = m_Nodes[nodeA];
+	const p2AABBTreeNode& b = m_Nodes[nodeB];
+	if (!a.aabb.Overlaps(b.aabb))
+		return;
+
+	if (a.IsLeaf() && b.IsLeaf())
+	{
+		p2BodyPair pair;
+		pair.bodyA = a.body;
+		pair.bodyB = b.body;
+		pairs.push_back(pair);
+		return;
+	}
+
+	// Descend into the biggest node
+	if (b.IsLeaf() || (!a.IsLeaf() && a.aabb.GetPerimeter() > b.aabb.GetPerimeter()))
+	{
+		FindPairs(a.child1, nodeB, pairs);
+		FindPairs(a.child2, nodeB, pairs);
+	}
+	else
+	{
+		FindPairs(nodeA, b.child1, pairs);
+		FindPairs(nodeA, b.child2, pairs);
+	}
+}
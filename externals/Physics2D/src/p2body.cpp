@@ -22,7 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <p2body.h>
-#include <iostream>
+#include <algorithm>
 
 void p2Body::Init(p2BodyDef* bodyDef)
 {
@@ -30,6 +30,8 @@ void p2Body::Init(p2BodyDef* bodyDef)
 	m_LinearVelocity = bodyDef->linearVelocity;
 	m_Position = bodyDef->position;
 	m_GravityScale = bodyDef->gravityScale;
+	m_AABB = p2AABB(p2Vec2(0.0f, 0.0f), p2Vec2(0.0f, 0.0f));
+	m_ColliderIndex = 0;
 	m_Colliders.resize(MAX_COLLIDER_LEN);
 }
 
@@ -67,6 +69,11 @@ p2Vec2 p2Body::GetAABBExtends()
 	return m_AABB.GetExtends();
 }
 
+p2AABB p2Body::GetAABB()
+{
+	return p2AABB(GetMinPosition(), GetMaxPosition());
+}
+
 p2Collider* p2Body::GetCollider()
 {
 	return &m_Colliders[0];
@@ -77,11 +84,44 @@ std::vector<p2Collider>* p2Body::GetColliders()
 	return &m_Colliders;
 }
 
+int p2Body::GetColliderNmb() const
+{
+	return m_ColliderIndex;
+}
+
 p2Collider * p2Body::CreateCollider(p2ColliderDef * colliderDef)
 {
-	p2Collider collider = p2Collider(*colliderDef);
-	m_Colliders.push_back(collider);
+	// The colliders are stored in the slots reserved by Init so their address stays valid
+	if (m_ColliderIndex >= static_cast<int>(m_Colliders.size()))
+		return nullptr;
+
+	p2Collider& collider = m_Colliders[m_ColliderIndex];
+	collider = p2Collider(*colliderDef);
 	m_ColliderIndex++;
+
+	// Grow the half extends of the body's AABB to contain the new shape
+	p2Vec2 halfExtends(0.0f, 0.0f);
+	if (colliderDef->shape != nullptr)
+	{
+		switch (colliderDef->shape->m_Type)
+		{
+		case ShapeType::CIRCLE:
+		{
+			const float radius = static_cast<p2CircleShape*>(colliderDef->shape)->GetRadius();
+			halfExtends = p2Vec2(radius, radius);
+			break;
+		}
+		case ShapeType::RECT:
+			halfExtends = static_cast<p2RectShape*>(colliderDef->shape)->GetSize();
+			break;
+		case ShapeType::POLYGON:
+			halfExtends = static_cast<p2PolygonShape*>(colliderDef->shape)->GetHalfExtends();
+			break;
+		}
+	}
+	m_AABB.m_BottomLeft = p2Vec2(std::max(m_AABB.m_BottomLeft.x, halfExtends.x), std::max(m_AABB.m_BottomLeft.y, halfExtends.y));
+	m_AABB.m_TopRight = p2Vec2(std::max(m_AABB.m_TopRight.x, halfExtends.x), std::max(m_AABB.m_TopRight.y, halfExtends.y));
+
 	return &collider;
 }
 
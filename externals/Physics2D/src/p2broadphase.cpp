@@ -0,0 +1,136 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <p2broadphase.h>
+#include <algorithm>
+
+const std::vector<p2BodyPair>& p2BroadPhase::GetBeganPairs() const
+{
+	return m_BeganPairs;
+}
+
+const std::vector<p2BodyPair>& p2BroadPhase::GetEndedPairs() const
+{
+	return m_EndedPairs;
+}
+
+p2QuadTreeBroadPhase::p2QuadTreeBroadPhase(p2AABB bounds) :
+	m_ParentQuad(0, bounds)
+{
+}
+
+void p2QuadTreeBroadPhase::FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+	const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs)
+{
+	(void)displacements;
+	const size_t firstPair = pairs.size();
+
+	// Add the bodies with a collider to the quadtree
+	for (int i = 0; i < bodyNmb; i++)
+	{
+		if (bodies[i].GetColliderNmb() > 0)
+			m_ParentQuad.Insert(&bodies[i]);
+	}
+
+	for (int i = 0; i < bodyNmb; i++)
+	{
+		if (bodies[i].GetColliderNmb() == 0)
+			continue;
+
+		m_ReturnedBodies.clear();
+
+		// Get the bodies that could collide with the current body
+		m_ParentQuad.Retrieve(m_ReturnedBodies, &bodies[i]);
+
+		for (size_t j = 0; j < m_ReturnedBodies.size(); j++)
+		{
+			if (m_ReturnedBodies[j] == &bodies[i])
+				continue;
+
+			// Order the pair by address so the same pair found from both bodies can be merged
+			p2BodyPair pair;
+			pair.bodyA = std::min(&bodies[i], m_ReturnedBodies[j]);
+			pair.bodyB = std::max(&bodies[i], m_ReturnedBodies[j]);
+			pairs.push_back(pair);
+		}
+	}
+
+	std::sort(pairs.begin() + firstPair, pairs.end(), [](const p2BodyPair& pair1, const p2BodyPair& pair2)
+	{
+		return pair1.bodyA < pair2.bodyA || (pair1.bodyA == pair2.bodyA && pair1.bodyB < pair2.bodyB);
+	});
+	pairs.erase(std::unique(pairs.begin() + firstPair, pairs.end(), [](const p2BodyPair& pair1, const p2BodyPair& pair2)
+	{
+		return pair1.bodyA == pair2.bodyA && pair1.bodyB == pair2.bodyB;
+	}), pairs.end());
+
+	// Reset the quadtree
+	m_ParentQuad.Clear();
+}
+
+size_t p2QuadTreeBroadPhase::GetMemoryFootprint() const
+{
+	return m_ReturnedBodies.capacity() * sizeof(p2Body*);
+}
+
+p2AABBTreeBroadPhase::p2AABBTreeBroadPhase(float margin) :
+	m_AABBTree(margin)
+{
+}
+
+void p2AABBTreeBroadPhase::FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+	const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs)
+{
+	if (m_BodyProxies.size() < bodies.size())
+		m_BodyProxies.resize(bodies.size(), NULL_TREE_NODE);
+
+	// Only the bodies that left their fat AABB are reinserted
+	for (int i = 0; i < bodyNmb; i++)
+	{
+		p2Body& body = bodies[i];
+		if (body.GetColliderNmb() == 0)
+			continue;
+
+		if (m_BodyProxies[i] == NULL_TREE_NODE)
+		{
+			m_BodyProxies[i] = m_AABBTree.CreateProxy(body.GetAABB(), &body);
+			continue;
+		}
+
+		// Static bodies are still checked as adding a collider grows their AABB
+		m_AABBTree.MoveProxy(m_BodyProxies[i], body.GetAABB(), displacements[i]);
+	}
+
+	m_AABBTree.FindPairs(pairs);
+}
+
+size_t p2AABBTreeBroadPhase::GetMemoryFootprint() const
+{
+	return m_BodyProxies.capacity() * sizeof(int) + m_AABBTree.GetMemoryFootprint();
+}
+
+const p2AABBTree& p2AABBTreeBroadPhase::GetTree() const
+{
+	return m_AABBTree;
+}
@@ -4,6 +4,25 @@ p2Collider::p2Collider(p2ColliderDef colDef)
 {
 	m_UserData = colDef.userData;
 	m_ColliderDefinition = colDef;
+	m_ColliderDefinition.shape = nullptr;
+
+	if (colDef.shape != nullptr)
+	{
+		m_HasShape = true;
+		m_ShapeType = colDef.shape->m_Type;
+		switch (m_ShapeType)
+		{
+		case ShapeType::CIRCLE:
+			m_CircleShape = *static_cast<p2CircleShape*>(colDef.shape);
+			break;
+		case ShapeType::RECT:
+			m_RectShape = *static_cast<p2RectShape*>(colDef.shape);
+			break;
+		case ShapeType::POLYGON:
+			m_PolygonShape = *static_cast<p2PolygonShape*>(colDef.shape);
+			break;
+		}
+	}
 }
 
 p2Collider::p2Collider()
@@ -22,9 +41,21 @@ sfge::ColliderData * p2Collider::GetUserData() const
 	return m_UserData;
 }
 
-p2Shape* p2Collider::GetShape() const
+const p2Shape* p2Collider::GetShape() const
 {
-	return m_ColliderDefinition.shape;
+	if (!m_HasShape)
+		return nullptr;
+
+	switch (m_ShapeType)
+	{
+	case ShapeType::RECT:
+		return &m_RectShape;
+	case ShapeType::POLYGON:
+		return &m_PolygonShape;
+	case ShapeType::CIRCLE:
+	default:
+		return &m_CircleShape;
+	}
 }
 
 float p2Collider::GetRestitution() const
@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include <p2contact.h>
+#include <algorithm>
+#include <cstdint>
 
 p2Contact::p2Contact(p2Collider* col1, p2Collider* col2)
 {
@@ -40,70 +42,204 @@ p2Collider * p2Contact::GetColliderB()
 	return m_ColliderB;
 }
 
-p2Contact* p2ContactManager::CreateContact(p2Collider* colliderA, p2Collider* colliderB)
+const p2Manifold& p2Contact::GetManifold() const
+{
+	return m_Manifold;
+}
+
+void p2Contact::SetManifold(const p2Manifold& manifold)
 {
-	// Try to get the contact composed with the given colliders
-	int checkContact = GetContactID(colliderA, colliderB);
+	m_Manifold = manifold;
+}
 
+p2Contact* p2ContactManager::CreateContact(p2Collider* colliderA, p2Collider* colliderB)
+{
 	// Check if a contact has been found
-	if (checkContact != -1)
+	const int contactID = GetContactID(colliderA, colliderB);
+	if (contactID != -1)
+	{
+		m_TouchStamps[contactID] = m_Stamp;
 		return nullptr;
+	}
 
-	// Create the contact
-	p2Contact contact = p2Contact(colliderA, colliderB);
+	return AllocateContact(colliderA, colliderB);
+}
 
-	m_Contacts.push_back(contact);
-	m_ContactIndex++;
+p2Contact* p2ContactManager::UpdateContact(p2Collider* colliderA, p2Collider* colliderB)
+{
+	const int contactID = GetContactID(colliderA, colliderB);
+	if (contactID != -1)
+	{
+		m_TouchStamps[contactID] = m_Stamp;
+		return GetContactByID(contactID);
+	}
+
+	return AllocateContact(colliderA, colliderB);
+}
 
-	// Return the newly created contact
-	return &contact;
+int p2ContactManager::GetContactID(p2Collider* colliderA, p2Collider* colliderB) const
+{
+	if (m_Slots.empty())
+		return -1;
+
+	if (colliderB < colliderA)
+		std::swap(colliderA, colliderB);
+
+	// The slot is empty when the contact does not exist
+	return m_Slots[FindSlot(colliderA, colliderB)].contactID;
+}
+
+p2Contact* p2ContactManager::GetContactByID(int contactID)
+{
+	return &m_ContactPages[contactID / CONTACT_PAGE_SIZE][contactID % CONTACT_PAGE_SIZE];
+}
+
+void p2ContactManager::DestroyContact(p2Collider* colliderA, p2Collider* colliderB)
+{
+	const int contactID = GetContactID(colliderA, colliderB);
+	if (contactID != -1)
+		DestroyContact(contactID);
 }
 
-int p2ContactManager::GetContactID(p2Collider* colliderA, p2Collider* colliderB)
+void p2ContactManager::DestroyContact(int contactID)
 {
-	for (int i = 0; i < m_ContactIndex; i++)
+	p2Contact* contact = GetContactByID(contactID);
+	p2Collider* colliderA = std::min(contact->GetColliderA(), contact->GetColliderB());
+	p2Collider* colliderB = std::max(contact->GetColliderA(), contact->GetColliderB());
+
+	// Backward shift deletion, the following slots of the cluster move back if their home allows it
+	const size_t mask = m_Slots.size() - 1;
+	size_t emptySlot = FindSlot(colliderA, colliderB);
+	size_t slot = emptySlot;
+	while (true)
 	{
-		// Get the colliders of the current contact
-		p2Collider* colA = m_Contacts[i].GetColliderA();
-		p2Collider* colB = m_Contacts[i].GetColliderB();
+		slot = (slot + 1) & mask;
+		if (m_Slots[slot].contactID == -1)
+			break;
 
-		// Check if the contact's colliders are the same as the function parameters
-		if((colA == colliderA && colB == colliderB) || (colA == colliderB && colB == colliderA))
+		const size_t homeSlot = GetHomeSlot(m_Slots[slot].colliderA, m_Slots[slot].colliderB);
+		// Distance from the home slot, the slot can move back if the empty slot is not before its home
+		if (((slot - homeSlot) & mask) >= ((slot - emptySlot) & mask))
 		{
-			return i;
+			m_Slots[emptySlot] = m_Slots[slot];
+			emptySlot = slot;
 		}
 	}
+	m_Slots[emptySlot] = Slot();
 
-	// Contact does not exist
-	return -1;
+	m_BeginStamps[contactID] = 0;
+	m_TouchStamps[contactID] = 0;
+	m_FreeContacts.push_back(contactID);
+	m_ContactIndex--;
 }
 
-p2Contact* p2ContactManager::GetContactByID(int contactID)
+void p2ContactManager::BeginStep()
 {
-	return &m_Contacts[contactID];
+	m_Stamp++;
 }
 
-void p2ContactManager::DestroyContact(p2Collider* colliderA, p2Collider* colliderB)
+void p2ContactManager::EndStep(p2ContactListener* contactListener)
 {
-	for (int i = 0; i < m_ContactIndex; i++)
+	const int contactNmb = static_cast<int>(m_TouchStamps.size());
+	for (int contactID = 0; contactID < contactNmb; contactID++)
 	{
-		// Get the colliders of the current contact
-		p2Collider* colA = m_Contacts[i].GetColliderA();
-		p2Collider* colB = m_Contacts[i].GetColliderB();
+		// Free contact
+		if (m_TouchStamps[contactID] == 0)
+			continue;
 
-		// Check if the contact's colliders are the same as the function parameters
-		if ((colA == colliderA && colB == colliderB) || (colA == colliderB && colB == colliderA))
+		if (m_TouchStamps[contactID] != m_Stamp)
 		{
-			m_Contacts.erase(m_Contacts.begin() + i);
-			m_ContactIndex--;
-			return;
+			if (contactListener != nullptr)
+				contactListener->EndContact(GetContactByID(contactID));
+			DestroyContact(contactID);
+		}
+		else if (m_BeginStamps[contactID] == m_Stamp && contactListener != nullptr)
+		{
+			contactListener->BeginContact(GetContactByID(contactID));
 		}
 	}
 }
 
-void p2ContactManager::DestroyContact(int contactID)
+int p2ContactManager::GetContactNmb() const
 {
-	m_Contacts.erase(m_Contacts.begin() + contactID);
-	m_ContactIndex--;
+	return m_ContactIndex;
+}
+
+size_t p2ContactManager::GetMemoryFootprint() const
+{
+	return m_ContactPages.size() * CONTACT_PAGE_SIZE * sizeof(p2Contact) +
+		(m_BeginStamps.capacity() + m_TouchStamps.capacity()) * sizeof(unsigned) +
+		m_FreeContacts.capacity() * sizeof(int) + m_Slots.capacity() * sizeof(Slot);
+}
+
+size_t p2ContactManager::GetHomeSlot(p2Collider* colliderA, p2Collider* colliderB) const
+{
+	// Mix the two addresses, the low bits of the pointers are always the same
+	std::uint64_t hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(colliderA)) * 0x9E3779B97F4A7C15ull;
+	hash ^= static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(colliderB)) + (hash << 6) + (hash >> 2);
+	hash ^= hash >> 29;
+	return static_cast<size_t>(hash) & (m_Slots.size() - 1);
+}
+
+size_t p2ContactManager::FindSlot(p2Collider* colliderA, p2Collider* colliderB) const
+{
+	const size_t mask = m_Slots.size() - 1;
+	size_t slot = GetHomeSlot(colliderA, colliderB);
+	while (m_Slots[slot].contactID != -1 &&
+		(m_Slots[slot].colliderA != colliderA || m_Slots[slot].colliderB != colliderB))
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
 }
 
+void p2ContactManager::Rehash(size_t slotNmb)
+{
+	std::vector<Slot> oldSlots;
+	oldSlots.swap(m_Slots);
+	m_Slots.resize(slotNmb);
+	for (size_t i = 0; i < oldSlots.size(); i++)
+	{
+		if (oldSlots[i].contactID != -1)
+			m_Slots[FindSlot(oldSlots[i].colliderA, oldSlots[i].colliderB)] = oldSlots[i];
+	}
+}
+
+p2Contact* p2ContactManager::AllocateContact(p2Collider* colliderA, p2Collider* colliderB)
+{
+	// Keep the map at most half full so the probe sequences stay short
+	if (2 * (m_ContactIndex + 1) > static_cast<int>(m_Slots.size()))
+		Rehash(std::max(CONTACT_MIN_SLOT_NMB, 2 * m_Slots.size()));
+
+	int contactID;
+	if (!m_FreeContacts.empty())
+	{
+		contactID = m_FreeContacts.back();
+		m_FreeContacts.pop_back();
+		*GetContactByID(contactID) = p2Contact(colliderA, colliderB);
+	}
+	else
+	{
+		contactID = static_cast<int>(m_TouchStamps.size());
+		if (contactID % CONTACT_PAGE_SIZE == 0)
+		{
+			// Pages never grow past their reserved size so the contacts never move
+			m_ContactPages.push_back(std::vector<p2Contact>());
+			m_ContactPages.back().reserve(CONTACT_PAGE_SIZE);
+		}
+		m_ContactPages.back().push_back(p2Contact(colliderA, colliderB));
+		m_BeginStamps.push_back(0);
+		m_TouchStamps.push_back(0);
+	}
+	m_BeginStamps[contactID] = m_Stamp;
+	m_TouchStamps[contactID] = m_Stamp;
+	m_ContactIndex++;
+
+	Slot slot;
+	slot.colliderA = std::min(colliderA, colliderB);
+	slot.colliderB = std::max(colliderA, colliderB);
+	slot.contactID = contactID;
+	m_Slots[FindSlot(slot.colliderA, slot.colliderB)] = slot;
+
+	return GetContactByID(contactID);
+}
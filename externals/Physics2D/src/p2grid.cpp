@@ -0,0 +1,269 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <p2grid.h>
+#include <algorithm>
+#include <cmath>
+
+p2GridBroadPhase::p2GridBroadPhase(float cellSize, int threadNmb)
+{
+	m_CellSizeDef = cellSize;
+	m_ThreadNmb = std::max(threadNmb, 1);
+}
+
+p2GridBroadPhase::~p2GridBroadPhase()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_WorkerMutex);
+		m_StopWorkers = true;
+	}
+	m_JobStarted.notify_all();
+	for (size_t i = 0; i < m_Workers.size(); i++)
+	{
+		m_Workers[i].join();
+	}
+}
+
+void p2GridBroadPhase::FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+	const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs)
+{
+	(void)displacements;
+	m_Bodies.clear();
+	m_AABBs.clear();
+
+	// Gather the AABB of the bodies with a collider
+	float biggestSide = 0.0f;
+	for (int i = 0; i < bodyNmb; i++)
+	{
+		if (bodies[i].GetColliderNmb() == 0)
+			continue;
+
+		const p2AABB aabb = bodies[i].GetAABB();
+		biggestSide = std::max(biggestSide, std::max(aabb.m_TopRight.x - aabb.m_BottomLeft.x, aabb.m_TopRight.y - aabb.m_BottomLeft.y));
+		m_Bodies.push_back(&bodies[i]);
+		m_AABBs.push_back(aabb);
+	}
+	if (m_Bodies.empty())
+		return;
+
+	// With cells at least as big as the bodies, each body covers at most four cells
+	m_CellSize = m_CellSizeDef > 0.0f ? m_CellSizeDef : biggestSide;
+	if (m_CellSize <= 0.0f)
+		m_CellSize = 1.0f;
+
+	m_BucketNmb = GRID_MIN_BUCKET_NMB;
+	while (m_BucketNmb < 2 * m_Bodies.size())
+		m_BucketNmb *= 2;
+
+	// Count the entries of each bucket, a body hashed twice in the same bucket is only added once
+	m_EntryBuckets.clear();
+	m_EntryBodies.clear();
+	m_BucketStarts.assign(m_BucketNmb + 1, 0);
+	m_BucketStamps.assign(m_BucketNmb, 0);
+	for (size_t i = 0; i < m_Bodies.size(); i++)
+	{
+		const int minX = GetCell(m_AABBs[i].m_BottomLeft.x);
+		const int minY = GetCell(m_AABBs[i].m_BottomLeft.y);
+		const int maxX = GetCell(m_AABBs[i].m_TopRight.x);
+		const int maxY = GetCell(m_AABBs[i].m_TopRight.y);
+		// A body covering more cells than there are buckets is in every bucket
+		const unsigned long long cellNmb = static_cast<unsigned long long>(static_cast<long long>(maxX) - minX + 1) *
+			static_cast<unsigned long long>(static_cast<long long>(maxY) - minY + 1);
+		if (cellNmb >= m_BucketNmb)
+		{
+			for (size_t bucket = 0; bucket < m_BucketNmb; bucket++)
+			{
+				AddEntry(bucket, i);
+			}
+			continue;
+		}
+		for (int cellY = minY; cellY <= maxY; cellY++)
+		{
+			for (int cellX = minX; cellX <= maxX; cellX++)
+			{
+				const size_t bucket = GetBucket(cellX, cellY);
+				if (m_BucketStamps[bucket] == i + 1)
+					continue;
+
+				AddEntry(bucket, i);
+			}
+		}
+	}
+
+	// Prefix sum then scatter the entries, the bodies of a bucket end up contiguous
+	for (size_t bucket = 0; bucket < m_BucketNmb; bucket++)
+	{
+		m_BucketStarts[bucket + 1] += m_BucketStarts[bucket];
+	}
+	m_BucketCursors.assign(m_BucketStarts.begin(), m_BucketStarts.end() - 1);
+	m_Entries.resize(m_EntryBuckets.size());
+	for (size_t i = 0; i < m_EntryBuckets.size(); i++)
+	{
+		m_Entries[m_BucketCursors[m_EntryBuckets[i]]++] = m_EntryBodies[i];
+	}
+
+	if (m_ThreadNmb == 1)
+	{
+		FindPairs(0, m_BucketNmb, pairs);
+		return;
+	}
+	FindPairsParallel(pairs);
+}
+
+size_t p2GridBroadPhase::GetMemoryFootprint() const
+{
+	size_t footprint = m_Bodies.capacity() * sizeof(p2Body*) + m_AABBs.capacity() * sizeof(p2AABB) +
+		m_EntryBuckets.capacity() * sizeof(size_t) + m_EntryBodies.capacity() * sizeof(int) +
+		m_BucketStarts.capacity() * sizeof(size_t) + m_BucketCursors.capacity() * sizeof(size_t) +
+		m_BucketStamps.capacity() * sizeof(size_t) +
+		m_Entries.capacity() * sizeof(int);
+	for (size_t i = 0; i < m_ThreadPairs.size(); i++)
+	{
+		footprint += m_ThreadPairs[i].capacity() * sizeof(p2BodyPair);
+	}
+	return footprint;
+}
+
+float p2GridBroadPhase::GetCellSize() const
+{
+	return m_CellSize;
+}
+
+size_t p2GridBroadPhase::GetBucketNmb() const
+{
+	return m_BucketNmb;
+}
+
+int p2GridBroadPhase::GetCell(float position) const
+{
+	// Converting a float out of the int range is undefined, NaN ends up in the first cell
+	const float cell = std::floor(position / m_CellSize);
+	if (!(cell > static_cast<float>(-GRID_MAX_CELL)))
+		return -GRID_MAX_CELL;
+	if (cell > static_cast<float>(GRID_MAX_CELL))
+		return GRID_MAX_CELL;
+	return static_cast<int>(cell);
+}
+
+void p2GridBroadPhase::AddEntry(size_t bucket, size_t body)
+{
+	m_BucketStamps[bucket] = body + 1;
+	m_EntryBuckets.push_back(bucket);
+	m_EntryBodies.push_back(static_cast<int>(body));
+	m_BucketStarts[bucket + 1]++;
+}
+
+size_t p2GridBroadPhase::GetBucket(int cellX, int cellY) const
+{
+	// m_BucketNmb is a power of two
+	const unsigned hash = static_cast<unsigned>(cellX) * 73856093u ^ static_cast<unsigned>(cellY) * 19349663u;
+	return hash & (m_BucketNmb - 1);
+}
+
+void p2GridBroadPhase::FindPairs(size_t firstBucket, size_t lastBucket, std::vector<p2BodyPair>& pairs) const
+{
+	for (size_t bucket = firstBucket; bucket < lastBucket; bucket++)
+	{
+		const size_t start = m_BucketStarts[bucket];
+		const size_t end = m_BucketStarts[bucket + 1];
+		for (size_t i = start; i < end; i++)
+		{
+			const int bodyA = m_Entries[i];
+			const p2AABB& aabbA = m_AABBs[bodyA];
+			for (size_t j = i + 1; j < end; j++)
+			{
+				const int bodyB = m_Entries[j];
+				const p2AABB& aabbB = m_AABBs[bodyB];
+				if (!aabbA.Overlaps(aabbB))
+					continue;
+
+				// Only the cell of the bottom left corner of the overlap emits the pair
+				const int cellX = GetCell(std::max(aabbA.m_BottomLeft.x, aabbB.m_BottomLeft.x));
+				const int cellY = GetCell(std::max(aabbA.m_BottomLeft.y, aabbB.m_BottomLeft.y));
+				if (GetBucket(cellX, cellY) != bucket)
+					continue;
+
+				p2BodyPair pair;
+				pair.bodyA = m_Bodies[bodyA];
+				pair.bodyB = m_Bodies[bodyB];
+				pairs.push_back(pair);
+			}
+		}
+	}
+}
+
+void p2GridBroadPhase::FindPairsParallel(std::vector<p2BodyPair>& pairs)
+{
+	m_ThreadPairs.resize(m_ThreadNmb);
+	if (m_Workers.empty())
+	{
+		for (int threadIndex = 1; threadIndex < m_ThreadNmb; threadIndex++)
+		{
+			m_Workers.push_back(std::thread(&p2GridBroadPhase::RunWorker, this, threadIndex));
+		}
+	}
+
+	// Each thread emits the pairs of a range of buckets in its own buffer
+	{
+		std::lock_guard<std::mutex> lock(m_WorkerMutex);
+		m_PendingWorkerNmb = m_ThreadNmb - 1;
+		m_JobGeneration++;
+	}
+	m_JobStarted.notify_all();
+	const size_t bucketsPerThread = (m_BucketNmb + m_ThreadNmb - 1) / m_ThreadNmb;
+	FindPairs(0, std::min(m_BucketNmb, bucketsPerThread), pairs);
+	{
+		std::unique_lock<std::mutex> lock(m_WorkerMutex);
+		m_JobDone.wait(lock, [this]() { return m_PendingWorkerNmb == 0; });
+	}
+	for (int threadIndex = 1; threadIndex < m_ThreadNmb; threadIndex++)
+	{
+		pairs.insert(pairs.end(), m_ThreadPairs[threadIndex].begin(), m_ThreadPairs[threadIndex].end());
+	}
+}
+
+void p2GridBroadPhase::RunWorker(int threadIndex)
+{
+	size_t jobGeneration = 0;
+	std::unique_lock<std::mutex> lock(m_WorkerMutex);
+	while (true)
+	{
+		m_JobStarted.wait(lock, [this, jobGeneration]() { return m_StopWorkers || m_JobGeneration != jobGeneration; });
+		if (m_StopWorkers)
+			return;
+		jobGeneration = m_JobGeneration;
+		lock.unlock();
+
+		const size_t bucketsPerThread = (m_BucketNmb + m_ThreadNmb - 1) / m_ThreadNmb;
+		const size_t firstBucket = std::min(m_BucketNmb, threadIndex * bucketsPerThread);
+		const size_t lastBucket = std::min(m_BucketNmb, firstBucket + bucketsPerThread);
+		std::vector<p2BodyPair>& threadPairs = m_ThreadPairs[threadIndex];
+		threadPairs.clear();
+		FindPairs(firstBucket, lastBucket, threadPairs);
+
+		lock.lock();
+		if (--m_PendingWorkerNmb == 0)
+			m_JobDone.notify_one();
+	}
+}
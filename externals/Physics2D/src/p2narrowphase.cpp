@@ -0,0 +1,735 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <p2narrowphase.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#if defined(__AVX__)
+#define P2_AVX
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define P2_SSE2
+#endif
+
+#if defined(P2_AVX)
+#include <immintrin.h>
+#elif defined(P2_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+const float NARROW_PHASE_EPSILON = 1.0e-6f;
+// Relative tolerance so the face of A stays the reference one when both polygons have the same separation
+const float REFERENCE_FACE_TOLERANCE = 0.98f;
+const float REFERENCE_FACE_ABSOLUTE_TOLERANCE = 0.001f;
+
+const p2ShapePairType SHAPE_PAIR_TYPES[3][3] =
+{
+	{ p2ShapePairType::CIRCLE_CIRCLE, p2ShapePairType::CIRCLE_RECT, p2ShapePairType::CIRCLE_POLYGON },
+	{ p2ShapePairType::CIRCLE_RECT, p2ShapePairType::RECT_RECT, p2ShapePairType::RECT_POLYGON },
+	{ p2ShapePairType::CIRCLE_POLYGON, p2ShapePairType::RECT_POLYGON, p2ShapePairType::POLYGON_POLYGON }
+};
+
+p2AABB GetRect(const p2Collider* collider, p2Vec2 position)
+{
+	const p2Vec2 halfExtends = static_cast<const p2RectShape*>(collider->GetShape())->GetSize();
+	return p2AABB(position - halfExtends, position + halfExtends);
+}
+
+/*
+* Separation kernels, one pair per index of the lanes.
+* The result is only compared to 0, positive when the pair is separated
+*/
+
+// lanes: centerA x, y, radiusA, centerB x, y, radiusB. Squared distance minus squared radii
+void CircleSeparations(float* const* lanes, float* separations, size_t length)
+{
+	size_t i = 0;
+#if defined(P2_AVX)
+	for (; i + 8 <= length; i += 8)
+	{
+		const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(lanes[3] + i), _mm256_loadu_ps(lanes[0] + i));
+		const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(lanes[4] + i), _mm256_loadu_ps(lanes[1] + i));
+		const __m256 radius = _mm256_add_ps(_mm256_loadu_ps(lanes[2] + i), _mm256_loadu_ps(lanes[5] + i));
+		const __m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		_mm256_storeu_ps(separations + i, _mm256_sub_ps(distance, _mm256_mul_ps(radius, radius)));
+	}
+#endif
+#if defined(P2_SSE2)
+	for (; i + 4 <= length; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(lanes[3] + i), _mm_loadu_ps(lanes[0] + i));
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(lanes[4] + i), _mm_loadu_ps(lanes[1] + i));
+		const __m128 radius = _mm_add_ps(_mm_loadu_ps(lanes[2] + i), _mm_loadu_ps(lanes[5] + i));
+		const __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		_mm_storeu_ps(separations + i, _mm_sub_ps(distance, _mm_mul_ps(radius, radius)));
+	}
+#endif
+	for (; i < length; i++)
+	{
+		const float dx = lanes[3][i] - lanes[0][i];
+		const float dy = lanes[4][i] - lanes[1][i];
+		const float radius = lanes[2][i] + lanes[5][i];
+		separations[i] = dx * dx + dy * dy - radius * radius;
+	}
+}
+
+// lanes: center x, y, radius, rect center x, y, half extends x, y. Squared distance to the rect minus squared radius
+void CircleRectSeparations(float* const* lanes, float* separations, size_t length)
+{
+	size_t i = 0;
+#if defined(P2_AVX)
+	const __m256 zero = _mm256_setzero_ps();
+	for (; i + 8 <= length; i += 8)
+	{
+		const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(lanes[3] + i), _mm256_loadu_ps(lanes[0] + i));
+		const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(lanes[4] + i), _mm256_loadu_ps(lanes[1] + i));
+		const __m256 outX = _mm256_max_ps(_mm256_sub_ps(_mm256_max_ps(dx, _mm256_sub_ps(zero, dx)), _mm256_loadu_ps(lanes[5] + i)), zero);
+		const __m256 outY = _mm256_max_ps(_mm256_sub_ps(_mm256_max_ps(dy, _mm256_sub_ps(zero, dy)), _mm256_loadu_ps(lanes[6] + i)), zero);
+		const __m256 radius = _mm256_loadu_ps(lanes[2] + i);
+		const __m256 distance = _mm256_add_ps(_mm256_mul_ps(outX, outX), _mm256_mul_ps(outY, outY));
+		_mm256_storeu_ps(separations + i, _mm256_sub_ps(distance, _mm256_mul_ps(radius, radius)));
+	}
+#endif
+#if defined(P2_SSE2)
+	const __m128 zero4 = _mm_setzero_ps();
+	for (; i + 4 <= length; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(lanes[3] + i), _mm_loadu_ps(lanes[0] + i));
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(lanes[4] + i), _mm_loadu_ps(lanes[1] + i));
+		const __m128 outX = _mm_max_ps(_mm_sub_ps(_mm_max_ps(dx, _mm_sub_ps(zero4, dx)), _mm_loadu_ps(lanes[5] + i)), zero4);
+		const __m128 outY = _mm_max_ps(_mm_sub_ps(_mm_max_ps(dy, _mm_sub_ps(zero4, dy)), _mm_loadu_ps(lanes[6] + i)), zero4);
+		const __m128 radius = _mm_loadu_ps(lanes[2] + i);
+		const __m128 distance = _mm_add_ps(_mm_mul_ps(outX, outX), _mm_mul_ps(outY, outY));
+		_mm_storeu_ps(separations + i, _mm_sub_ps(distance, _mm_mul_ps(radius, radius)));
+	}
+#endif
+	for (; i < length; i++)
+	{
+		const float outX = std::max(std::abs(lanes[3][i] - lanes[0][i]) - lanes[5][i], 0.0f);
+		const float outY = std::max(std::abs(lanes[4][i] - lanes[1][i]) - lanes[6][i], 0.0f);
+		separations[i] = outX * outX + outY * outY - lanes[2][i] * lanes[2][i];
+	}
+}
+
+// lanes: centerA x, y, half extends A x, y, centerB x, y, half extends B x, y. Biggest gap on the two axis
+void RectSeparations(float* const* lanes, float* separations, size_t length)
+{
+	size_t i = 0;
+#if defined(P2_AVX)
+	const __m256 zero = _mm256_setzero_ps();
+	for (; i + 8 <= length; i += 8)
+	{
+		const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(lanes[4] + i), _mm256_loadu_ps(lanes[0] + i));
+		const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(lanes[5] + i), _mm256_loadu_ps(lanes[1] + i));
+		const __m256 gapX = _mm256_sub_ps(_mm256_max_ps(dx, _mm256_sub_ps(zero, dx)),
+			_mm256_add_ps(_mm256_loadu_ps(lanes[2] + i), _mm256_loadu_ps(lanes[6] + i)));
+		const __m256 gapY = _mm256_sub_ps(_mm256_max_ps(dy, _mm256_sub_ps(zero, dy)),
+			_mm256_add_ps(_mm256_loadu_ps(lanes[3] + i), _mm256_loadu_ps(lanes[7] + i)));
+		_mm256_storeu_ps(separations + i, _mm256_max_ps(gapX, gapY));
+	}
+#endif
+#if defined(P2_SSE2)
+	const __m128 zero4 = _mm_setzero_ps();
+	for (; i + 4 <= length; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(lanes[4] + i), _mm_loadu_ps(lanes[0] + i));
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(lanes[5] + i), _mm_loadu_ps(lanes[1] + i));
+		const __m128 gapX = _mm_sub_ps(_mm_max_ps(dx, _mm_sub_ps(zero4, dx)),
+			_mm_add_ps(_mm_loadu_ps(lanes[2] + i), _mm_loadu_ps(lanes[6] + i)));
+		const __m128 gapY = _mm_sub_ps(_mm_max_ps(dy, _mm_sub_ps(zero4, dy)),
+			_mm_add_ps(_mm_loadu_ps(lanes[3] + i), _mm_loadu_ps(lanes[7] + i)));
+		_mm_storeu_ps(separations + i, _mm_max_ps(gapX, gapY));
+	}
+#endif
+	for (; i < length; i++)
+	{
+		const float gapX = std::abs(lanes[4][i] - lanes[0][i]) - (lanes[2][i] + lanes[6][i]);
+		const float gapY = std::abs(lanes[5][i] - lanes[1][i]) - (lanes[3][i] + lanes[7][i]);
+		separations[i] = std::max(gapX, gapY);
+	}
+}
+
+/*
+* Face of polygonA with the biggest separation from polygonB
+*/
+float FindMaxSeparation(const p2PolygonShape& polygonA, p2Vec2 positionA,
+	const p2PolygonShape& polygonB, p2Vec2 positionB, int& face)
+{
+	const p2Vec2 offset = positionB - positionA;
+	float maxSeparation = -std::numeric_limits<float>::max();
+	face = 0;
+	for (int i = 0; i < polygonA.GetVertexNmb(); i++)
+	{
+		const p2Vec2& normal = polygonA.GetNormal(i);
+		const p2Vec2& vertex = polygonA.GetVertex(i);
+		float separation = std::numeric_limits<float>::max();
+		for (int j = 0; j < polygonB.GetVertexNmb(); j++)
+		{
+			separation = std::min(separation, p2Vec2::Dot(normal, polygonB.GetVertex(j) + offset - vertex));
+		}
+		if (separation > maxSeparation)
+		{
+			maxSeparation = separation;
+			face = i;
+		}
+	}
+	return maxSeparation;
+}
+
+/*
+* Keep the part of the segment where Dot(normal, point) <= offset, return the number of points kept
+*/
+int ClipSegment(const p2Vec2 in[2], p2Vec2 out[2], p2Vec2 normal, float offset)
+{
+	int pointNmb = 0;
+	const float distance0 = p2Vec2::Dot(normal, in[0]) - offset;
+	const float distance1 = p2Vec2::Dot(normal, in[1]) - offset;
+	if (distance0 <= 0.0f)
+		out[pointNmb++] = in[0];
+	if (distance1 <= 0.0f)
+		out[pointNmb++] = in[1];
+	if (distance0 * distance1 < 0.0f)
+	{
+		const float t = distance0 / (distance0 - distance1);
+		out[pointNmb++] = in[0] + (in[1] - in[0]) * t;
+	}
+	return pointNmb;
+}
+}
+
+bool p2CollideCircles(p2Vec2 centerA, float radiusA, p2Vec2 centerB, float radiusB, p2Manifold& manifold)
+{
+	const p2Vec2 delta = centerB - centerA;
+	const float radius = radiusA + radiusB;
+	const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+	if (distanceSquared > radius * radius)
+		return false;
+
+	const float distance = std::sqrt(distanceSquared);
+	// Concentric circles are pushed along y
+	manifold.normal = distance > NARROW_PHASE_EPSILON ? delta / distance : p2Vec2(0.0f, 1.0f);
+	manifold.penetration = radius - distance;
+	manifold.points[0] = centerA + manifold.normal * (radiusA - manifold.penetration * 0.5f);
+	manifold.pointNmb = 1;
+	return true;
+}
+
+bool p2CollideRects(const p2AABB& rectA, const p2AABB& rectB, p2Manifold& manifold)
+{
+	const float left = std::max(rectA.m_BottomLeft.x, rectB.m_BottomLeft.x);
+	const float right = std::min(rectA.m_TopRight.x, rectB.m_TopRight.x);
+	const float bottom = std::max(rectA.m_BottomLeft.y, rectB.m_BottomLeft.y);
+	const float top = std::min(rectA.m_TopRight.y, rectB.m_TopRight.y);
+	const float overlapX = right - left;
+	const float overlapY = top - bottom;
+	if (overlapX < 0.0f || overlapY < 0.0f)
+		return false;
+
+	const p2Vec2 delta = (rectB.m_BottomLeft + rectB.m_TopRight) - (rectA.m_BottomLeft + rectA.m_TopRight);
+	// Separate along the smallest overlap, the points are the ends of the overlapping edges
+	if (overlapX < overlapY)
+	{
+		const float x = (left + right) * 0.5f;
+		manifold.normal = p2Vec2(delta.x < 0.0f ? -1.0f : 1.0f, 0.0f);
+		manifold.penetration = overlapX;
+		manifold.points[0] = p2Vec2(x, bottom);
+		manifold.points[1] = p2Vec2(x, top);
+	}
+	else
+	{
+		const float y = (bottom + top) * 0.5f;
+		manifold.normal = p2Vec2(0.0f, delta.y < 0.0f ? -1.0f : 1.0f);
+		manifold.penetration = overlapY;
+		manifold.points[0] = p2Vec2(left, y);
+		manifold.points[1] = p2Vec2(right, y);
+	}
+	manifold.pointNmb = 2;
+	return true;
+}
+
+bool p2CollideCircleRect(p2Vec2 center, float radius, const p2AABB& rect, p2Manifold& manifold)
+{
+	const p2Vec2 closest(
+		std::min(std::max(center.x, rect.m_BottomLeft.x), rect.m_TopRight.x),
+		std::min(std::max(center.y, rect.m_BottomLeft.y), rect.m_TopRight.y));
+	const p2Vec2 delta = closest - center;
+	const float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+	if (distanceSquared > radius * radius)
+		return false;
+
+	if (distanceSquared > NARROW_PHASE_EPSILON * NARROW_PHASE_EPSILON)
+	{
+		const float distance = std::sqrt(distanceSquared);
+		manifold.normal = delta / distance;
+		manifold.penetration = radius - distance;
+		manifold.points[0] = closest;
+	}
+	else
+	{
+		// The center is inside the rect, it leaves through the closest edge
+		const float distances[4] =
+		{
+			center.x - rect.m_BottomLeft.x,
+			rect.m_TopRight.x - center.x,
+			center.y - rect.m_BottomLeft.y,
+			rect.m_TopRight.y - center.y
+		};
+		const p2Vec2 normals[4] =
+		{
+			p2Vec2(1.0f, 0.0f),
+			p2Vec2(-1.0f, 0.0f),
+			p2Vec2(0.0f, 1.0f),
+			p2Vec2(0.0f, -1.0f)
+		};
+		const int edge = static_cast<int>(std::min_element(distances, distances + 4) - distances);
+		manifold.normal = normals[edge];
+		manifold.penetration = radius + distances[edge];
+		manifold.points[0] = center - manifold.normal * distances[edge];
+	}
+	manifold.pointNmb = 1;
+	return true;
+}
+
+bool p2CollideCirclePolygon(p2Vec2 center, float radius, const p2PolygonShape& polygon, p2Vec2 polygonPosition, p2Manifold& manifold)
+{
+	const int vertexNmb = polygon.GetVertexNmb();
+	if (vertexNmb == 0)
+		return false;
+
+	const p2Vec2 localCenter = center - polygonPosition;
+	int face = 0;
+	float maxSeparation = -std::numeric_limits<float>::max();
+	for (int i = 0; i < vertexNmb; i++)
+	{
+		const float separation = p2Vec2::Dot(polygon.GetNormal(i), localCenter - polygon.GetVertex(i));
+		if (separation > radius)
+			return false;
+		if (separation > maxSeparation)
+		{
+			maxSeparation = separation;
+			face = i;
+		}
+	}
+
+	const p2Vec2& faceNormal = polygon.GetNormal(face);
+	const p2Vec2& vertex1 = polygon.GetVertex(face);
+	const p2Vec2& vertex2 = polygon.GetVertex((face + 1) % vertexNmb);
+	manifold.pointNmb = 1;
+
+	// Outside the edge but before one of its ends, the closest feature is the vertex
+	if (maxSeparation > NARROW_PHASE_EPSILON)
+	{
+		const p2Vec2* vertex = nullptr;
+		if (p2Vec2::Dot(localCenter - vertex1, vertex2 - vertex1) <= 0.0f)
+			vertex = &vertex1;
+		else if (p2Vec2::Dot(localCenter - vertex2, vertex1 - vertex2) <= 0.0f)
+			vertex = &vertex2;
+
+		if (vertex != nullptr)
+		{
+			const p2Vec2 delta = *vertex - localCenter;
+			const float distance = delta.GetMagnitude();
+			if (distance > radius)
+				return false;
+			manifold.normal = distance > NARROW_PHASE_EPSILON ? delta / distance : faceNormal * -1.0f;
+			manifold.penetration = radius - distance;
+			manifold.points[0] = *vertex + polygonPosition;
+			return true;
+		}
+	}
+
+	manifold.normal = faceNormal * -1.0f;
+	manifold.penetration = radius - maxSeparation;
+	manifold.points[0] = center - faceNormal * maxSeparation;
+	return true;
+}
+
+float p2GetPolygonSeparation(const p2PolygonShape& polygonA, p2Vec2 positionA,
+	const p2PolygonShape& polygonB, p2Vec2 positionB, const p2SeparatingAxis& axis)
+{
+	const p2PolygonShape& reference = axis.reference == 0 ? polygonA : polygonB;
+	const p2PolygonShape& incident = axis.reference == 0 ? polygonB : polygonA;
+	if (axis.face >= reference.GetVertexNmb())
+		return -std::numeric_limits<float>::max();
+
+	const p2Vec2 offset = axis.reference == 0 ? positionB - positionA : positionA - positionB;
+	const p2Vec2& normal = reference.GetNormal(axis.face);
+	const p2Vec2& vertex = reference.GetVertex(axis.face);
+	float separation = std::numeric_limits<float>::max();
+	for (int i = 0; i < incident.GetVertexNmb(); i++)
+	{
+		separation = std::min(separation, p2Vec2::Dot(normal, incident.GetVertex(i) + offset - vertex));
+	}
+	return separation;
+}
+
+bool p2CollidePolygons(const p2PolygonShape& polygonA, p2Vec2 positionA,
+	const p2PolygonShape& polygonB, p2Vec2 positionB, p2Manifold& manifold, p2SeparatingAxis* separatingAxis)
+{
+	if (polygonA.GetVertexNmb() == 0 || polygonB.GetVertexNmb() == 0)
+		return false;
+
+	int faceA = 0;
+	const float separationA = FindMaxSeparation(polygonA, positionA, polygonB, positionB, faceA);
+	if (separationA > 0.0f)
+	{
+		if (separatingAxis != nullptr)
+		{
+			separatingAxis->reference = 0;
+			separatingAxis->face = faceA;
+		}
+		return false;
+	}
+	int faceB = 0;
+	const float separationB = FindMaxSeparation(polygonB, positionB, polygonA, positionA, faceB);
+	if (separationB > 0.0f)
+	{
+		if (separatingAxis != nullptr)
+		{
+			separatingAxis->reference = 1;
+			separatingAxis->face = faceB;
+		}
+		return false;
+	}
+
+	const bool flip = separationB > REFERENCE_FACE_TOLERANCE * separationA + REFERENCE_FACE_ABSOLUTE_TOLERANCE;
+	const p2PolygonShape& reference = flip ? polygonB : polygonA;
+	const p2PolygonShape& incident = flip ? polygonA : polygonB;
+	const p2Vec2 referencePosition = flip ? positionB : positionA;
+	const p2Vec2 incidentPosition = flip ? positionA : positionB;
+	const int referenceFace = flip ? faceB : faceA;
+
+	// The incident edge is the one facing the most against the reference normal
+	const p2Vec2 normal = reference.GetNormal(referenceFace);
+	int incidentFace = 0;
+	float minDot = std::numeric_limits<float>::max();
+	for (int i = 0; i < incident.GetVertexNmb(); i++)
+	{
+		const float dot = p2Vec2::Dot(normal, incident.GetNormal(i));
+		if (dot < minDot)
+		{
+			minDot = dot;
+			incidentFace = i;
+		}
+	}
+	const p2Vec2 incidentEdge[2] =
+	{
+		incident.GetVertex(incidentFace) + incidentPosition,
+		incident.GetVertex((incidentFace + 1) % incident.GetVertexNmb()) + incidentPosition
+	};
+
+	// Clip the incident edge to the side planes of the reference edge
+	const p2Vec2 vertex1 = reference.GetVertex(referenceFace) + referencePosition;
+	const p2Vec2 vertex2 = reference.GetVertex((referenceFace + 1) % reference.GetVertexNmb()) + referencePosition;
+	const p2Vec2 tangent = (vertex2 - vertex1).Normalized();
+	p2Vec2 clipped1[2];
+	p2Vec2 clipped2[2];
+	if (ClipSegment(incidentEdge, clipped1, tangent * -1.0f, -p2Vec2::Dot(tangent, vertex1)) < 2)
+		return false;
+	if (ClipSegment(clipped1, clipped2, tangent, p2Vec2::Dot(tangent, vertex2)) < 2)
+		return false;
+
+	// Keep the points below the reference edge
+	const float referenceOffset = p2Vec2::Dot(normal, vertex1);
+	manifold.pointNmb = 0;
+	manifold.penetration = 0.0f;
+	for (int i = 0; i < 2; i++)
+	{
+		const float separation = p2Vec2::Dot(normal, clipped2[i]) - referenceOffset;
+		if (separation <= 0.0f)
+		{
+			manifold.points[manifold.pointNmb++] = clipped2[i];
+			manifold.penetration = std::max(manifold.penetration, -separation);
+		}
+	}
+	manifold.normal = flip ? normal * -1.0f : normal;
+	return manifold.pointNmb > 0;
+}
+
+void p2NarrowPhase::Collide(const std::vector<p2BodyPair>& pairs, std::vector<p2ColliderManifold>& manifolds)
+{
+	m_Stamp++;
+	m_CachedAxisRejectNmb = 0;
+	for (auto& shapePairs : m_ShapePairs)
+	{
+		shapePairs.clear();
+	}
+
+	// Group every collider combination of the body pairs by shape types
+	for (const p2BodyPair& pair : pairs)
+	{
+		std::vector<p2Collider>& collidersA = *pair.bodyA->GetColliders();
+		std::vector<p2Collider>& collidersB = *pair.bodyB->GetColliders();
+		const p2Vec2 positionA = pair.bodyA->GetPosition();
+		const p2Vec2 positionB = pair.bodyB->GetPosition();
+		for (int i = 0; i < pair.bodyA->GetColliderNmb(); i++)
+		{
+			if (collidersA[i].GetShape() == nullptr)
+				continue;
+			for (int j = 0; j < pair.bodyB->GetColliderNmb(); j++)
+			{
+				if (collidersB[j].GetShape() == nullptr)
+					continue;
+				AddShapePair(&collidersA[i], &collidersB[j], positionA, positionB);
+			}
+		}
+	}
+
+	CollideCircles(manifolds);
+	CollideCircleRects(manifolds);
+	CollideRects(manifolds);
+	CollideCirclePolygons(manifolds);
+	CollidePolygons(p2ShapePairType::RECT_POLYGON, manifolds);
+	CollidePolygons(p2ShapePairType::POLYGON_POLYGON, manifolds);
+
+	// Forget the axes of the pairs that left the broad phase
+	for (auto it = m_SeparatingAxes.begin(); it != m_SeparatingAxes.end();)
+	{
+		if (it->second.stamp != m_Stamp)
+			it = m_SeparatingAxes.erase(it);
+		else
+			++it;
+	}
+}
+
+size_t p2NarrowPhase::GetShapePairNmb(p2ShapePairType shapePairType) const
+{
+	return m_ShapePairs[static_cast<int>(shapePairType)].size();
+}
+
+size_t p2NarrowPhase::GetCachedAxisRejectNmb() const
+{
+	return m_CachedAxisRejectNmb;
+}
+
+size_t p2NarrowPhase::GetMemoryFootprint() const
+{
+	size_t footprint = m_Separations.capacity() * sizeof(float);
+	for (const auto& shapePairs : m_ShapePairs)
+	{
+		footprint += shapePairs.capacity() * sizeof(p2ShapePair);
+	}
+	for (const auto& lane : m_Lanes)
+	{
+		footprint += lane.capacity() * sizeof(float);
+	}
+	// The hash map is counted by its buckets and one node per element
+	const size_t nodeSize = sizeof(std::pair<const p2Collider*, const p2Collider*>) + sizeof(p2SeparatingAxis) + sizeof(void*);
+	return footprint + m_SeparatingAxes.bucket_count() * sizeof(void*) + m_SeparatingAxes.size() * nodeSize;
+}
+
+size_t p2NarrowPhase::ColliderPairHash::operator()(const std::pair<const p2Collider*, const p2Collider*>& colliders) const
+{
+	const size_t hashA = std::hash<const p2Collider*>()(colliders.first);
+	return hashA ^ (std::hash<const p2Collider*>()(colliders.second) + 0x9E3779B9 + (hashA << 6) + (hashA >> 2));
+}
+
+void p2NarrowPhase::AddShapePair(p2Collider* colliderA, p2Collider* colliderB, p2Vec2 positionA, p2Vec2 positionB)
+{
+	const ShapeType typeA = colliderA->GetShape()->m_Type;
+	const ShapeType typeB = colliderB->GetShape()->m_Type;
+	// Lowest shape type first, same types are ordered by address so a pair keeps its order between steps
+	if (typeA > typeB || (typeA == typeB && std::less<p2Collider*>()(colliderB, colliderA)))
+	{
+		std::swap(colliderA, colliderB);
+		std::swap(positionA, positionB);
+	}
+	m_ShapePairs[static_cast<int>(SHAPE_PAIR_TYPES[typeA][typeB])].push_back({ colliderA, colliderB, positionA, positionB });
+}
+
+void p2NarrowPhase::ResizeBatch(size_t length)
+{
+	for (auto& lane : m_Lanes)
+	{
+		lane.resize(length);
+	}
+	m_Separations.resize(length);
+}
+
+void p2NarrowPhase::CollideCircles(std::vector<p2ColliderManifold>& manifolds)
+{
+	const std::vector<p2ShapePair>& shapePairs = m_ShapePairs[static_cast<int>(p2ShapePairType::CIRCLE_CIRCLE)];
+	ResizeBatch(shapePairs.size());
+	for (size_t i = 0; i < shapePairs.size(); i++)
+	{
+		const p2ShapePair& shapePair = shapePairs[i];
+		m_Lanes[0][i] = shapePair.positionA.x;
+		m_Lanes[1][i] = shapePair.positionA.y;
+		m_Lanes[2][i] = static_cast<const p2CircleShape*>(shapePair.colliderA->GetShape())->GetRadius();
+		m_Lanes[3][i] = shapePair.positionB.x;
+		m_Lanes[4][i] = shapePair.positionB.y;
+		m_Lanes[5][i] = static_cast<const p2CircleShape*>(shapePair.colliderB->GetShape())->GetRadius();
+	}
+	float* lanes[LANE_NMB];
+	for (int i = 0; i < LANE_NMB; i++)
+	{
+		lanes[i] = m_Lanes[i].data();
+	}
+	CircleSeparations(lanes, m_Separations.data(), shapePairs.size());
+
+	for (size_t i = 0; i < shapePairs.size(); i++)
+	{
+		if (m_Separations[i] > 0.0f)
+			continue;
+		const p2ShapePair& shapePair = shapePairs[i];
+		p2Manifold manifold;
+		if (p2CollideCircles(shapePair.positionA, m_Lanes[2][i], shapePair.positionB, m_Lanes[5][i], manifold))
+		{
+			manifolds.push_back({ shapePair.colliderA, shapePair.colliderB, manifold });
+		}
+	}
+}
+
+void p2NarrowPhase::CollideCircleRects(std::vector<p2ColliderManifold>& manifolds)
+{
+	const std::vector<p2ShapePair>& shapePairs = m_ShapePairs[static_cast<int>(p2ShapePairType::CIRCLE_RECT)];
+	ResizeBatch(shapePairs.size());
+	for (size_t i = 0; i < shapePairs.size(); i++)
+	{
+		const p2ShapePair& shapePair = shapePairs[i];
+		const p2Vec2 halfExtends = static_cast<const p2RectShape*>(shapePair.colliderB->GetShape())->GetSize();
+		m_Lanes[0][i] = shapePair.positionA.x;
+		m_Lanes[1][i] = shapePair.positionA.y;
+		m_Lanes[2][i] = static_cast<const p2CircleShape*>(shapePair.colliderA->GetShape())->GetRadius();
+		m_Lanes[3][i] = shapePair.positionB.x;
+		m_Lanes[4][i] = shapePair.positionB.y;
+		m_Lanes[5][i] = halfExtends.x;
+		m_Lanes[6][i] = halfExtends.y;
+	}
+	float* lanes[LANE_NMB];
+	for (int i = 0; i < LANE_NMB; i++)
+	{
+		lanes[i] = m_Lanes[i].data();
+	}
+	CircleRectSeparations(lanes, m_Separations.data(), shapePairs.size());
+
+	for (size_t i = 0; i < shapePairs.size(); i++)
+	{
+		if (m_Separations[i] > 0.0f)
+			continue;
+		const p2ShapePair& shapePair = shapePairs[i];
+		p2Manifold manifold;
+		if (p2CollideCircleRect(shapePair.positionA, m_Lanes[2][i], GetRect(shapePair.colliderB, shapePair.positionB), manifold))
+		{
+			manifolds.push_back({ shapePair.colliderA, shapePair.colliderB, manifold });
+		}
+	}
+}
+
+void p2NarrowPhase::CollideRects(std::vector<p2ColliderManifold>& manifolds)
+{
+	const std::vector<p2ShapePair>& shapePairs = m_ShapePairs[static_cast<int>(p2ShapePairType::RECT_RECT)];
+	ResizeBatch(shapePairs.size());
+	for (size_t i = 0; i < shapePairs.size(); i++)
+	{
+		const p2ShapePair& shapePair = shapePairs[i];
+		const p2Vec2 halfExtendsA = static_cast<const p2RectShape*>(shapePair.colliderA->GetShape())->GetSize();
+		const p2Vec2 halfExtendsB = static_cast<const p2RectShape*>(shapePair.colliderB->GetShape())->GetSize();
+		m_Lanes[0][i] = shapePair.positionA.x;
+		m_Lanes[1][i] = shapePair.positionA.y;
+		m_Lanes[2][i] = halfExtendsA.x;
+		m_Lanes[3][i] = halfExtendsA.y;
+		m_Lanes[4][i] = shapePair.positionB.x;
+		m_Lanes[5][i] = shapePair.positionB.y;
+		m_Lanes[6][i] = halfExtendsB.x;
+		m_Lanes[7][i] = halfExtendsB.y;
+	}
+	float* lanes[LANE_NMB];
+	for (int i = 0; i < LANE_NMB; i++)
+	{
+		lanes[i] = m_Lanes[i].data();
+	}
+	RectSeparations(lanes, m_Separations.data(), shapePairs.size());
+
+	for (size_t i = 0; i < shapePairs.size(); i++)
+	{
+		if (m_Separations[i] > 0.0f)
+			continue;
+		const p2ShapePair& shapePair = shapePairs[i];
+		p2Manifold manifold;
+		if (p2CollideRects(GetRect(shapePair.colliderA, shapePair.positionA), GetRect(shapePair.colliderB, shapePair.positionB), manifold))
+		{
+			manifolds.push_back({ shapePair.colliderA, shapePair.colliderB, manifold });
+		}
+	}
+}
+
+void p2NarrowPhase::CollideCirclePolygons(std::vector<p2ColliderManifold>& manifolds)
+{
+	for (const p2ShapePair& shapePair : m_ShapePairs[static_cast<int>(p2ShapePairType::CIRCLE_POLYGON)])
+	{
+		const float radius = static_cast<const p2CircleShape*>(shapePair.colliderA->GetShape())->GetRadius();
+		const p2PolygonShape& polygon = *static_cast<const p2PolygonShape*>(shapePair.colliderB->GetShape());
+		p2Manifold manifold;
+		if (p2CollideCirclePolygon(shapePair.positionA, radius, polygon, shapePair.positionB, manifold))
+		{
+			manifolds.push_back({ shapePair.colliderA, shapePair.colliderB, manifold });
+		}
+	}
+}
+
+void p2NarrowPhase::CollidePolygons(p2ShapePairType shapePairType, std::vector<p2ColliderManifold>& manifolds)
+{
+	p2PolygonShape box;
+	for (const p2ShapePair& shapePair : m_ShapePairs[static_cast<int>(shapePairType)])
+	{
+		// Rects are tested as a box polygon
+		const p2PolygonShape* polygonA = static_cast<const p2PolygonShape*>(shapePair.colliderA->GetShape());
+		if (shapePairType == p2ShapePairType::RECT_POLYGON)
+		{
+			box.SetAsBox(static_cast<const p2RectShape*>(shapePair.colliderA->GetShape())->GetSize());
+			polygonA = &box;
+		}
+		const p2PolygonShape& polygonB = *static_cast<const p2PolygonShape*>(shapePair.colliderB->GetShape());
+
+		// Pairs separated during the last step are most of the time still separated by the same axis
+		const std::pair<const p2Collider*, const p2Collider*> key(shapePair.colliderA, shapePair.colliderB);
+		auto cachedAxis = m_SeparatingAxes.find(key);
+		if (cachedAxis != m_SeparatingAxes.end() &&
+			p2GetPolygonSeparation(*polygonA, shapePair.positionA, polygonB, shapePair.positionB, cachedAxis->second) > 0.0f)
+		{
+			cachedAxis->second.stamp = m_Stamp;
+			m_CachedAxisRejectNmb++;
+			continue;
+		}
+
+		p2Manifold manifold;
+		p2SeparatingAxis separatingAxis;
+		if (p2CollidePolygons(*polygonA, shapePair.positionA, polygonB, shapePair.positionB, manifold, &separatingAxis))
+		{
+			if (cachedAxis != m_SeparatingAxes.end())
+				m_SeparatingAxes.erase(cachedAxis);
+			manifolds.push_back({ shapePair.colliderA, shapePair.colliderB, manifold });
+		}
+		else
+		{
+			separatingAxis.stamp = m_Stamp;
+			m_SeparatingAxes[key] = separatingAxis;
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include "..\include\p2quadtree.h"
+#include <cmath>
 
 p2QuadTree::p2QuadTree()
 {
@@ -14,6 +15,7 @@ p2QuadTree::p2QuadTree(int nodeLevel, p2AABB bounds)
 
 p2QuadTree::~p2QuadTree()
 {
+	Clear();
 }
 
 void p2QuadTree::Clear()
@@ -31,6 +33,7 @@ void p2QuadTree::Clear()
 			m_Nodes[i]->Clear();
 
 			// Delete the child quadtree
+			delete m_Nodes[i];
 			m_Nodes[i] = nullptr;
 		}
 	}
@@ -156,13 +159,13 @@ void p2QuadTree::Insert(p2Body * obj)
 	}
 }
 
-std::vector<p2Body*> p2QuadTree::Retrieve(std::vector<p2Body*> returnedBodies, p2Body* body)
+void p2QuadTree::Retrieve(std::vector<p2Body*>& returnedBodies, p2Body* body)
 {
 	// Get the index of the child quadtree where the body is located
 	int bodyIndex = GetIndex(body);
 
 	// Check if the body fit perfectly in one of the child quadtree and if there is child quadtree
-	if(bodyIndex != 0 && m_Nodes[0] != nullptr)
+	if(bodyIndex != -1 && m_Nodes[0] != nullptr)
 	{
 		// Get the bodies from this child
 		m_Nodes[bodyIndex]->Retrieve(returnedBodies, body);
@@ -170,6 +173,4 @@ std::vector<p2Body*> p2QuadTree::Retrieve(std::vector<p2Body*> returnedBodies, p
 
 	// Add the bodies of this quadtree
 	returnedBodies.insert(returnedBodies.end(), m_Objects.begin(), m_Objects.end());
-
-	return returnedBodies;
 }
@@ -23,6 +23,8 @@ SOFTWARE.
 */
 
 #include <p2shape.h>
+#include <algorithm>
+#include <cmath>
 
 p2CircleShape::p2CircleShape(float radius) : p2Shape()
 {
@@ -30,6 +32,11 @@ p2CircleShape::p2CircleShape(float radius) : p2Shape()
 	m_Radius = radius;
 }
 
+float p2CircleShape::GetRadius() const
+{
+	return m_Radius;
+}
+
 void p2CircleShape::SetRadius(float radius)
 {
 	m_Radius = radius;
@@ -45,3 +52,140 @@ void p2RectShape::SetSize(p2Vec2 size)
 {
 	m_Size = size;
 }
+
+p2Vec2 p2RectShape::GetSize() const
+{
+	return m_Size;
+}
+
+p2PolygonShape::p2PolygonShape()
+{
+	m_Type = ShapeType::POLYGON;
+}
+
+namespace
+{
+// Twice the signed area of the triangle, positive when c is on the left of ab
+float Orientation(const p2Vec2& a, const p2Vec2& b, const p2Vec2& c)
+{
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+}
+
+bool p2PolygonShape::SetVertices(const p2Vec2* vertices, int vertexNmb)
+{
+	m_VertexNmb = 0;
+	if (vertices == nullptr)
+		return false;
+	vertexNmb = std::min(vertexNmb, MAX_POLYGON_VERTICES);
+
+	// Merge the vertices too close to the previous one
+	p2Vec2 points[MAX_POLYGON_VERTICES];
+	int pointNmb = 0;
+	for (int i = 0; i < vertexNmb; i++)
+	{
+		if (pointNmb > 0 && (vertices[i] - points[pointNmb - 1]).GetMagnitude() <= POLYGON_LINEAR_SLOP)
+			continue;
+		points[pointNmb++] = vertices[i];
+	}
+	while (pointNmb > 1 && (points[pointNmb - 1] - points[0]).GetMagnitude() <= POLYGON_LINEAR_SLOP)
+		pointNmb--;
+
+	// Drop the vertices on the line of their neighbours, their edges would have no proper normal
+	bool removed = true;
+	while (removed && pointNmb >= 3)
+	{
+		removed = false;
+		for (int i = 0; i < pointNmb; i++)
+		{
+			const p2Vec2& previous = points[(i + pointNmb - 1) % pointNmb];
+			const p2Vec2& next = points[(i + 1) % pointNmb];
+			const float length = (next - previous).GetMagnitude();
+			if (std::abs(Orientation(previous, next, points[i])) > POLYGON_LINEAR_SLOP * length)
+				continue;
+
+			for (int j = i; j < pointNmb - 1; j++)
+			{
+				points[j] = points[j + 1];
+			}
+			pointNmb--;
+			removed = true;
+			break;
+		}
+	}
+	if (pointNmb < 3)
+		return false;
+
+	// Twice the signed area, negative for clockwise vertices
+	float area = 0.0f;
+	for (int i = 0; i < pointNmb; i++)
+	{
+		const p2Vec2& v1 = points[i];
+		const p2Vec2& v2 = points[(i + 1) % pointNmb];
+		area += v1.x * v2.y - v1.y * v2.x;
+	}
+	for (int i = 0; i < pointNmb; i++)
+	{
+		m_Vertices[i] = area < 0.0f ? points[pointNmb - 1 - i] : points[i];
+	}
+
+	// Convex when every vertex is on the inner side of every edge, which also rejects the self-intersecting ones
+	for (int i = 0; i < pointNmb; i++)
+	{
+		const p2Vec2& v1 = m_Vertices[i];
+		const p2Vec2& v2 = m_Vertices[(i + 1) % pointNmb];
+		for (int j = 0; j < pointNmb; j++)
+		{
+			if (j == i || j == (i + 1) % pointNmb)
+				continue;
+			if (Orientation(v1, v2, m_Vertices[j]) <= 0.0f)
+				return false;
+		}
+	}
+
+	m_VertexNmb = pointNmb;
+	for (int i = 0; i < m_VertexNmb; i++)
+	{
+		const p2Vec2 edge = m_Vertices[(i + 1) % m_VertexNmb] - m_Vertices[i];
+		m_Normals[i] = p2Vec2(edge.y, -edge.x).Normalized();
+	}
+	return true;
+}
+
+void p2PolygonShape::SetAsBox(p2Vec2 halfExtends)
+{
+	const p2Vec2 vertices[] =
+	{
+		p2Vec2(-halfExtends.x, -halfExtends.y),
+		p2Vec2(halfExtends.x, -halfExtends.y),
+		p2Vec2(halfExtends.x, halfExtends.y),
+		p2Vec2(-halfExtends.x, halfExtends.y)
+	};
+	SetVertices(vertices, 4);
+}
+
+int p2PolygonShape::GetVertexNmb() const
+{
+	return m_VertexNmb;
+}
+
+const p2Vec2& p2PolygonShape::GetVertex(int index) const
+{
+	return m_Vertices[index];
+}
+
+const p2Vec2& p2PolygonShape::GetNormal(int index) const
+{
+	return m_Normals[index];
+}
+
+p2Vec2 p2PolygonShape::GetHalfExtends() const
+{
+	p2Vec2 halfExtends(0.0f, 0.0f);
+	for (int i = 0; i < m_VertexNmb; i++)
+	{
+		halfExtends.x = std::max(halfExtends.x, std::abs(m_Vertices[i].x));
+		halfExtends.y = std::max(halfExtends.y, std::abs(m_Vertices[i].y));
+	}
+	return halfExtends;
+}
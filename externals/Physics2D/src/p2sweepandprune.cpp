@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <p2sweepandprune.h>
+#include <algorithm>
+#include <limits>
+
+void p2SweepAndPruneBroadPhase::FindPairs(std::vector<p2Body>& bodies, int bodyNmb,
+	const std::vector<p2Vec2>& displacements, std::vector<p2BodyPair>& pairs)
+{
+	(void)displacements;
+	m_BeganPairs.clear();
+	m_EndedPairs.clear();
+	m_ChangedPairs.clear();
+	m_SwapNmb = 0;
+
+	if (m_BodyBoxes.size() < bodies.size())
+		m_BodyBoxes.resize(bodies.size(), -1);
+
+	for (int i = 0; i < bodyNmb; i++)
+	{
+		if (bodies[i].GetColliderNmb() == 0)
+			continue;
+
+		int box = m_BodyBoxes[i];
+		if (box == -1)
+		{
+			// New boxes start after all the others, the sort moves them to their place and finds their pairs
+			box = static_cast<int>(m_Boxes.size());
+			m_BodyBoxes[i] = box;
+			p2SweepBox sweepBox;
+			sweepBox.body = &bodies[i];
+			m_Boxes.push_back(sweepBox);
+			for (int axis = 0; axis < 2; axis++)
+			{
+				p2SweepEndpoint endpoint;
+				endpoint.value = std::numeric_limits<float>::max();
+				endpoint.data = static_cast<std::uint32_t>(box) << 1;
+				m_Endpoints[axis].push_back(endpoint);
+				endpoint.data |= 1u;
+				m_Endpoints[axis].push_back(endpoint);
+			}
+		}
+		m_Boxes[box].aabb = bodies[i].GetAABB();
+	}
+
+	SortAxis(0);
+	SortAxis(1);
+
+	// Only the net changes of the step are reported
+	for (auto& changedPair : m_ChangedPairs)
+	{
+		const bool isOverlapping = m_PairIndices.find(changedPair.first) != m_PairIndices.end();
+		if (isOverlapping == changedPair.second)
+			continue;
+
+		p2BodyPair pair;
+		pair.bodyA = m_Boxes[static_cast<int>(changedPair.first >> 32)].body;
+		pair.bodyB = m_Boxes[static_cast<int>(changedPair.first & 0xFFFFFFFFu)].body;
+		if (isOverlapping)
+			m_BeganPairs.push_back(pair);
+		else
+			m_EndedPairs.push_back(pair);
+	}
+
+	for (size_t i = 0; i < m_Pairs.size(); i++)
+	{
+		p2BodyPair pair;
+		pair.bodyA = m_Boxes[static_cast<int>(m_Pairs[i] >> 32)].body;
+		pair.bodyB = m_Boxes[static_cast<int>(m_Pairs[i] & 0xFFFFFFFFu)].body;
+		pairs.push_back(pair);
+	}
+}
+
+size_t p2SweepAndPruneBroadPhase::GetMemoryFootprint() const
+{
+	// The hash maps are counted by their buckets and one node per element
+	const size_t nodeSize = sizeof(std::uint64_t) + sizeof(size_t) + sizeof(void*);
+	return m_Boxes.capacity() * sizeof(p2SweepBox) + m_BodyBoxes.capacity() * sizeof(int) +
+		(m_Endpoints[0].capacity() + m_Endpoints[1].capacity()) * sizeof(p2SweepEndpoint) +
+		m_Pairs.capacity() * sizeof(std::uint64_t) +
+		m_PairIndices.bucket_count() * sizeof(void*) + m_PairIndices.size() * nodeSize +
+		m_ChangedPairs.bucket_count() * sizeof(void*) + m_ChangedPairs.size() * nodeSize +
+		(m_BeganPairs.capacity() + m_EndedPairs.capacity()) * sizeof(p2BodyPair);
+}
+
+size_t p2SweepAndPruneBroadPhase::GetSwapNmb() const
+{
+	return m_SwapNmb;
+}
+
+std::uint64_t p2SweepAndPruneBroadPhase::GetPairKey(int boxA, int boxB)
+{
+	if (boxA > boxB)
+		std::swap(boxA, boxB);
+	return (static_cast<std::uint64_t>(boxA) << 32) | static_cast<std::uint64_t>(boxB);
+}
+
+void p2SweepAndPruneBroadPhase::SortAxis(int axis)
+{
+	std::vector<p2SweepEndpoint>& endpoints = m_Endpoints[axis];
+
+	// Update the values from the AABB of this step
+	for (size_t i = 0; i < endpoints.size(); i++)
+	{
+		const p2AABB& aabb = m_Boxes[endpoints[i].GetBox()].aabb;
+		const p2Vec2& corner = endpoints[i].IsMax() ? aabb.m_TopRight : aabb.m_BottomLeft;
+		endpoints[i].value = axis == 0 ? corner.x : corner.y;
+	}
+
+	// Insertion sort, each swap of a min and a max is an overlap starting or stopping on this axis
+	for (size_t i = 1; i < endpoints.size(); i++)
+	{
+		const p2SweepEndpoint endpoint = endpoints[i];
+		size_t j = i;
+		while (j > 0 && endpoints[j - 1].value > endpoint.value)
+		{
+			const p2SweepEndpoint& previous = endpoints[j - 1];
+			if (!endpoint.IsMax() && previous.IsMax())
+			{
+				// A min passing a max to the left, the boxes overlap on this axis
+				if (m_Boxes[endpoint.GetBox()].aabb.Overlaps(m_Boxes[previous.GetBox()].aabb))
+					AddPair(endpoint.GetBox(), previous.GetBox());
+			}
+			else if (endpoint.IsMax() && !previous.IsMax())
+			{
+				// A max passing a min to the left, the boxes separate on this axis
+				RemovePair(endpoint.GetBox(), previous.GetBox());
+			}
+			endpoints[j] = previous;
+			j--;
+			m_SwapNmb++;
+		}
+		endpoints[j] = endpoint;
+	}
+}
+
+void p2SweepAndPruneBroadPhase::AddPair(int boxA, int boxB)
+{
+	const std::uint64_t key = GetPairKey(boxA, boxB);
+	if (m_PairIndices.find(key) != m_PairIndices.end())
+		return;
+
+	MarkChanged(key, false);
+	m_PairIndices[key] = m_Pairs.size();
+	m_Pairs.push_back(key);
+}
+
+void p2SweepAndPruneBroadPhase::RemovePair(int boxA, int boxB)
+{
+	const std::uint64_t key = GetPairKey(boxA, boxB);
+	const auto pairIndex = m_PairIndices.find(key);
+	if (pairIndex == m_PairIndices.end())
+		return;
+
+	MarkChanged(key, true);
+
+	// Swap with the last pair to keep the array packed
+	const size_t index = pairIndex->second;
+	m_PairIndices.erase(pairIndex);
+	if (index != m_Pairs.size() - 1)
+	{
+		m_Pairs[index] = m_Pairs.back();
+		m_PairIndices[m_Pairs[index]] = index;
+	}
+	m_Pairs.pop_back();
+}
+
+void p2SweepAndPruneBroadPhase::MarkChanged(std::uint64_t key, bool wasOverlapping)
+{
+	// Keeps the first state when the pair changes several times in the same step
+	m_ChangedPairs.insert(std::make_pair(key, wasOverlapping));
+}
@@ -22,18 +22,52 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <p2world.h>
-#include <iostream>
+#include <p2grid.h>
+#include <p2sweepandprune.h>
 
 
-p2World::p2World(p2Vec2 gravity, p2Vec2 screenResolution)
+namespace
 {
-	m_Gravity = gravity;
-	m_ScreenResolution = screenResolution;
+p2WorldDef MakeWorldDef(p2Vec2 gravity, p2Vec2 screenResolution)
+{
+	p2WorldDef worldDef;
+	worldDef.gravity = gravity;
+	worldDef.screenResolution = screenResolution;
+	return worldDef;
+}
+
+std::unique_ptr<p2BroadPhase> CreateBroadPhase(const p2WorldDef& worldDef)
+{
+	switch (worldDef.broadPhaseType)
+	{
+	case p2BroadPhaseType::QUADTREE:
+		return std::unique_ptr<p2BroadPhase>(new p2QuadTreeBroadPhase(
+			p2AABB({ 0.0f, worldDef.screenResolution.y }, { worldDef.screenResolution.x, 0.0f })));
+	case p2BroadPhaseType::GRID:
+		return std::unique_ptr<p2BroadPhase>(new p2GridBroadPhase(worldDef.gridCellSize, worldDef.gridThreadNmb));
+	case p2BroadPhaseType::SWEEP_AND_PRUNE:
+		return std::unique_ptr<p2BroadPhase>(new p2SweepAndPruneBroadPhase());
+	case p2BroadPhaseType::AABB_TREE:
+	default:
+		return std::unique_ptr<p2BroadPhase>(new p2AABBTreeBroadPhase(worldDef.aabbMargin));
+	}
+}
+}
 
-	m_ParentQuad = p2QuadTree(0, p2AABB({ 0.0f, screenResolution.y }, { screenResolution.x, 0.0f }));
-	m_ContactManager = p2ContactManager();
+p2World::p2World(p2Vec2 gravity, p2Vec2 screenResolution) :
+	p2World(MakeWorldDef(gravity, screenResolution))
+{
+}
+
+p2World::p2World(const p2WorldDef& worldDef) :
+	m_BroadPhase(CreateBroadPhase(worldDef))
+{
+	m_Gravity = worldDef.gravity;
+	m_ScreenResolution = worldDef.screenResolution;
+	m_BroadPhaseType = worldDef.broadPhaseType;
 
 	m_Bodies.resize(MAX_BODY_LEN);
+	m_Displacements.resize(MAX_BODY_LEN, p2Vec2(0.0f, 0.0f));
 }
 
 void p2World::Step(float dt)
@@ -41,9 +75,7 @@ void p2World::Step(float dt)
 	// TODO: Review the forces calculation and application
 	for (int i = 0; i < m_BodyIndex; i++)
 	{
-		// Add the current body to the quadtree
-		m_ParentQuad.Insert(&m_Bodies[i]);
-
+		m_Displacements[i] = p2Vec2(0.0f, 0.0f);
 		if (m_Bodies[i].GetType() == p2BodyType::STATIC)
 			continue;
 		//*************************************** Calculate forces ***************************************//
@@ -55,129 +87,35 @@ void p2World::Step(float dt)
 
 		// Apply movement
 		// TODO: Actually apply an acceleration with the gravity
-		p2Vec2 newPos = m_Bodies[i].GetPosition() + (m_Bodies[i].GetLinearVelocity() + m_Gravity) * dt;
+		m_Displacements[i] = (m_Bodies[i].GetLinearVelocity() + m_Gravity) * dt;
+		p2Vec2 newPos = m_Bodies[i].GetPosition() + m_Displacements[i];
 		m_Bodies[i].SetPosition(newPos);
 	}
 
-	// Vector containing all bodies that could collide with the current body
-	std::vector<p2Body*> returnedBodies;
+	// Get the pairs of bodies that could collide
+	m_BodyPairs.clear();
+	m_ContactManager.BeginStep();
+	m_BroadPhase->FindPairs(m_Bodies, m_BodyIndex, m_Displacements, m_BodyPairs);
 
-	// Check for collision
-	for(int i = 0; i < m_BodyIndex; i++)
+	// Compute the manifolds of the touching colliders
+	m_Manifolds.clear();
+	m_NarrowPhase.Collide(m_BodyPairs, m_Manifolds);
+	for (const p2ColliderManifold& colliderManifold : m_Manifolds)
 	{
-		returnedBodies.clear();
-
-		// Get the collider of the current body
-		p2Collider* currentCollider = m_Bodies[i].GetCollider();
-
-		// Define the shape of the current body
-		ShapeType* currentType = &currentCollider->GetShape()->m_Type;
-
-		// Get the center of the current AABB
-		const p2Vec2 currentAABBCenter = m_Bodies[i].GetPosition();		
-
-		// Get the bottom left and top right point of the current AABB
-		const p2Vec2 currentAABBTopRight = m_Bodies[i].GetMaxPosition();
-		const p2Vec2 currentAABBBottomLeft = m_Bodies[i].GetMinPosition();		
-
-		// Get the extends of the current body's AABB
-		const p2Vec2 currentAABBExtends = m_Bodies[i].GetAABBExtends();
-
-		// Define the top left and bottom right point of the current AABB
-		const p2Vec2 currentAABBBottomRight = { currentAABBTopRight.x, currentAABBTopRight.y - currentAABBExtends.y };
-		const p2Vec2 currentAABBTopLeft = { currentAABBBottomLeft.x, currentAABBBottomLeft.y + currentAABBExtends.y };
-
-		// Define the radius of the circle surrounding the current AABB
-		const float currentAABBRadius = (currentAABBTopRight - currentAABBCenter).GetMagnitude();
-
-		// Get the bodies that could collide with the current body
-		returnedBodies = m_ParentQuad.Retrieve(returnedBodies, &m_Bodies[i]);
-		std::cout << "Retrieved bodies : " << returnedBodies.size() << "\n";
-		// Go through the retrieved bodies and check for collision
-		for(int j = 0; j < returnedBodies.size(); j++)
-		{
-			// Get the collider of the checked body
-			p2Collider* checkedCollider = returnedBodies[i]->GetCollider();
-
-			// Define the shape of the checked body
-			ShapeType* checkedType = &checkedCollider->GetShape()->m_Type;
-
-			// Get the position and top right point of the checked body
-			const p2Vec2 checkedAABBCenter = returnedBodies[j]->GetPosition();
-			const p2Vec2 checkedAABBTopRight = returnedBodies[j]->GetMaxPosition();
-
-			// Define the radius of the circle surrounding the checked AABB
-			const float checkedAABBRadius = (checkedAABBTopRight - checkedAABBCenter).GetMagnitude();
-
-			// Define the distance between the current to the checked AABB
-			const float distanceBetweenAABB = (checkedAABBCenter - currentAABBCenter).GetMagnitude();
-
-			// Check if the sum of the two radius is greater than the distance between the two bodies
-			if (distanceBetweenAABB <= currentAABBRadius + checkedAABBRadius)
-			{	
-				bool collisionResult = true;
-
-				//TODO: SAT
-				// Define the type of shape colliding
-				if(*currentType == ShapeType::CIRCLE && *checkedType == ShapeType::CIRCLE)
-				{
-					// Circle v Circle collision
-
-					// Point of collision : 
-				}
-				else if((*currentType == ShapeType::CIRCLE || *checkedType == ShapeType::CIRCLE) && 
-						(*currentType == ShapeType::RECT || *checkedType == ShapeType::RECT))
-				{
-					// Circle v Rect collision
-				}
-				else if(*currentType == ShapeType::RECT && *checkedType == ShapeType::RECT)
-				{
-					// Rect v Rect collision
-				}
-				
-				// Get the bottom left point of the checked body
-				/*const p2Vec2 currentAABBBottomLeft = m_Bodies[i].GetMinPosition();
-
-				// Get the extends of the checked body's AABB
-				const p2Vec2 currentAABBExtends = m_Bodies[i].GetAABBExtends();
-
-				// Define the top left and bottom right point of the checked AABB
-				const p2Vec2 currentAABBBottomRight = { currentAABBTopRight.x, currentAABBTopRight.y - currentAABBExtends.y };
-				const p2Vec2 currentAABBTopLeft = { currentAABBBottomLeft.x, currentAABBBottomLeft.y + currentAABBExtends.y };*/
-
-				// SAT success
-				if(collisionResult)
-				{
-					// Create the contact
-					p2Contact* contact = m_ContactManager.CreateContact(currentCollider, checkedCollider);
-
-					// Apply the contact if the contact is a new one
-					if (contact != nullptr)
-					{
-						m_ContactListener->BeginContact(contact);
-
-						// TODO: Apply the collision forces
-					}					
-
-					// Move to the next body
-					continue;
-				}
-			}
-
-			// Try to get a contact between the two actual bodies
-			int contactID = m_ContactManager.GetContactID(currentCollider, checkedCollider);
-
-			// If the bodies where in contact before, end it and destroy it
-			if (contactID != -1)
-			{
-				m_ContactListener->EndContact(m_ContactManager.GetContactByID(contactID));
-				m_ContactManager.DestroyContact(contactID);
-			}
-		}
-	}	
-
-	// Reset the quatree
-	m_ParentQuad.Clear();
+		// Keep the contact alive for this step, it is created if the colliders were not touching
+		p2Contact* contact = m_ContactManager.UpdateContact(colliderManifold.colliderA, colliderManifold.colliderB);
+
+		// The manifold normal goes from the collider A of the contact
+		p2Manifold manifold = colliderManifold.manifold;
+		if (contact->GetColliderA() != colliderManifold.colliderA)
+			manifold.normal = manifold.normal * -1.0f;
+		contact->SetManifold(manifold);
+
+		// TODO: Apply the collision forces
+	}
+
+	// Begin the new contacts, end the ones that were not touched during this step
+	m_ContactManager.EndStep(m_ContactListener);
 }
 
 p2Body * p2World::CreateBody(p2BodyDef* bodyDef)
@@ -192,3 +130,41 @@ void p2World::SetContactListener(p2ContactListener * contactListener)
 {
 	m_ContactListener = contactListener;
 }
+
+p2BroadPhaseType p2World::GetBroadPhaseType() const
+{
+	return m_BroadPhaseType;
+}
+
+void p2World::SetBroadPhase(std::unique_ptr<p2BroadPhase> broadPhase)
+{
+	m_BroadPhase = std::move(broadPhase);
+}
+
+p2BroadPhase* p2World::GetBroadPhase() const
+{
+	return m_BroadPhase.get();
+}
+
+const std::vector<p2BodyPair>& p2World::GetBodyPairs() const
+{
+	return m_BodyPairs;
+}
+
+const std::vector<p2ColliderManifold>& p2World::GetManifolds() const
+{
+	return m_Manifolds;
+}
+
+const p2NarrowPhase& p2World::GetNarrowPhase() const
+{
+	return m_NarrowPhase;
+}
+
+size_t p2World::GetMemoryFootprint() const
+{
+	return m_Bodies.capacity() * sizeof(p2Body) + m_Displacements.capacity() * sizeof(p2Vec2) +
+		m_BodyPairs.capacity() * sizeof(p2BodyPair) + m_BroadPhase->GetMemoryFootprint() +
+		m_NarrowPhase.GetMemoryFootprint() + m_Manifolds.capacity() * sizeof(p2ColliderManifold) +
+		m_ContactManager.GetMemoryFootprint();
+}
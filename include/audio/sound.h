@@ -71,7 +71,7 @@ protected:
 	Entity m_Entity = INVALID_ENTITY;
 };
 
-class SoundBufferManager : public System
+class SoundBufferManager : public System, public IMemoryReporter
 {
 public:
 
@@ -89,6 +89,10 @@ public:
 
 	SoundBufferId LoadSoundBuffer(std::string filename);
 	sf::SoundBuffer* GetSoundBuffer(SoundBufferId soundBufferId);
+	/**
+	 * \brief Samples of the loaded sound buffers
+	 */
+	void ReportMemory(MemoryTracker& memoryTracker) const override;
 private:
 
   	bool HasValidExtension(std::string filename);
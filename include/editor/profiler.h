@@ -25,19 +25,36 @@ SOFTWARE.
 #ifndef SFGE_PROFILER_H
 #define SFGE_PROFILER_H
 
+#include <cstddef>
+
 #include <SFML/System/Time.hpp>
 
 namespace sfge
 {
 class Engine;
+class MemoryManager;
 struct ProfilerFrameData
 {
     sf::Time frameTotalTime;
     sf::Time frameFixedUpdate;
     sf::Time graphicsTime;
+    size_t frameAllocationNmb = 0;
 };
 namespace editor
 {
+/**
+ * \brief Memory tab of the stats window, per tag accounting, footprints of the managers and the component memory state
+ */
+class MemoryEditorWindow
+{
+public:
+    MemoryEditorWindow(Engine& engine);
+    void Draw();
+private:
+  MemoryManager& m_MemoryManager;
+  int m_SelectedTag = 0;
+};
+
 class ProfilerEditorWindow
 {
 public:
@@ -45,6 +62,7 @@ public:
     void Update ();
 private:
   ProfilerFrameData& m_ProfilerFrameData;
+  MemoryEditorWindow m_MemoryWindow;
 };
 }
 }
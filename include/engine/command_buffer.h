@@ -0,0 +1,113 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_COMMAND_BUFFER_H
+#define SFGE_COMMAND_BUFFER_H
+
+#include <vector>
+
+#include <engine/globals.h>
+#include <engine/component_mask.h>
+#include <utility/json_utility.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Entity created by a command buffer, only valid inside the buffer that created it
+ */
+struct PendingEntity
+{
+	size_t index;
+};
+
+enum class EntityCommandType
+{
+	CREATE_ENTITY,
+	DESTROY_ENTITY,
+	ADD_COMPONENT,
+	REMOVE_COMPONENT
+};
+
+struct EntityCommand
+{
+	EntityCommandType type;
+	Entity entity = INVALID_ENTITY;
+	/**
+	 * \brief Index of the PendingEntity when entity is INVALID_ENTITY
+	 */
+	size_t pendingIndex = 0;
+	ComponentTypeId componentTypeId = INVALID_COMPONENT_TYPE_ID;
+	json componentJson;
+};
+
+/**
+ * \brief Records structural changes (create, destroy, add and remove component) to apply them later on the main thread.
+ * Each thread records in its own buffer, the EntityManager applies them in thread order at the end of the update.
+ * The scheduled systems and the chunks of a parallel Instantiate record in their own buffer instead, appended
+ * in their serial order so the result does not depend on which worker ran them.
+ * Components are added through the same factories as the scene loading, with the same json content.
+ */
+class EntityCommandBuffer
+{
+public:
+	PendingEntity CreateEntity();
+	void DestroyEntity(Entity entity);
+	void AddComponent(Entity entity, ComponentTypeId componentTypeId, const json& componentJson = json::object());
+	void AddComponent(PendingEntity entity, ComponentTypeId componentTypeId, const json& componentJson = json::object());
+	void RemoveComponent(Entity entity, ComponentTypeId componentTypeId);
+	/**
+	 * \brief Move the commands of other after the ones of this buffer and clear it,
+	 * its pending entities are numbered after the ones of this buffer
+	 */
+	void Append(EntityCommandBuffer& other);
+
+	std::vector<EntityCommand>& GetCommands();
+	size_t GetPendingEntityNmb() const;
+	bool IsEmpty() const;
+	size_t GetCapacity() const;
+	/**
+	 * \brief Keeps the capacity, recording is allocation free once warmed up except for the json content
+	 */
+	void Clear();
+private:
+	std::vector<EntityCommand> m_Commands;
+	size_t m_PendingEntityNmb = 0;
+};
+
+/**
+ * \brief Index of the command buffer of the current thread, 0 for the main thread.
+ * The SystemScheduler sets it on the thread pool workers before running a system
+ */
+size_t GetCommandBufferIndex();
+void SetCommandBufferIndex(size_t index);
+/**
+ * \brief Buffer the current thread records in instead of the one of its index, nullptr when unset.
+ * Set by the SystemScheduler for each system and by Instantiate for each chunk
+ */
+EntityCommandBuffer* GetRecordingCommandBuffer();
+void SetRecordingCommandBuffer(EntityCommandBuffer* commandBuffer);
+
+}
+#endif
@@ -29,18 +29,22 @@ SOFTWARE.
 #include <queue>
 #include <vector>
 #include <any>
+#include <algorithm>
 
 #include <engine/globals.h>
 #include <utility/log.h>
 #include <engine/entity.h>
 #include <engine/system.h>
 #include <engine/engine.h>
+#include <engine/config.h>
 #include <engine/scene.h>
 #include <editor/editor_info.h>
 #include <editor/editor.h>
 
 #include <utility/json_utility.h>
 #include <engine/vector.h>
+#include <engine/paged_vector.h>
+#include <engine/memory_tracker.h>
 
 namespace sfge
 {
@@ -62,23 +66,57 @@ class IComponentFactory
 {
  public:
   virtual void CreateComponent(json& componentJson, Entity entity) = 0;
+  virtual void DestroyComponent(Entity entity) = 0;
+  /**
+   * \brief Called at scene load with the number of components of this type in the scene, before they are created
+   */
+  virtual void ReserveComponents(size_t componentNmb) { (void) componentNmb; }
+  /**
+   * \brief Create the same component on many entities, managers resolve the shared resources of componentJson once
+   */
+  virtual void CreateComponents(json& componentJson, const std::vector<Entity>& entities)
+  {
+    for (const Entity entity : entities)
+    {
+      CreateComponent(componentJson, entity);
+    }
+  }
+  /**
+   * \brief Called by SceneManager::Instantiate once the initializer has run on the new entities
+   */
+  virtual void OnInstantiated(const std::vector<Entity>& entities) { (void) entities; }
 };
 
-template<typename T, ComponentType componentType>
+/**
+ * \brief Default storage of the components, its pages come from the engine MemoryManager
+ */
+template<typename T>
+using ComponentStorage = PagedVector<T, COMPONENT_PAGE_SIZE, EngineAllocationPolicy>;
+
+/**
+ * \brief TStorage is the container of the components, ComponentStorage<T> by default. Its allocation policy
+ * gets the component allocator with SetAllocator at engine init.
+ * A storage can return proxies as reference and pointer types, as the struct-of-arrays Transform2dStorage does
+ */
+template<typename T, ComponentType componentType, typename TStorage = ComponentStorage<T>>
 class ComponentManager:
     public System,
     public DestroyObserver,
-    public IComponentFactory
+    public IComponentFactory,
+    public IMemoryReporter
 {
  protected:
   EntityManager* m_EntityManager = nullptr;
-  std::vector<T> m_Components;
+  TStorage m_Components;
  public:
+  using ComponentPtr = typename TStorage::pointer;
+  using ComponentRef = typename TStorage::reference;
+
   ComponentManager(Engine& engine) : System(engine) {}
   ComponentManager(const ComponentManager&) = delete;
   ComponentManager(ComponentManager&& componentManager) = default;
 
-  virtual T* AddComponent(Entity entity) = 0;
+  virtual ComponentPtr AddComponent(Entity entity) = 0;
   virtual void DestroyComponent(Entity entity) = 0;
 
   void OnEngineInit() override
@@ -86,6 +124,8 @@ class ComponentManager:
 	  System::OnEngineInit();
     m_EntityManager = m_Engine.GetEntityManager();
     m_EntityManager->AddDestroyObserver(this);
+    m_Components.SetAllocator(m_Engine.GetMemoryManager()->GetComponentAllocator());
+    m_Engine.GetMemoryManager()->AddMemoryReporter(this);
   }
   virtual ~ComponentManager()
   {
@@ -93,15 +133,30 @@ class ComponentManager:
   }
 
 
-  virtual T* GetComponentPtr(Entity entity) = 0;
+  virtual ComponentPtr GetComponentPtr(Entity entity) = 0;
 
-  std::vector<T>& GetComponents()
+  TStorage& GetComponents()
   {
     return m_Components;
   }
 
   virtual void OnDestroy(Entity entity) override { (void) entity; }
 
+  /**
+   * \brief Footprint of the component storage, named after the component type
+   */
+  void ReportMemory(MemoryTracker& memoryTracker) const override
+  {
+    memoryTracker.ReportFootprint(MemoryTag::COMPONENTS, GetMemoryReportName(), GetContainerFootprint(m_Components));
+  }
+
+ protected:
+  std::string GetMemoryReportName() const
+  {
+    if (m_EntityManager == nullptr)
+      return "Components";
+    return m_EntityManager->GetComponentTypeRegistry().GetTypeName(GetComponentTypeId(componentType));
+  }
 };
 
 
@@ -114,20 +169,27 @@ class ComponentInfoManager : public editor::IDrawableManager
   {
 
   }
-
+  /**
+   * \brief Editor metadata is cold data only stored when the editor is enabled, GetComponentInfo allocates it on first use otherwise
+   */
+  bool HasComponentInfos() const
+  {
+    return m_HasComponentInfos;
+  }
 
 protected:
-  std::vector<TInfo> m_ComponentsInfo;
+  ComponentStorage<TInfo> m_ComponentsInfo;
   ComponentType m_ComponentType;
+  bool m_HasComponentInfos = false;
 };
 
 
-template<typename T, typename TInfo, ComponentType componentType>
-class BasicComponentManager: public ComponentManager<T, componentType>,
+template<typename T, typename TInfo, ComponentType componentType, typename TStorage = ComponentStorage<T>>
+class BasicComponentManager: public ComponentManager<T, componentType, TStorage>,
                              public ComponentInfoManager<TInfo>
 {
 public:
-    BasicComponentManager(Engine& engine) : ComponentManager<T, componentType>(engine), ComponentInfoManager<TInfo>(componentType)
+    BasicComponentManager(Engine& engine) : ComponentManager<T, componentType, TStorage>(engine), ComponentInfoManager<TInfo>(componentType)
     {
 
     }
@@ -135,7 +197,8 @@ public:
     {
       for (auto &info : ComponentInfoManager<TInfo>::m_ComponentsInfo)
       {
-        if (ComponentManager<T, componentType>::m_EntityManager->HasComponent(entity, componentType) && info.GetEntity() == entity)
+        if (ComponentManager<T, componentType, TStorage>::m_EntityManager->HasComponent(entity, componentType) &&
+            GetEntityIndex(info.GetEntity()) == GetEntityIndex(entity))
         {
           info.DrawOnInspector();
         }
@@ -143,36 +206,56 @@ public:
     }
     virtual void OnEngineInit() override
     {
-		ComponentManager<T, componentType>::OnEngineInit();
-		ComponentManager<T, componentType>::m_Engine.GetEditor()->AddDrawableObserver(this);
-		ComponentManager<T, componentType>::m_Engine.GetSceneManager()->AddComponentManager(this, componentType);
+		ComponentManager<T, componentType, TStorage>::OnEngineInit();
+		ComponentInfoManager<TInfo>::m_ComponentsInfo.SetAllocator(
+			ComponentManager<T, componentType, TStorage>::m_Engine.GetMemoryManager()->GetComponentAllocator());
+		const auto* config = ComponentManager<T, componentType, TStorage>::m_Engine.GetConfig();
+		if (config != nullptr && config->editor && !ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			AllocateComponentInfos();
+		}
+		ComponentManager<T, componentType, TStorage>::m_Engine.GetEditor()->AddDrawableObserver(this);
+		ComponentManager<T, componentType, TStorage>::m_Engine.GetSceneManager()->AddComponentManager(this, componentType);
+	}
+
+	void ReportMemory(MemoryTracker& memoryTracker) const override
+	{
+		ComponentManager<T, componentType, TStorage>::ReportMemory(memoryTracker);
+		if (ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			memoryTracker.ReportFootprint(MemoryTag::EDITOR,
+				ComponentManager<T, componentType, TStorage>::GetMemoryReportName() + " infos",
+				GetContainerFootprint(ComponentInfoManager<TInfo>::m_ComponentsInfo));
+		}
 	}
 
 protected:
 	virtual int GetFreeComponentIndex() = 0;
+	/**
+	 * \brief Create the infos of the existing components, from then on they are kept in sync with the components
+	 */
+	virtual void AllocateComponentInfos()
+	{
+		ComponentInfoManager<TInfo>::m_HasComponentInfos = true;
+	}
 };
 
-template<class T, class TInfo, ComponentType componentType>
+template<class T, class TInfo, ComponentType componentType, class TStorage = ComponentStorage<T>>
 class SingleComponentManager :
-		public BasicComponentManager<T, TInfo, componentType>,
+		public BasicComponentManager<T, TInfo, componentType, TStorage>,
 		public ResizeObserver
 {
 public:
-	SingleComponentManager(Engine& engine):BasicComponentManager<T,TInfo, componentType>(engine)
+	SingleComponentManager(Engine& engine):BasicComponentManager<T,TInfo, componentType, TStorage>(engine)
 	{
-		BasicComponentManager<T,TInfo, componentType>::m_Components = std::vector<T>{ INIT_ENTITY_NMB };
-        BasicComponentManager<T,TInfo, componentType>::m_ComponentsInfo = std::vector<TInfo>{ INIT_ENTITY_NMB };
-        for(int i = 0; i < INIT_ENTITY_NMB;i++)
-        {
-          BasicComponentManager<T,TInfo, componentType>::m_ComponentsInfo[i].SetEntity(i+1);
-        }
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.resize(INIT_ENTITY_NMB);
 	}
 
 	virtual void OnEngineInit() override
 	{
-		BasicComponentManager<T,TInfo, componentType>::OnEngineInit();
-		BasicComponentManager<T,TInfo, componentType>::m_EntityManager = System::m_Engine.GetEntityManager();
-		BasicComponentManager<T,TInfo, componentType>::m_EntityManager->AddResizeObserver(this);
+		BasicComponentManager<T,TInfo, componentType, TStorage>::OnEngineInit();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_EntityManager = System::m_Engine.GetEntityManager();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_EntityManager->AddResizeObserver(this);
 	}
 	virtual ~SingleComponentManager()
 	{
@@ -184,64 +267,338 @@ public:
 		{
 			Log::GetInstance()->Error("Trying to get component from INVALID_ENTITY");
 		}
-		return BasicComponentManager<T,TInfo, componentType>::m_ComponentsInfo[entity - 1];
+		if (!ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			AllocateComponentInfos();
+		}
+		return BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo[GetEntityIndex(entity) - 1];
 	}
 
-	virtual T* GetComponentPtr(Entity entity) override
+	virtual typename TStorage::pointer GetComponentPtr(Entity entity) override
 	{
 		if (entity == INVALID_ENTITY)
 		{
 			Log::GetInstance()->Error("Trying to get component from INVALID_ENTITY");
 		}
-		return &BasicComponentManager<T,TInfo, componentType>::m_Components[entity - 1];
+		return BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.GetPtr(GetEntityIndex(entity) - 1);
 	}
 
-	T& GetComponentRef(Entity entity)
+	typename TStorage::reference GetComponentRef(Entity entity)
 	{
 		if (entity == INVALID_ENTITY)
 		{
 			Log::GetInstance()->Error("Trying to get component from INVALID_ENTITY");
 		}
-		return BasicComponentManager<T,TInfo, componentType>::m_Components[entity - 1];
+		return BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components[GetEntityIndex(entity) - 1];
 	}
 
+	/**
+	 * \brief Only allocates new pages, pointers to the existing components stay valid
+	 */
 	void OnResize(size_t newSize) override
 	{
-		BasicComponentManager<T,TInfo, componentType>::m_Components.resize(newSize);
-		BasicComponentManager<T,TInfo, componentType>::m_ComponentsInfo.resize(newSize);
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.resize(newSize);
+		if (ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			ResizeComponentInfos(newSize);
+		}
 	}
 protected:
 
 	virtual int GetFreeComponentIndex() override { return 0; };
 
+	void AllocateComponentInfos() override
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::AllocateComponentInfos();
+		ResizeComponentInfos(BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.size());
+	}
+
+	void ResizeComponentInfos(size_t newSize)
+	{
+		auto& componentsInfo = BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo;
+		const size_t oldSize = componentsInfo.size();
+		componentsInfo.resize(newSize);
+		for(size_t i = oldSize; i < newSize; i++)
+		{
+			componentsInfo[i].SetEntity(i+1);
+		}
+	}
+
+};
+
+const int INVALID_COMPONENT_INDEX = -1;
+
+/**
+ * \brief Component manager storing its components in a sparse set, to be used by components only attached to few entities.
+ * m_Components and m_ComponentsInfo are packed arrays of the live components, m_DenseEntities holds their entity
+ * and m_SparseIndexes maps an entity to its packed index. Iterating over the packed arrays only touches live components.
+ */
+template<class T, class TInfo, ComponentType componentType, class TStorage = ComponentStorage<T>>
+class SparseComponentManager :
+		public BasicComponentManager<T, TInfo, componentType, TStorage>,
+		public ResizeObserver
+{
+public:
+	SparseComponentManager(Engine& engine):BasicComponentManager<T,TInfo, componentType, TStorage>(engine)
+	{
+		m_SparseIndexes = std::vector<int>(INIT_ENTITY_NMB, INVALID_COMPONENT_INDEX);
+		m_DenseEntities.reserve(INIT_ENTITY_NMB);
+	}
+
+	virtual void OnEngineInit() override
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::OnEngineInit();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_EntityManager->AddResizeObserver(this);
+	}
+
+	bool HasComponent(Entity entity) const
+	{
+		return GetEntityIndex(entity) != INVALID_ENTITY &&
+			GetEntityIndex(entity) <= m_SparseIndexes.size() &&
+			m_SparseIndexes[GetEntityIndex(entity) - 1] != INVALID_COMPONENT_INDEX;
+	}
+
+	virtual T* GetComponentPtr(Entity entity) override
+	{
+		if (entity == INVALID_ENTITY)
+		{
+			Log::GetInstance()->Error("Trying to get component from INVALID_ENTITY");
+			return nullptr;
+		}
+		if(!HasComponent(entity))
+		{
+			return nullptr;
+		}
+		return &BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components[m_SparseIndexes[GetEntityIndex(entity) - 1]];
+	}
+
+	T& GetComponentRef(Entity entity)
+	{
+		if (!HasComponent(entity))
+		{
+			Log::GetInstance()->Error("Trying to get a component not attached to the entity");
+		}
+		return BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components[m_SparseIndexes[GetEntityIndex(entity) - 1]];
+	}
+
+	TInfo& GetComponentInfo(Entity entity)
+	{
+		if (!HasComponent(entity))
+		{
+			Log::GetInstance()->Error("Trying to get a component info not attached to the entity");
+		}
+		if (!ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			AllocateComponentInfos();
+		}
+		return BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo[m_SparseIndexes[GetEntityIndex(entity) - 1]];
+	}
+	/**
+	 * \brief Entities owning the packed components, m_DenseEntities[i] owns m_Components[i]
+	 */
+	const std::vector<Entity>& GetDenseEntities() const
+	{
+		return m_DenseEntities;
+	}
+
+	size_t GetComponentsNmb() const
+	{
+		return m_DenseEntities.size();
+	}
+
+	void OnResize(size_t newSize) override
+	{
+		m_SparseIndexes.resize(newSize, INVALID_COMPONENT_INDEX);
+	}
+
+	/**
+	 * \brief Allocate the pages of the packed arrays up front so the scene load does not allocate per component
+	 */
+	void ReserveComponents(size_t componentNmb) override
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.reserve(componentNmb);
+		if (ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo.reserve(componentNmb);
+		}
+		m_DenseEntities.reserve(componentNmb);
+	}
+
+	void OnDestroy(Entity entity) override
+	{
+		RemoveComponent(entity);
+	}
+	/**
+	 * \brief Compact the packed arrays once for the whole batch, the remaining components keep their order
+	 */
+	void OnDestroyEntities(const std::vector<Entity>& entities) override
+	{
+		auto& components = BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components;
+		auto& componentsInfo = BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo;
+		const bool hasComponentInfos = ComponentInfoManager<TInfo>::m_HasComponentInfos;
+		size_t removedNmb = 0;
+		for (const Entity entity : entities)
+		{
+			if (HasComponent(entity))
+			{
+				m_SparseIndexes[GetEntityIndex(entity) - 1] = INVALID_COMPONENT_INDEX;
+				removedNmb++;
+			}
+		}
+		if (removedNmb == 0)
+			return;
+		size_t packedIndex = 0;
+		for (size_t i = 0; i < m_DenseEntities.size(); i++)
+		{
+			const Entity entity = m_DenseEntities[i];
+			if (m_SparseIndexes[GetEntityIndex(entity) - 1] == INVALID_COMPONENT_INDEX)
+				continue;
+			if (packedIndex != i)
+			{
+				components[packedIndex] = std::move(components[i]);
+				if (hasComponentInfos)
+					componentsInfo[packedIndex] = std::move(componentsInfo[i]);
+				m_DenseEntities[packedIndex] = entity;
+			}
+			m_SparseIndexes[GetEntityIndex(entity) - 1] = static_cast<int>(packedIndex);
+			packedIndex++;
+		}
+		for (size_t i = 0; i < removedNmb; i++)
+		{
+			components.pop_back();
+			if (hasComponentInfos)
+				componentsInfo.pop_back();
+		}
+		m_DenseEntities.resize(packedIndex);
+	}
+
+	void ReportMemory(MemoryTracker& memoryTracker) const override
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::ReportMemory(memoryTracker);
+		memoryTracker.ReportFootprint(MemoryTag::COMPONENTS,
+			BasicComponentManager<T,TInfo, componentType, TStorage>::GetMemoryReportName() + " indexes",
+			GetContainerFootprint(m_DenseEntities) + GetContainerFootprint(m_SparseIndexes));
+	}
+protected:
+	/**
+	 * \brief Append a new component at the end of the packed arrays, or return the existing one
+	 */
+	T& EmplaceComponent(Entity entity)
+	{
+		auto& components = BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components;
+		auto& componentsInfo = BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo;
+		if(HasComponent(entity))
+		{
+			return components[m_SparseIndexes[GetEntityIndex(entity) - 1]];
+		}
+		if(GetEntityIndex(entity) > m_SparseIndexes.size())
+		{
+			m_SparseIndexes.resize(GetEntityIndex(entity), INVALID_COMPONENT_INDEX);
+		}
+		m_SparseIndexes[GetEntityIndex(entity) - 1] = static_cast<int>(components.size());
+		m_DenseEntities.push_back(entity);
+		components.emplace_back();
+		if (ComponentInfoManager<TInfo>::m_HasComponentInfos)
+		{
+			componentsInfo.emplace_back();
+			componentsInfo.back().SetEntity(entity);
+		}
+		return components.back();
+	}
+	/**
+	 * \brief Swap the last packed component in the removed slot so the arrays stay packed
+	 */
+	void RemoveComponent(Entity entity)
+	{
+		if(!HasComponent(entity))
+			return;
+		auto& components = BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components;
+		auto& componentsInfo = BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo;
+		const bool hasComponentInfos = ComponentInfoManager<TInfo>::m_HasComponentInfos;
+
+		const int removedIndex = m_SparseIndexes[GetEntityIndex(entity) - 1];
+		const int lastIndex = static_cast<int>(components.size()) - 1;
+		if(removedIndex != lastIndex)
+		{
+			const Entity lastEntity = m_DenseEntities[lastIndex];
+			components[removedIndex] = std::move(components[lastIndex]);
+			if (hasComponentInfos)
+				componentsInfo[removedIndex] = std::move(componentsInfo[lastIndex]);
+			m_DenseEntities[removedIndex] = lastEntity;
+			m_SparseIndexes[GetEntityIndex(lastEntity) - 1] = removedIndex;
+		}
+		components.pop_back();
+		if (hasComponentInfos)
+			componentsInfo.pop_back();
+		m_DenseEntities.pop_back();
+		m_SparseIndexes[GetEntityIndex(entity) - 1] = INVALID_COMPONENT_INDEX;
+	}
+
+	void ClearComponents()
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.clear();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo.clear();
+		m_DenseEntities.clear();
+		std::fill(m_SparseIndexes.begin(), m_SparseIndexes.end(), INVALID_COMPONENT_INDEX);
+	}
+
+	virtual int GetFreeComponentIndex() override
+	{
+		return static_cast<int>(BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.size());
+	}
+
+	void AllocateComponentInfos() override
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::AllocateComponentInfos();
+		auto& componentsInfo = BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo;
+		componentsInfo.resize(m_DenseEntities.size());
+		for (size_t i = 0; i < m_DenseEntities.size(); i++)
+		{
+			componentsInfo[i].SetEntity(m_DenseEntities[i]);
+		}
+	}
+
+	std::vector<Entity> m_DenseEntities;
+	std::vector<int> m_SparseIndexes;
 };
 
-template<class T, class TInfo, ComponentType componentType>
+template<class T, class TInfo, ComponentType componentType, class TStorage = ComponentStorage<T>>
 class MultipleComponentManager : 
-	public BasicComponentManager<T,TInfo, componentType>,
+	public BasicComponentManager<T,TInfo, componentType, TStorage>,
 	public ResizeObserver
 
 {
  public:
-	MultipleComponentManager(Engine& engine): BasicComponentManager<T,TInfo, componentType>(engine)
+	MultipleComponentManager(Engine& engine): BasicComponentManager<T,TInfo, componentType, TStorage>(engine)
 	{
-		BasicComponentManager<T,TInfo, componentType>::m_Components = std::vector<T>{ INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER};
-		BasicComponentManager<T,TInfo, componentType>::m_ComponentsInfo = std::vector<TInfo>{ INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER };
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.resize(INIT_ENTITY_NMB * MULTIPLE_COMPONENTS_MULTIPLIER);
 	}
 
 	void OnEngineInit() override
     {
-        BasicComponentManager<T,TInfo, componentType>::OnEngineInit();
-		BasicComponentManager<T,TInfo, componentType>::m_EntityManager = BasicComponentManager<T,TInfo, componentType>::m_Engine.GetEntityManager();
-		BasicComponentManager<T,TInfo, componentType>::m_EntityManager->AddResizeObserver(this);
+        BasicComponentManager<T,TInfo, componentType, TStorage>::OnEngineInit();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_EntityManager = BasicComponentManager<T,TInfo, componentType, TStorage>::m_Engine.GetEntityManager();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_EntityManager->AddResizeObserver(this);
     }
 
+    /**
+     * \brief Keeps the existing components, only new pages are allocated
+     */
     virtual void OnResize(size_t newSize) override
     {
-      BasicComponentManager<T,TInfo, componentType>::m_Components = std::vector<T>{ newSize * MULTIPLE_COMPONENTS_MULTIPLIER};
-      BasicComponentManager<T,TInfo, componentType>::m_ComponentsInfo = std::vector<TInfo>{ newSize * MULTIPLE_COMPONENTS_MULTIPLIER };
+      BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.resize(newSize * MULTIPLE_COMPONENTS_MULTIPLIER);
+      if (ComponentInfoManager<TInfo>::m_HasComponentInfos)
+      {
+        BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo.resize(newSize * MULTIPLE_COMPONENTS_MULTIPLIER);
+      }
     }
 protected:
+	void AllocateComponentInfos() override
+	{
+		BasicComponentManager<T,TInfo, componentType, TStorage>::AllocateComponentInfos();
+		BasicComponentManager<T,TInfo, componentType, TStorage>::m_ComponentsInfo.resize(
+			BasicComponentManager<T,TInfo, componentType, TStorage>::m_Components.size());
+	}
 
 };
 
@@ -0,0 +1,220 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_COMPONENT_MASK_H
+#define SFGE_COMPONENT_MASK_H
+
+#include <cstdint>
+#include <cstddef>
+
+#include <engine/globals.h>
+
+#if defined(SFGE_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace sfge
+{
+enum class ComponentType : int;
+
+/**
+ * \brief Bit index of a component type in a ComponentMask, the builtin ComponentType flags use the ids of their bit
+ */
+using ComponentTypeId = unsigned;
+const size_t MAX_COMPONENT_TYPES = 128;
+const ComponentTypeId INVALID_COMPONENT_TYPE_ID = ~0U;
+
+/**
+ * \brief Id of a builtin ComponentType flag
+ */
+inline ComponentTypeId GetComponentTypeId(ComponentType componentType)
+{
+	auto flag = static_cast<unsigned>(componentType);
+	if (flag == 0U)
+		return INVALID_COMPONENT_TYPE_ID;
+	ComponentTypeId id = 0U;
+	while ((flag & 1U) == 0U)
+	{
+		flag >>= 1U;
+		id++;
+	}
+	return id;
+}
+
+/**
+ * \brief Fixed-width bitset of component types, matching is done 128 bits at a time with SSE2 when available
+ */
+class alignas(16) ComponentMask
+{
+public:
+	static constexpr size_t WORD_NMB = MAX_COMPONENT_TYPES / 64;
+
+	ComponentMask() = default;
+	explicit ComponentMask(ComponentType componentType)
+	{
+		Set(GetComponentTypeId(componentType));
+	}
+	static ComponentMask FromId(ComponentTypeId id)
+	{
+		ComponentMask mask;
+		mask.Set(id);
+		return mask;
+	}
+	static ComponentMask All()
+	{
+		ComponentMask mask;
+		for (auto& word : mask.m_Words)
+		{
+			word = ~std::uint64_t(0);
+		}
+		return mask;
+	}
+
+	void Set(ComponentTypeId id)
+	{
+		if (id < MAX_COMPONENT_TYPES)
+			m_Words[id / 64] |= std::uint64_t(1) << (id % 64);
+	}
+	void Reset(ComponentTypeId id)
+	{
+		if (id < MAX_COMPONENT_TYPES)
+			m_Words[id / 64] &= ~(std::uint64_t(1) << (id % 64));
+	}
+	bool Test(ComponentTypeId id) const
+	{
+		return id < MAX_COMPONENT_TYPES && (m_Words[id / 64] >> (id % 64) & 1U) != 0;
+	}
+	/**
+	 * \brief All the types of this mask are in entityMask, the EntityView query
+	 */
+	bool IsSubsetOf(const ComponentMask& entityMask) const
+	{
+#if defined(SFGE_SSE2)
+		for (size_t i = 0; i < WORD_NMB; i += 2)
+		{
+			const __m128i query = _mm_load_si128(reinterpret_cast<const __m128i*>(m_Words + i));
+			const __m128i entity = _mm_load_si128(reinterpret_cast<const __m128i*>(entityMask.m_Words + i));
+			const __m128i matched = _mm_cmpeq_epi32(_mm_and_si128(query, entity), query);
+			if (_mm_movemask_epi8(matched) != 0xFFFF)
+				return false;
+		}
+		return true;
+#else
+		for (size_t i = 0; i < WORD_NMB; i++)
+		{
+			if ((m_Words[i] & entityMask.m_Words[i]) != m_Words[i])
+				return false;
+		}
+		return true;
+#endif
+	}
+	/**
+	 * \brief At least one type in common, used to find conflicting systems
+	 */
+	bool Intersects(const ComponentMask& other) const
+	{
+#if defined(SFGE_SSE2)
+		for (size_t i = 0; i < WORD_NMB; i += 2)
+		{
+			const __m128i lhs = _mm_load_si128(reinterpret_cast<const __m128i*>(m_Words + i));
+			const __m128i rhs = _mm_load_si128(reinterpret_cast<const __m128i*>(other.m_Words + i));
+			const __m128i common = _mm_cmpeq_epi32(_mm_and_si128(lhs, rhs), _mm_setzero_si128());
+			if (_mm_movemask_epi8(common) != 0xFFFF)
+				return true;
+		}
+		return false;
+#else
+		for (size_t i = 0; i < WORD_NMB; i++)
+		{
+			if ((m_Words[i] & other.m_Words[i]) != 0)
+				return true;
+		}
+		return false;
+#endif
+	}
+	bool Any() const
+	{
+		return Intersects(All());
+	}
+	bool None() const
+	{
+		return !Any();
+	}
+
+	ComponentMask& operator|=(const ComponentMask& rhs)
+	{
+		for (size_t i = 0; i < WORD_NMB; i++)
+		{
+			m_Words[i] |= rhs.m_Words[i];
+		}
+		return *this;
+	}
+	ComponentMask& operator&=(const ComponentMask& rhs)
+	{
+		for (size_t i = 0; i < WORD_NMB; i++)
+		{
+			m_Words[i] &= rhs.m_Words[i];
+		}
+		return *this;
+	}
+	ComponentMask operator|(const ComponentMask& rhs) const
+	{
+		ComponentMask mask = *this;
+		return mask |= rhs;
+	}
+	ComponentMask operator&(const ComponentMask& rhs) const
+	{
+		ComponentMask mask = *this;
+		return mask &= rhs;
+	}
+	ComponentMask operator~() const
+	{
+		ComponentMask mask;
+		for (size_t i = 0; i < WORD_NMB; i++)
+		{
+			mask.m_Words[i] = ~m_Words[i];
+		}
+		return mask;
+	}
+	bool operator==(const ComponentMask& rhs) const
+	{
+		for (size_t i = 0; i < WORD_NMB; i++)
+		{
+			if (m_Words[i] != rhs.m_Words[i])
+				return false;
+		}
+		return true;
+	}
+	bool operator!=(const ComponentMask& rhs) const
+	{
+		return !(*this == rhs);
+	}
+private:
+	std::uint64_t m_Words[WORD_NMB] = {};
+};
+
+static_assert(MAX_COMPONENT_TYPES % 128 == 0, "ComponentMask is matched 128 bits at a time");
+
+}
+#endif
@@ -0,0 +1,61 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_COMPONENT_REGISTRY_H
+#define SFGE_COMPONENT_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <engine/component_mask.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Assigns the ComponentTypeId of the component types at runtime, by name.
+ * The builtin ComponentType flags are registered first so their id stays the index of their bit,
+ * Python and extension components get the next free ids up to MAX_COMPONENT_TYPES.
+ */
+class ComponentTypeRegistry
+{
+public:
+	ComponentTypeRegistry();
+	/**
+	 * \brief Id of the type, registering it if needed. Returns INVALID_COMPONENT_TYPE_ID when the mask is full
+	 */
+	ComponentTypeId RegisterType(const std::string& typeName);
+	ComponentTypeId GetTypeId(const std::string& typeName) const;
+	const std::string& GetTypeName(ComponentTypeId typeId) const;
+	size_t GetTypeNmb() const;
+private:
+	void RegisterBuiltinType(const std::string& typeName, ComponentType componentType);
+
+	std::vector<std::string> m_TypeNames;
+	std::unordered_map<std::string, ComponentTypeId> m_TypeIds;
+};
+
+}
+#endif
@@ -36,6 +36,7 @@ SOFTWARE.
 #include <engine/globals.h>
 #include "SFML/Graphics/Color.hpp"
 #include "p2vector.h"
+#include "p2world.h"
 
 namespace sfge
 {
@@ -57,6 +58,10 @@ struct Configuration
 	sf::Vector2i screenResolution = sf::Vector2i(1280, 720);
 
 	p2Vec2 gravity = p2Vec2(0.0f, 9.81f);
+	/**
+	 * \brief Broad phase used by the p2World to find the bodies that might collide
+	 */
+	p2BroadPhaseType broadPhaseType = p2BroadPhaseType::AABB_TREE;
 	/**
 	 * \brief The limited framerate
 	 */
@@ -65,10 +70,16 @@ struct Configuration
 	int velocityIterations = 8;
 	int positionIterations = 2;
 	size_t currentEntitiesNmb = INIT_ENTITY_NMB;
+	size_t componentMemorySize = DEFAULT_COMPONENT_MEMORY_SIZE;
+	size_t frameArenaSize = DEFAULT_FRAME_ARENA_SIZE;
 
 	std::string windowName = "SFGE 1.1";
 	std::string scriptsDirname = "scripts/";
 	std::string dataDirname = "data/";
+	/**
+	 * \brief When set, the memory report is written there as json when the Engine is destroyed
+	 */
+	std::string memoryReportFilename;
 
 	sf::Color bgColor = sf::Color::Black;
 	/**
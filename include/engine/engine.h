@@ -35,6 +35,8 @@ SOFTWARE.
 #include <utility/json_utility.h>
 
 #include <editor/profiler.h>
+#include <engine/scheduler.h>
+#include <engine/memory_manager.h>
 #include <Remotery.h>
 
 #include <SFML/System/Clock.hpp>
@@ -60,6 +62,7 @@ class EntityManager;
 class Transform2dManager;
 class Editor;
 struct SystemsContainer;
+class WorldSnapshot;
 
 /**
 * \brief The main Engine class to centralize the frame process and the references
@@ -88,6 +91,14 @@ public:
 	* \brief Reload is used after loading a new scene
 	*/
 	void Collect();
+	/**
+	 * \brief Copy the entities and the trivially copyable component state into snapshot, replacing its content
+	 */
+	void SaveSnapshot(WorldSnapshot& snapshot);
+	/**
+	 * \brief Bring the world back to a snapshot taken in the same scene, much faster than reloading the scene
+	 */
+	bool RestoreSnapshot(const WorldSnapshot& snapshot);
 
 	~Engine();
 	/**
@@ -105,6 +116,7 @@ public:
 	EntityManager* GetEntityManager();
 	Transform2dManager* GetTransform2dManager();
 	Editor* GetEditor();
+	MemoryManager* GetMemoryManager();
 
 	ctpl::thread_pool& GetThreadPool();
 	ProfilerFrameData& GetProfilerFrameData();
@@ -114,12 +126,17 @@ public:
 protected:
 	void InitModules();
 	ctpl::thread_pool m_ThreadPool;
+	/**
+	 * \brief Runs the update of the systems, concurrently when their declared component access allows it
+	 */
+	SystemScheduler m_UpdateScheduler;
 	sf::RenderWindow* m_Window = nullptr;
 	std::unique_ptr<Configuration> m_Config;
 	float m_DeltaTime = 0.0f;
 	sf::Clock m_EngineClock;
 	Remotery* rmt;
-	//
+	//Declared before the systems so it is destroyed after them
+	MemoryManager m_MemoryManager;
 	std::unique_ptr<SystemsContainer> m_SystemsContainer;
 
   	ProfilerFrameData m_FrameData;
@@ -27,10 +27,17 @@ SOFTWARE.
 
 #include <vector>
 #include <set>
+#include <memory>
+#include <unordered_map>
 
 #include <engine/system.h>
+#include <engine/component_registry.h>
+#include <engine/command_buffer.h>
+#include <engine/snapshot.h>
+#include <engine/memory_tracker.h>
 #include <editor/editor_info.h>
 #include <engine/globals.h>
+#include <utility/string_interner.h>
 
 namespace sfge
 {
@@ -46,12 +53,53 @@ class DestroyObserver
 {
  public:
   virtual void OnDestroy(Entity entity) = 0;
+  /**
+   * \brief Batched OnDestroy, the entities are unique and sorted by index. Calls OnDestroy for each one by default
+   */
+  virtual void OnDestroyEntities(const std::vector<Entity>& entities)
+  {
+    for (const Entity entity : entities)
+    {
+      OnDestroy(entity);
+    }
+  }
 };
 /**
  * \brief Entity index number, starting from 1U
  */
 
-using EntityMask = int;
+/**
+ * \brief Cached query over the entities owning all the components of a mask.
+ * Maintained incrementally by the EntityManager, iterating it only touches the matching entities.
+ * Adding or removing components while iterating can reorder the view.
+ */
+class EntityView
+{
+public:
+	explicit EntityView(EntityMask mask);
+
+	EntityMask GetMask() const;
+	bool Match(EntityMask entityMask) const;
+	/**
+	 * \brief Only the current handle of an entity is contained, not the stale ones of its slot
+	 */
+	bool Contains(Entity entity) const;
+	size_t Size() const;
+	const std::vector<Entity>& GetEntities() const;
+
+	std::vector<Entity>::const_iterator begin() const;
+	std::vector<Entity>::const_iterator end() const;
+private:
+	friend class EntityManager;
+	void Insert(Entity entity);
+	void Remove(Entity entity);
+	void Clear();
+	void Resize(size_t newSize);
+
+	EntityMask m_Mask;
+	std::vector<Entity> m_Entities;
+	std::vector<int> m_Indexes;
+};
 
 namespace editor
 {
@@ -63,7 +111,7 @@ void DrawOnInspector() override;
 
 }
 
-class EntityManager : public System
+class EntityManager : public System, public ISnapshotable, public IMemoryReporter
 {
 public:
 	using System::System;
@@ -72,25 +120,137 @@ public:
 	void OnBeforeSceneLoad() override;
 
 	EntityMask GetMask(Entity entity);
+	/**
+	 * \brief Reserve a free entity in O(1), or the wanted index if it is free. Returns INVALID_ENTITY when none is left
+	 */
 	Entity CreateEntity(Entity wantedEntity);
+	/**
+	 * \brief Reserve count free entities at once, growing the entity slots a single time when there are not enough of them
+	 */
+	std::vector<Entity> CreateEntities(size_t count);
 	void DestroyEntity(Entity entity);
+	/**
+	 * \brief Destroy many entities with one OnDestroyEntities call per observer. Invalid handles and duplicates are skipped
+	 */
+	void DestroyEntities(const std::vector<Entity>& entities);
+	/**
+	 * \brief Check that the entity is alive and that its generation is the current one of its slot
+	 */
+	bool IsEntityValid(Entity entity) const;
+	/**
+	 * \brief Get the current handle of an entity index
+	 */
+	Entity GetEntity(Entity entityIndex) const;
 	bool HasComponent(Entity entity, ComponentType componentType);
+	bool HasComponent(Entity entity, ComponentTypeId componentTypeId);
 	void AddComponentType(Entity entity, ComponentType componentType);
+	/**
+	 * \brief Add a component type registered in the ComponentTypeRegistry
+	 */
+	void AddComponentType(Entity entity, ComponentTypeId componentTypeId);
 	void RemoveComponentType(Entity entity, ComponentType componentType);
+	void RemoveComponentType(Entity entity, ComponentTypeId componentTypeId);
+	ComponentTypeRegistry& GetComponentTypeRegistry();
+	/**
+	 * \brief Command buffer of the calling thread, or of the system or Instantiate chunk it is running.
+	 * The only way to change entities from a system running on the thread pool
+	 */
+	EntityCommandBuffer& GetCommandBuffer();
+	/**
+	 * \brief Sync point on the main thread, applies the command buffers in thread order then clears them
+	 */
+	void ApplyCommandBuffers();
+	/**
+	 * \brief Editor metadata of the entity, the store is only allocated once the editor asks for it
+	 */
 	editor::EntityInfo& GetEntityInfo(Entity entity);
-
-	Entity GetEntityByName(std::string entityName) const;
+	/**
+	 * \brief Name the entity in the name index, an empty name removes it
+	 */
+	void SetEntityName(Entity entity, const std::string& entityName);
+	/**
+	 * \brief Name of the entity, empty when it has none
+	 */
+	const std::string& GetEntityName(Entity entity) const;
+	/**
+	 * \brief Hash lookup of a live entity by name, the lowest one when several entities share it
+	 */
+	Entity GetEntityByName(const std::string& entityName) const;
 	void ResizeEntityNmb(size_t newSize);
 	void AddResizeObserver(ResizeObserver *resizeObserver);
 	void AddDestroyObserver(DestroyObserver *destroyObserver);
 
-	std::vector<Entity> GetEntitiesWithType(ComponentType componentType);
+	/**
+	 * \brief Save the masks, generations, names and alive flags of every entity slot
+	 */
+	void SaveSnapshot(WorldSnapshot& snapshot) override;
+	bool CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const override;
+	/**
+	 * \brief Destroy the entities created since the snapshot, then bring back the saved entities.
+	 * A saved entity gets its handle back unless its slot was used by another entity since, so no handle given out
+	 * after the snapshot becomes valid again. Component types that are not part of the snapshot are cleared from the
+	 * masks of the entities brought back
+	 */
+	bool RestoreSnapshot(WorldSnapshot::Reader& reader) override;
+
+	void ReportMemory(MemoryTracker& memoryTracker) const override;
+
+	/**
+	 * \brief Entities of the cached view of componentType, no copy is made so it changes with the entities
+	 */
+	const std::vector<Entity>& GetEntitiesWithType(ComponentType componentType);
+	/**
+	 * \brief Get the cached view of the entities owning all the components of the mask, created on first call
+	 */
+	EntityView& GetView(EntityMask mask);
+	template<ComponentType... componentTypes>
+	EntityView& GetView()
+	{
+		return GetView((static_cast<EntityMask>(componentTypes) | ...));
+	}
 
 private:
+	void UpdateViews(Entity entity, EntityMask oldMask, EntityMask newMask);
+	/**
+	 * \brief Free the slot of a valid entity once the observers are notified
+	 */
+	void ReleaseEntity(Entity entity);
+	void ReserveEntity(Entity entityIndex);
+	void ResetFreeEntities();
+	void RemoveEntityName(Entity entityIndex);
+	void RebuildNameIndex();
+
 	std::vector<EntityMask> m_MaskArray{ INIT_ENTITY_NMB };
-	std::vector<editor::EntityInfo> m_EntityInfos{ INIT_ENTITY_NMB };
+	std::vector<unsigned> m_Generations = std::vector<unsigned>(INIT_ENTITY_NMB, 0U);
+	std::vector<bool> m_AliveEntities = std::vector<bool>(INIT_ENTITY_NMB, false);
+	/**
+	 * \brief Stack of free entity indexes, the lowest on top. Slots reserved with a wanted entity are skipped lazily
+	 */
+	std::vector<Entity> m_FreeEntities;
+	std::vector<bool> m_InFreeEntities = std::vector<bool>(INIT_ENTITY_NMB, false);
+	std::vector<std::unique_ptr<EntityView>> m_Views;
 	std::set<ResizeObserver*> m_ResizeObservers;
-	std::set<DestroyObserver*> m_DestroyObservers;
+	std::vector<DestroyObserver*> m_DestroyObservers;
+	ComponentTypeRegistry m_ComponentTypeRegistry;
+	std::vector<EntityCommandBuffer> m_CommandBuffers = std::vector<EntityCommandBuffer>(1);
+	std::vector<Entity> m_PendingEntities;
+	std::vector<Entity> m_DestroyedEntities;
+	//Cold data, never touched by the per-frame code
+	StringInterner m_EntityNameInterner;
+	std::vector<StringId> m_EntityNames = std::vector<StringId>(INIT_ENTITY_NMB, INVALID_STRING_ID);
+	/**
+	 * \brief Lowest entity index and number of live entities of every used name
+	 */
+	std::unordered_map<StringId, std::pair<Entity, size_t>> m_NamedEntities;
+	/**
+	 * \brief Editor metadata, empty until GetEntityInfo is called
+	 */
+	std::vector<editor::EntityInfo> m_EntityInfos;
+	//Scratch copies used while saving and restoring snapshots
+	std::vector<std::uint8_t> m_SnapshotAliveEntities;
+	std::vector<unsigned> m_SnapshotGenerations;
+	std::vector<EntityMask> m_SnapshotMasks;
+	std::vector<StringId> m_SnapshotNames;
 };
 /*
 template <>
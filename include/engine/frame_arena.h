@@ -0,0 +1,144 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_FRAME_ARENA_H
+#define SFGE_FRAME_ARENA_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+
+#include <engine/memory.h>
+#include <engine/memory_tracker.h>
+#include <engine/virtual_arena.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Double-buffered linear memory for the temporaries of a frame, owned by one thread.
+ * Memory allocated during a frame stays valid until the end of the next frame, deallocation does nothing.
+ * Each buffer is a VirtualArena, a frame can use more than the buffer size up to the reservation.
+ * Also a std::pmr::memory_resource so std::pmr containers can use it directly
+ */
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+	/**
+	 * \brief Each buffer reserves reserveSize bytes and keeps bufferSize bytes committed between frames.
+	 * Allocations that do not fit in the reservation fall back to the heap until the buffer is cleared
+	 */
+	explicit FrameArena(size_t bufferSize, size_t reserveSize = FRAME_ARENA_RESERVE_SIZE);
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+	~FrameArena() override;
+
+	/**
+	 * \brief Record the allocations in the tracker under FRAME, a buffer is recorded as deallocated when it is cleared
+	 */
+	void SetMemoryTracker(MemoryTracker* memoryTracker);
+
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+	/**
+	 * \brief Start a new frame, the buffer of the frame before the previous one is cleared and reused
+	 */
+	void Swap();
+
+	size_t GetBufferSize() const;
+	/**
+	 * \brief Bytes used by the current frame, without the heap fallbacks
+	 */
+	size_t GetUsedMemory() const;
+	/**
+	 * \brief Committed bytes of both buffers
+	 */
+	size_t GetCommittedMemory() const;
+	/**
+	 * \brief Allocations of the current frame that did not fit and went to the heap
+	 */
+	size_t GetOverflowNmb() const;
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+private:
+	void RecordAllocation(size_t size);
+	void ClearBuffer(size_t bufferIndex);
+
+	struct Overflow
+	{
+		void* p;
+		size_t alignment;
+	};
+	size_t m_BufferSize;
+	VirtualArena m_FirstBuffer;
+	VirtualArena m_SecondBuffer;
+	std::array<VirtualArena*, 2> m_Buffers;
+	std::array<std::vector<Overflow>, 2> m_Overflows;
+	size_t m_CurrentBuffer = 0;
+	MemoryTracker* m_MemoryTracker = nullptr;
+	std::array<size_t, 2> m_RecordedBytes{};
+	std::array<size_t, 2> m_RecordedAllocationNmb{};
+};
+
+/**
+ * \brief STL allocator taking its memory from a FrameArena, for the containers that cannot use std::pmr.
+ * The containers must not outlive the next frame
+ */
+template<class T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	explicit FrameAllocator(FrameArena& frameArena) noexcept : m_FrameArena(&frameArena) {}
+	template<class U>
+	FrameAllocator(const FrameAllocator<U>& other) noexcept : m_FrameArena(other.GetFrameArena()) {}
+
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(m_FrameArena->Allocate(n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T*, size_t) noexcept {}
+
+	FrameArena* GetFrameArena() const noexcept { return m_FrameArena; }
+private:
+	FrameArena* m_FrameArena;
+};
+
+template<class T, class U>
+bool operator==(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs) noexcept
+{
+	return lhs.GetFrameArena() == rhs.GetFrameArena();
+}
+
+template<class T, class U>
+bool operator!=(const FrameAllocator<T>& lhs, const FrameAllocator<U>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+}
+#endif
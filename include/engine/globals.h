@@ -27,8 +27,11 @@
 #ifndef SFGE_GLOBALS_H
 #define SFGE_GLOBALS_H
 
+#include <cstddef>
+#include <cstdint>
 
-#if ((ULONG_MAX) == (UINT_MAX))
+
+#if UINTPTR_MAX == 0xFFFFFFFFFFFFFFFFu
 #define IS64BIT
 #else
 #define IS32BIT
@@ -39,9 +42,61 @@
 
 #define SFGE_VERSION 0.2
 
+/**
+ * \brief Instruction sets enabled by the compiler flags, they select the SIMD paths with a scalar fallback
+ */
+#if defined(__AVX__)
+#define SFGE_AVX
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SFGE_SSE2
+#endif
+
 using Entity = unsigned;
 const Entity INVALID_ENTITY = 0U;
+/**
+ * \brief An Entity handle packs its index (starting from 1U) in the low bits and the generation of its slot in the high bits.
+ * The first generation is 0, so a fresh handle is equal to its index.
+ */
+const unsigned ENTITY_INDEX_BITS = 22U;
+const Entity ENTITY_INDEX_MASK = (1U << ENTITY_INDEX_BITS) - 1U;
+const unsigned ENTITY_GENERATION_MASK = (1U << (32U - ENTITY_INDEX_BITS)) - 1U;
+
+inline Entity GetEntityIndex(Entity entity)
+{
+	return entity & ENTITY_INDEX_MASK;
+}
+
+inline unsigned GetEntityGeneration(Entity entity)
+{
+	return (entity >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+inline Entity MakeEntity(Entity index, unsigned generation)
+{
+	return (index & ENTITY_INDEX_MASK) | ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS);
+}
 const size_t  MULTIPLE_COMPONENTS_MULTIPLIER = 4;
+/**
+ * \brief Number of components allocated together by the component managers storage
+ */
+const size_t COMPONENT_PAGE_SIZE = 256;
+/**
+ * \brief Default size in bytes of the memory the component pages are allocated from
+ */
+const size_t DEFAULT_COMPONENT_MEMORY_SIZE = 16 * 1024 * 1024;
+/**
+ * \brief Default size in bytes kept committed in each of the two buffers of a per-thread frame arena
+ */
+const size_t DEFAULT_FRAME_ARENA_SIZE = 1024 * 1024;
+/**
+ * \brief Address space reserved by each buffer of a frame arena, only the pages really used are committed
+ */
+#ifdef IS64BIT
+const size_t FRAME_ARENA_RESERVE_SIZE = 256 * 1024 * 1024;
+#else
+const size_t FRAME_ARENA_RESERVE_SIZE = 16 * 1024 * 1024;
+#endif
 enum class ModuleType
 {
 	ENTITY,
@@ -26,23 +26,23 @@
 #ifndef SFGE_MEMORY_H
 #define SFGE_MEMORY_H
 
+#include <atomic>
 #include <cstdlib>
 #include <cstdint>
 #include <cassert>
+#include <new>
 
 #include <engine/globals.h>
 
-#ifdef IS64BIT
-using ptr_type = long;
-#endif
-
-#ifdef IS32BIT
-using ptr_type = int;
-#endif
+//Integer wide enough to hold an address, on every platform
+using ptr_type = std::intptr_t;
 
 
 namespace sfge
 {
+class MemoryTracker;
+enum class MemoryTag : std::uint8_t;
+
 class Allocator
 {
 
@@ -71,9 +71,9 @@ public:
 
     size_t getSize() const { return _size; }
 
-    size_t getUsedMemory() const { return _used_memory; }
+    virtual size_t getUsedMemory() const { return _used_memory; }
 
-    size_t getNumAllocations() const { return _num_allocations; }
+    virtual size_t getNumAllocations() const { return _num_allocations; }
 
 protected:
 
@@ -118,7 +118,7 @@ namespace allocator
         *(((size_t *) p) - 1) = length;
 
         for (size_t i = 0; i < length; i++)
-            new(&p) T;
+            new(&p[i]) T;
 
         return p;
     }
@@ -247,6 +247,87 @@ private:
     FreeBlock* _free_blocks;
 };
 
+/**
+ * \brief Two-level segregated fit allocator: free blocks are kept in lists indexed by a power of two (first level)
+ * split in linear ranges (second level), with a bitmap per level. Allocate and deallocate are O(1),
+ * neighbouring free blocks are merged on deallocation so fragmentation stays bounded
+ */
+class TlsfAllocator : public Allocator
+{
+public:
+
+    TlsfAllocator(size_t size, void* start);
+    ~TlsfAllocator();
+
+    void* allocate(size_t size, ptr_type alignment) override;
+    void deallocate(void* p) override;
+
+    /**
+     * \brief Bytes available in the free blocks
+     */
+    size_t getFreeMemory() const { return _free_memory; }
+    /**
+     * \brief Size of the biggest allocation that can still succeed with the default alignment
+     */
+    size_t getLargestFreeBlock() const;
+    /**
+     * \brief 1 - largest free block / free memory, 0 when all the free memory is contiguous
+     */
+    float getFragmentation() const;
+
+private:
+
+    TlsfAllocator(const TlsfAllocator&);
+
+    //Prevent copies because it might cause errors
+    TlsfAllocator& operator=(const TlsfAllocator&);
+
+    struct Block
+    {
+        //Previous block in memory, nullptr for the first one
+        Block* prev_physical;
+        //Payload size, the lowest bit is set when the block is free
+        size_t size;
+        //Only used while the block is free, they overlap the payload
+        Block* next_free;
+        Block* prev_free;
+    };
+
+    static constexpr size_t ALIGN_SIZE_LOG2 = 3;
+    static constexpr size_t ALIGN_SIZE = 1 << ALIGN_SIZE_LOG2;
+    static constexpr size_t SL_INDEX_COUNT_LOG2 = 5;
+    static constexpr size_t SL_INDEX_COUNT = 1 << SL_INDEX_COUNT_LOG2;
+    static constexpr size_t FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2;
+    static constexpr size_t FL_INDEX_MAX = 32;
+    static constexpr size_t FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+    static constexpr size_t SMALL_BLOCK_SIZE = 1 << FL_INDEX_SHIFT;
+    static constexpr size_t BLOCK_OVERHEAD = sizeof(Block*) + sizeof(size_t);
+    static constexpr size_t MIN_BLOCK_SIZE = sizeof(Block) - BLOCK_OVERHEAD;
+    static constexpr size_t FREE_BIT = 1;
+
+    static size_t blockSize(const Block* block) { return block->size & ~FREE_BIT; }
+    static bool isFree(const Block* block) { return (block->size & FREE_BIT) != 0; }
+    static void* blockPayload(const Block* block) { return (void*)((ptr_type)block + BLOCK_OVERHEAD); }
+    static Block* payloadBlock(const void* p) { return (Block*)((ptr_type)p - BLOCK_OVERHEAD); }
+    static Block* nextPhysical(const Block* block) { return (Block*)((ptr_type)blockPayload(block) + blockSize(block)); }
+
+    static void mappingInsert(size_t size, size_t& fl, size_t& sl);
+    static void mappingSearch(size_t size, size_t& fl, size_t& sl);
+    Block* searchSuitableBlock(size_t& fl, size_t& sl) const;
+    void insertFreeBlock(Block* block);
+    void removeFreeBlock(Block* block);
+    Block* locateFreeBlock(size_t size);
+    /**
+     * \brief Split the end of block in a new free block when it is big enough, returns the block marked used
+     */
+    void* prepareUsed(Block* block, size_t size);
+
+    Block* _blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+    unsigned _fl_bitmap;
+    unsigned _sl_bitmap[FL_INDEX_COUNT];
+    size_t _free_memory;
+};
+
 class PoolAllocator : public Allocator
 {
 public:
@@ -267,6 +348,45 @@ private:
     void** _free_list;
 };
 
+/**
+ * \brief PoolAllocator that can allocate and deallocate from any thread. The free slots form a Treiber stack
+ * whose head is a slot index tagged with a counter incremented on every change, so a head popped and pushed back
+ * between the read and the CAS of another thread (ABA) makes that CAS fail.
+ * Its counters are atomics, the Allocator accessors are overridden to read them
+ */
+class ConcurrentPoolAllocator : public Allocator
+{
+public:
+
+    ConcurrentPoolAllocator(size_t objectSize, ptr_type objectAlignment, size_t size, void* mem);
+    ~ConcurrentPoolAllocator();
+    void* allocate(size_t size, ptr_type alignment) override;
+    void deallocate(void* p) override;
+
+    size_t getUsedMemory() const override { return getNumAllocations() * _objectSize; }
+    size_t getNumAllocations() const override { return _allocation_nmb.load(std::memory_order_relaxed); }
+    size_t getObjectNmb() const { return _object_nmb; }
+
+private:
+
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator&);
+
+    //Prevent copies because it might cause errors
+    ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&);
+
+    //Free slots hold the 1-based index of the next free slot, 0 ends the list
+    using Link = std::atomic<std::uint32_t>;
+    Link* slotLink(std::uint32_t index) const { return (Link*)((ptr_type)_first_slot + (index - 1) * _objectSize); }
+
+    size_t _objectSize;
+    ptr_type _objectAlignment;
+    void* _first_slot;
+    size_t _object_nmb;
+    //Tag in the high 32 bits, index of the first free slot in the low ones
+    std::atomic<std::uint64_t> _head;
+    std::atomic<size_t> _allocation_nmb;
+};
+
 class ProxyAllocator : public Allocator
 {
 public:
@@ -285,5 +405,100 @@ private:
     Allocator& _allocator;
 };
 
+/**
+ * \brief ProxyAllocator recording its allocations in a MemoryTracker under a tag.
+ * Sizes are measured on the used memory of the wrapped allocator, headers and alignment included
+ */
+class TrackingAllocator : public ProxyAllocator
+{
+public:
+
+    TrackingAllocator(Allocator& allocator, MemoryTracker& memoryTracker, MemoryTag memoryTag);
+    ~TrackingAllocator();
+    void* allocate(size_t size, ptr_type alignment) override;
+    void deallocate(void* p) override;
+
+private:
+
+    TrackingAllocator(const TrackingAllocator&);
+
+    //Prevent copies because it might cause errors
+    TrackingAllocator& operator=(const TrackingAllocator&);
+    MemoryTracker& _memory_tracker;
+    MemoryTag _memory_tag;
+};
+
+/**
+ * \brief Count an allocation done through the engine allocation policies and pools
+ */
+void CountAllocation();
+/**
+ * \brief Allocations counted since the last ResetFrameAllocationNmb, the Engine resets it every frame
+ */
+size_t GetFrameAllocationNmb();
+void ResetFrameAllocationNmb();
+
+/**
+ * \brief Allocation policy of the containers that only use the heap
+ */
+class HeapAllocationPolicy
+{
+public:
+    void SetAllocator(Allocator*) {}
+
+    void* Allocate(size_t size, size_t alignment)
+    {
+        CountAllocation();
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void Deallocate(void* p, size_t alignment)
+    {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+};
+
+/**
+ * \brief Allocation policy taking its memory from an engine-owned Allocator, falls back to the heap
+ * when no allocator is set or when it is full. Not thread safe, like the Allocator it uses
+ */
+class EngineAllocationPolicy
+{
+public:
+    void SetAllocator(Allocator* allocator) { m_Allocator = allocator; }
+    Allocator* GetAllocator() const { return m_Allocator; }
+
+    void* Allocate(size_t size, size_t alignment)
+    {
+        CountAllocation();
+        if (m_Allocator != nullptr)
+        {
+            void* p = m_Allocator->allocate(size, static_cast<ptr_type>(alignment));
+            if (p != nullptr)
+                return p;
+        }
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+
+    void Deallocate(void* p, size_t alignment)
+    {
+        if (m_Allocator != nullptr && Owns(*m_Allocator, p))
+        {
+            m_Allocator->deallocate(p);
+            return;
+        }
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    static bool Owns(const Allocator& allocator, const void* p)
+    {
+        const auto* begin = static_cast<const char*>(allocator.getStart());
+        const auto* ptr = static_cast<const char*>(p);
+        return ptr >= begin && ptr < begin + allocator.getSize();
+    }
+private:
+    Allocator* m_Allocator = nullptr;
+};
+
 }
-#endif
\ No newline at end of file
+#endif
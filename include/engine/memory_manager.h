@@ -0,0 +1,99 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_MEMORY_MANAGER_H
+#define SFGE_MEMORY_MANAGER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <engine/memory.h>
+#include <engine/frame_arena.h>
+#include <engine/memory_tracker.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Engine-owned memory, the component managers allocate their pages from it.
+ * Must outlive the systems since their pages are given back to it when they are destroyed
+ */
+class MemoryManager
+{
+public:
+	MemoryManager() = default;
+	MemoryManager(const MemoryManager&) = delete;
+	MemoryManager& operator=(const MemoryManager&) = delete;
+	~MemoryManager();
+	/**
+	 * \brief Allocate the component memory, ignored while pages from a previous Init are still in use
+	 */
+	void Init(size_t componentMemorySize);
+	/**
+	 * \brief TLSF allocator of the component pages tracked under MemoryTag::COMPONENTS, nullptr before Init
+	 */
+	Allocator* GetComponentAllocator();
+	const TlsfAllocator* GetComponentTlsfAllocator() const;
+	/**
+	 * \brief One FrameArena per thread, 0 for the main thread and threadId + 1 for the workers of the thread pool
+	 */
+	void InitFrameArenas(size_t threadNmb, size_t frameArenaSize);
+	/**
+	 * \brief Frame arena of the calling thread, found with GetCommandBufferIndex like its command buffer
+	 */
+	FrameArena& GetFrameArena();
+	FrameArena& GetFrameArena(size_t threadIndex);
+	size_t GetFrameArenaNmb() const;
+	/**
+	 * \brief Start a new frame in every arena, called by the Engine at the end of the frame when no job is running
+	 */
+	void SwapFrameArenas();
+
+	MemoryTracker& GetMemoryTracker();
+	/**
+	 * \brief Reporters are asked for their footprints by UpdateMemoryReport until the MemoryManager is destroyed
+	 */
+	void AddMemoryReporter(IMemoryReporter* memoryReporter);
+	/**
+	 * \brief Replace the footprints of the tracker with the current ones of the reporters and of the frame arenas
+	 */
+	void UpdateMemoryReport();
+	/**
+	 * \brief Update the report and write it as json, for the runs without editor
+	 */
+	bool WriteMemoryReport(const std::string& filename);
+private:
+	std::unique_ptr<char[]> m_ComponentMemory;
+	MemoryTracker m_MemoryTracker;
+	std::vector<IMemoryReporter*> m_MemoryReporters;
+	std::unique_ptr<TlsfAllocator> m_ComponentAllocator;
+	//Declared after the allocator it wraps so it is destroyed first
+	std::unique_ptr<TrackingAllocator> m_TrackedComponentAllocator;
+	std::vector<std::unique_ptr<FrameArena>> m_FrameArenas;
+};
+
+}
+
+#endif
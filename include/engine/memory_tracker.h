@@ -0,0 +1,157 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_MEMORY_TRACKER_H
+#define SFGE_MEMORY_TRACKER_H
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <utility/json_utility.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Subsystem an allocation or a container footprint is accounted to
+ */
+enum class MemoryTag : std::uint8_t
+{
+	COMPONENTS,
+	ENTITIES,
+	TEXTURES,
+	SOUNDS,
+	PHYSICS,
+	PYTHON,
+	EDITOR,
+	FRAME,
+	OTHER,
+	LENGTH
+};
+
+const char* GetMemoryTagName(MemoryTag memoryTag);
+
+/**
+ * \brief Buckets of the allocation size histogram, bucket i counts the sizes in [2^i, 2^(i+1)), the last one the bigger sizes
+ */
+const size_t MEMORY_HISTOGRAM_SIZE = 32;
+
+struct MemoryTagStats
+{
+	/**
+	 * \brief True when the allocations of the tag are recorded, otherwise only the footprints are known
+	 */
+	bool tracked = false;
+	size_t currentBytes = 0;
+	size_t peakBytes = 0;
+	size_t allocationNmb = 0;
+	size_t deallocationNmb = 0;
+	std::array<size_t, MEMORY_HISTOGRAM_SIZE> histogram{};
+	/**
+	 * \brief Sum of the footprints reported with this tag at the last report
+	 */
+	size_t footprintBytes = 0;
+};
+
+/**
+ * \brief Memory held by the containers of a manager, what it owns whatever allocated it
+ */
+struct MemoryFootprint
+{
+	MemoryTag memoryTag;
+	std::string name;
+	size_t bytes;
+};
+
+class MemoryTracker;
+
+/**
+ * \brief Managers registered to the MemoryManager report the footprint of their containers when a report is made
+ */
+class IMemoryReporter
+{
+public:
+	virtual ~IMemoryReporter() = default;
+	virtual void ReportMemory(MemoryTracker& memoryTracker) const = 0;
+};
+
+/**
+ * \brief Bytes of the memory reserved by a container, its capacity and not its size
+ */
+template<typename TContainer>
+size_t GetContainerFootprint(const TContainer& container)
+{
+	return container.capacity() * sizeof(typename TContainer::value_type);
+}
+
+/**
+ * \brief Per-tag accounting of the allocations made through the TrackingAllocators and of the reported footprints.
+ * Recording is thread safe, the footprints are reported from the main thread
+ */
+class MemoryTracker
+{
+public:
+	MemoryTracker() = default;
+	MemoryTracker(const MemoryTracker&) = delete;
+	MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+	/**
+	 * \brief Mark the allocations of the tag as recorded, done by the allocators recording in the tracker
+	 */
+	void SetTagTracked(MemoryTag memoryTag);
+	bool IsTagTracked(MemoryTag memoryTag) const;
+	void RecordAllocation(MemoryTag memoryTag, size_t size);
+	/**
+	 * \brief Record deallocationNmb deallocations freeing size bytes in total
+	 */
+	void RecordDeallocation(MemoryTag memoryTag, size_t size, size_t deallocationNmb = 1);
+
+	/**
+	 * \brief Forget the footprints of the previous report
+	 */
+	void ClearFootprints();
+	void ReportFootprint(MemoryTag memoryTag, const std::string& name, size_t bytes);
+	const std::vector<MemoryFootprint>& GetFootprints() const;
+
+	MemoryTagStats GetStats(MemoryTag memoryTag) const;
+	json ToJson() const;
+private:
+	struct TagCounters
+	{
+		std::atomic<bool> tracked{false};
+		std::atomic<size_t> currentBytes{0};
+		std::atomic<size_t> peakBytes{0};
+		std::atomic<size_t> allocationNmb{0};
+		std::atomic<size_t> deallocationNmb{0};
+		std::array<std::atomic<size_t>, MEMORY_HISTOGRAM_SIZE> histogram{};
+	};
+	std::array<TagCounters, static_cast<size_t>(MemoryTag::LENGTH)> m_TagCounters;
+	std::vector<MemoryFootprint> m_Footprints;
+};
+
+}
+
+#endif
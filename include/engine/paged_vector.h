@@ -0,0 +1,272 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_PAGED_VECTOR_H
+#define SFGE_PAGED_VECTOR_H
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <type_traits>
+
+#include <engine/globals.h>
+#include <engine/memory.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Vector-like container storing its elements in fixed-size pages.
+ * Growing only allocates new pages, so the addresses of existing elements stay stable,
+ * and elements are contiguous within a page.
+ * Pages come from TAllocationPolicy, see HeapAllocationPolicy and EngineAllocationPolicy.
+ */
+template<typename T, size_t pageSize = COMPONENT_PAGE_SIZE, typename TAllocationPolicy = HeapAllocationPolicy>
+class PagedVector
+{
+	static_assert(pageSize > 0, "Page size must be positive");
+public:
+	template<typename TContainer, typename TValue>
+	class Iterator
+	{
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = TValue*;
+		using reference = TValue&;
+
+		Iterator(TContainer* container, size_t index) : m_Container(container), m_Index(index) {}
+
+		reference operator*() const { return (*m_Container)[m_Index]; }
+		pointer operator->() const { return &(*m_Container)[m_Index]; }
+		reference operator[](difference_type n) const { return (*m_Container)[m_Index + n]; }
+		Iterator& operator++() { m_Index++; return *this; }
+		Iterator operator++(int) { Iterator tmp = *this; m_Index++; return tmp; }
+		Iterator& operator--() { m_Index--; return *this; }
+		Iterator operator--(int) { Iterator tmp = *this; m_Index--; return tmp; }
+		Iterator& operator+=(difference_type n) { m_Index += n; return *this; }
+		Iterator& operator-=(difference_type n) { m_Index -= n; return *this; }
+		Iterator operator+(difference_type n) const { return Iterator(m_Container, m_Index + n); }
+		Iterator operator-(difference_type n) const { return Iterator(m_Container, m_Index - n); }
+		difference_type operator-(const Iterator& other) const
+		{
+			return static_cast<difference_type>(m_Index) - static_cast<difference_type>(other.m_Index);
+		}
+		bool operator==(const Iterator& other) const { return m_Index == other.m_Index; }
+		bool operator!=(const Iterator& other) const { return m_Index != other.m_Index; }
+		bool operator<(const Iterator& other) const { return m_Index < other.m_Index; }
+	private:
+		TContainer* m_Container;
+		size_t m_Index;
+	};
+	using value_type = T;
+	using reference = T&;
+	using pointer = T*;
+	using iterator = Iterator<PagedVector, T>;
+	using const_iterator = Iterator<const PagedVector, const T>;
+
+	PagedVector() = default;
+	explicit PagedVector(size_t size)
+	{
+		resize(size);
+	}
+	PagedVector(const PagedVector&) = delete;
+	PagedVector& operator=(const PagedVector&) = delete;
+	PagedVector(PagedVector&& other) noexcept
+	{
+		Swap(other);
+	}
+	PagedVector& operator=(PagedVector&& other) noexcept
+	{
+		Swap(other);
+		return *this;
+	}
+	~PagedVector()
+	{
+		clear();
+	}
+
+	/**
+	 * \brief Allocator used for the next pages, the current pages are given back to the one they come from
+	 */
+	void SetAllocator(Allocator* allocator)
+	{
+		m_AllocationPolicy.SetAllocator(allocator);
+	}
+	TAllocationPolicy& GetAllocationPolicy() { return m_AllocationPolicy; }
+
+	T& operator[](size_t index)
+	{
+		return m_Pages[index / pageSize][index % pageSize];
+	}
+	const T& operator[](size_t index) const
+	{
+		return m_Pages[index / pageSize][index % pageSize];
+	}
+
+	T* GetPtr(size_t index)
+	{
+		return &(*this)[index];
+	}
+
+	size_t size() const { return m_Size; }
+	bool empty() const { return m_Size == 0; }
+	size_t capacity() const { return m_Pages.size() * pageSize; }
+
+	/**
+	 * \brief Grow by allocating new pages, or shrink by resetting the removed elements when possible. Existing elements are never moved
+	 */
+	void resize(size_t newSize)
+	{
+		reserve(newSize);
+		if constexpr (std::is_move_assignable<T>::value)
+		{
+			for (size_t i = newSize; i < m_Size; i++)
+			{
+				(*this)[i] = T();
+			}
+		}
+		m_Size = newSize;
+	}
+
+	void reserve(size_t newCapacity)
+	{
+		while (capacity() < newCapacity)
+		{
+			m_Pages.push_back(AllocatePage());
+		}
+	}
+
+	void clear()
+	{
+		for (T* page : m_Pages)
+		{
+			DeallocatePage(page);
+		}
+		m_Pages.clear();
+		m_Size = 0;
+	}
+
+	T& emplace_back()
+	{
+		reserve(m_Size + 1);
+		m_Size++;
+		return back();
+	}
+
+	void push_back(T&& value)
+	{
+		emplace_back() = std::move(value);
+	}
+
+	void pop_back()
+	{
+		m_Size--;
+		if constexpr (std::is_move_assignable<T>::value)
+		{
+			(*this)[m_Size] = T();
+		}
+	}
+
+	T& back() { return (*this)[m_Size - 1]; }
+	const T& back() const { return (*this)[m_Size - 1]; }
+
+	/**
+	 * \brief Index of an element from its address, or size() if it is not stored here
+	 */
+	size_t IndexOf(const T* element) const
+	{
+		for (size_t page = 0; page < m_Pages.size(); page++)
+		{
+			const T* pageBegin = m_Pages[page];
+			if (element >= pageBegin && element < pageBegin + pageSize)
+			{
+				const size_t index = page * pageSize + (element - pageBegin);
+				return index < m_Size ? index : m_Size;
+			}
+		}
+		return m_Size;
+	}
+
+	size_t GetPageNmb() const
+	{
+		return (m_Size + pageSize - 1) / pageSize;
+	}
+	/**
+	 * \brief Contiguous elements of a page, GetPageLength(page) of them are in use
+	 */
+	T* GetPage(size_t page)
+	{
+		return m_Pages[page];
+	}
+	const T* GetPage(size_t page) const
+	{
+		return m_Pages[page];
+	}
+	size_t GetPageLength(size_t page) const
+	{
+		const size_t pageBegin = page * pageSize;
+		return m_Size - pageBegin < pageSize ? m_Size - pageBegin : pageSize;
+	}
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, m_Size); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, m_Size); }
+private:
+	T* AllocatePage()
+	{
+		T* page = static_cast<T*>(m_AllocationPolicy.Allocate(sizeof(T) * pageSize, alignof(T)));
+		for (size_t i = 0; i < pageSize; i++)
+		{
+			new(page + i) T();
+		}
+		return page;
+	}
+
+	void DeallocatePage(T* page)
+	{
+		for (size_t i = 0; i < pageSize; i++)
+		{
+			page[i].~T();
+		}
+		m_AllocationPolicy.Deallocate(page, alignof(T));
+	}
+
+	void Swap(PagedVector& other) noexcept
+	{
+		std::swap(m_Pages, other.m_Pages);
+		std::swap(m_Size, other.m_Size);
+		std::swap(m_AllocationPolicy, other.m_AllocationPolicy);
+	}
+
+	std::vector<T*> m_Pages;
+	size_t m_Size = 0;
+	TAllocationPolicy m_AllocationPolicy;
+};
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_PREFAB_H
+#define SFGE_PREFAB_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <engine/globals.h>
+#include <engine/component_mask.h>
+#include <utility/json_utility.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Component of a prefab, componentJson has the format of a component in a scene
+ */
+struct PrefabComponent
+{
+	ComponentTypeId componentTypeId = INVALID_COMPONENT_TYPE_ID;
+	json componentJson;
+};
+
+/**
+ * \brief Template of an entity, its components are parsed once and created in bulk by SceneManager::Instantiate
+ */
+class Prefab
+{
+public:
+	void SetName(const std::string& name);
+	const std::string& GetName() const;
+
+	void AddComponent(ComponentTypeId componentTypeId, json componentJson = json::object());
+	void AddComponent(ComponentType componentType, json componentJson = json::object());
+	/**
+	 * \brief Components in creation order, a component can read the ones added before it
+	 */
+	const std::vector<PrefabComponent>& GetComponents() const;
+	ComponentMask GetMask() const;
+private:
+	std::string m_Name;
+	std::vector<PrefabComponent> m_Components;
+	ComponentMask m_Mask;
+};
+
+/**
+ * \brief Called on every new instance once all the components of the prefab exist, instanceIndex goes from 0 to count-1
+ */
+using PrefabInitializer = std::function<void(Entity entity, size_t instanceIndex)>;
+
+}
+
+#endif
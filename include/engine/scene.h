@@ -33,6 +33,7 @@
 #include <engine/system.h>
 #include <utility/json_utility.h>
 #include <engine/entity.h>
+#include <engine/prefab.h>
 
 
 
@@ -81,6 +82,22 @@ public:
 	std::list<std::string> GetAllScenes();
 
 	void AddComponentManager(IComponentFactory* componentFactory, ComponentType componentType);
+	/**
+	 * \brief Factory of a component type registered in the ComponentTypeRegistry, used when "type" is its name in the scene
+	 */
+	void AddComponentManager(IComponentFactory* componentFactory, ComponentTypeId componentTypeId);
+	IComponentFactory* GetComponentFactory(ComponentTypeId componentTypeId) const;
+	/**
+	 * \brief Parse a prefab from JSON in the format of a scene entity, the component types are resolved once here
+	 */
+	Prefab CreatePrefab(json& prefabJson) const;
+	/**
+	 * \brief Create count instances of prefab, the entities are reserved at once and each component type is created in bulk.
+	 * initializer runs on every instance, spread over the thread pool when parallel is set, in which case it must only
+	 * write to the components of its entity and use the command buffer for the rest
+	 */
+	std::vector<Entity> Instantiate(const Prefab& prefab, size_t count,
+		const PrefabInitializer& initializer = nullptr, bool parallel = false);
 
 	void OnUpdate(float dt) override;
 	void OnFixedUpdate() override;
@@ -92,10 +109,18 @@ public:
 private:
 
 	void InitScenePySystems();
+	/**
+	 * \brief Builtin ComponentType flag or name of a type of the ComponentTypeRegistry
+	 */
+	ComponentTypeId GetComponentTypeIdFromJson(json& componentJson) const;
+	/**
+	 * \brief Let the component managers allocate their storage once for all the components of the scene
+	 */
+	void ReserveSceneComponents(json& entitiesJson);
 
 	std::vector<PySystem*> m_ScenePySystems;
 	EntityManager* m_EntityManager = nullptr;
-	std::vector<IComponentFactory*> m_ComponentManager{sizeof(ComponentType)*8};
+	std::vector<IComponentFactory*> m_ComponentManager = std::vector<IComponentFactory*>(MAX_COMPONENT_TYPES, nullptr);
 	std::map<std::string, std::string> m_ScenePathMap;
 
 };
@@ -0,0 +1,76 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_SCHEDULER_H
+#define SFGE_SCHEDULER_H
+
+#include <vector>
+#include <future>
+#include <ctpl_stl.h>
+
+#include <engine/system.h>
+#include <engine/command_buffer.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Runs the OnUpdate of systems concurrently when their declared read/write masks do not conflict.
+ * Systems are added in their serial order, a system depends on every previous system it conflicts with.
+ * Systems are grouped in waves by the length of their dependency chain, a wave only starts when the previous
+ * one finished, so the result is the same as running them one after the other.
+ */
+class SystemScheduler
+{
+public:
+	void AddSystem(System* system);
+	/**
+	 * \brief Run after in a later wave than before even if their component access does not conflict,
+	 * for ordering that is not expressed by components (drawing on the window). before must be added first
+	 */
+	void AddDependency(System* before, System* after);
+	void Clear();
+	/**
+	 * \brief Compute the dependencies and the waves, to be called after all the systems are added
+	 */
+	void Build();
+	/**
+	 * \brief Run a frame, worker systems are pushed to the thread pool and main thread systems run on the calling thread.
+	 * With a commandBuffer, each system records in its own buffer and they are appended to it in the serial order
+	 */
+	void Update(float dt, ctpl::thread_pool& threadPool, EntityCommandBuffer* commandBuffer = nullptr);
+
+	static bool IsConflicting(const System& previousSystem, const System& nextSystem);
+	const std::vector<std::vector<size_t>>& GetWaves() const;
+private:
+	std::vector<System*> m_Systems;
+	std::vector<std::pair<System*, System*>> m_Dependencies;
+	std::vector<std::vector<size_t>> m_Waves;
+	std::vector<std::future<void>> m_Futures;
+	std::vector<EntityCommandBuffer> m_CommandBuffers;
+};
+
+}
+
+#endif
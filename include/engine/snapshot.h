@@ -0,0 +1,176 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_SNAPSHOT_H
+#define SFGE_SNAPSHOT_H
+
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#include <engine/paged_vector.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Contiguous copy of the trivially copyable state of the world, written and read back in the same order.
+ * Paged arrays are copied a page at a time so saving and restoring are plain memcpy
+ */
+class WorldSnapshot
+{
+public:
+	/**
+	 * \brief Sequential reads of a snapshot, a read past the end fails and leaves the value untouched
+	 */
+	class Reader
+	{
+	public:
+		explicit Reader(const WorldSnapshot& snapshot) : m_Snapshot(snapshot) {}
+
+		template<class T>
+		bool Read(T& value)
+		{
+			return ReadArray(&value, 1);
+		}
+
+		template<class T>
+		bool ReadArray(T* values, size_t length)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be restored from a snapshot");
+			const size_t size = sizeof(T) * length;
+			if (m_Position + size > m_Snapshot.m_Buffer.size())
+				return false;
+			if (size != 0)
+				std::memcpy(values, m_Snapshot.m_Buffer.data() + m_Position, size);
+			m_Position += size;
+			return true;
+		}
+
+		/**
+		 * \brief Read back the elements of a paged array into its first elements, it must be at least as long as when it was written
+		 */
+		template<class T, size_t pageSize, class TAllocationPolicy>
+		bool ReadPagedVector(PagedVector<T, pageSize, TAllocationPolicy>& pagedVector)
+		{
+			size_t size = 0;
+			if (!Read(size) || size > pagedVector.size())
+				return false;
+			for (size_t pageBegin = 0; pageBegin < size; pageBegin += pageSize)
+			{
+				const size_t length = size - pageBegin < pageSize ? size - pageBegin : pageSize;
+				if (!ReadArray(pagedVector.GetPage(pageBegin / pageSize), length))
+					return false;
+			}
+			return true;
+		}
+
+		/**
+		 * \brief Move past length values without reading them, used to check a snapshot before restoring it
+		 */
+		template<class T>
+		bool SkipArray(size_t length)
+		{
+			const size_t size = sizeof(T) * length;
+			if (m_Position + size > m_Snapshot.m_Buffer.size())
+				return false;
+			m_Position += size;
+			return true;
+		}
+
+		/**
+		 * \brief Move past a paged array written by WritePagedVector, it fails like ReadPagedVector for a destination of maxSize elements
+		 */
+		template<class T>
+		bool SkipPagedVector(size_t maxSize)
+		{
+			size_t size = 0;
+			return Read(size) && size <= maxSize && SkipArray<T>(size);
+		}
+
+		bool IsAtEnd() const { return m_Position == m_Snapshot.m_Buffer.size(); }
+	private:
+		const WorldSnapshot& m_Snapshot;
+		size_t m_Position = 0;
+	};
+
+	template<class T>
+	void Write(const T& value)
+	{
+		WriteArray(&value, 1);
+	}
+
+	template<class T>
+	void WriteArray(const T* values, size_t length)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be saved in a snapshot");
+		const size_t size = sizeof(T) * length;
+		const size_t position = m_Buffer.size();
+		m_Buffer.resize(position + size);
+		if (size != 0)
+			std::memcpy(m_Buffer.data() + position, values, size);
+	}
+
+	template<class T, size_t pageSize, class TAllocationPolicy>
+	void WritePagedVector(const PagedVector<T, pageSize, TAllocationPolicy>& pagedVector)
+	{
+		Write(pagedVector.size());
+		for (size_t page = 0; page < pagedVector.GetPageNmb(); page++)
+		{
+			WriteArray(pagedVector.GetPage(page), pagedVector.GetPageLength(page));
+		}
+	}
+
+	/**
+	 * \brief Empty the snapshot, the buffer keeps its capacity so taking a new snapshot does not allocate
+	 */
+	void Clear() { m_Buffer.clear(); }
+	size_t GetSize() const { return m_Buffer.size(); }
+	bool IsEmpty() const { return m_Buffer.empty(); }
+	Reader GetReader() const { return Reader(*this); }
+private:
+	std::vector<char> m_Buffer;
+};
+
+/**
+ * \brief System whose state is part of a WorldSnapshot
+ */
+class ISnapshotable
+{
+public:
+	virtual void SaveSnapshot(WorldSnapshot& snapshot) = 0;
+	/**
+	 * \brief Move past the section without changing the world, returns false when RestoreSnapshot would fail on it.
+	 * entityNmb is the number of entity slots once the snapshot is restored, set by the EntityManager section
+	 */
+	virtual bool CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const = 0;
+	/**
+	 * \brief Read back what SaveSnapshot wrote, returns false when the snapshot does not match
+	 */
+	virtual bool RestoreSnapshot(WorldSnapshot::Reader& reader) = 0;
+};
+
+}
+
+#endif
@@ -25,11 +25,18 @@
 #ifndef SFGE_SYSTEM_H
 #define SFGE_SYSTEM_H
 
+#include <engine/component_mask.h>
+
 namespace sfge
 {
 
 class Engine;
 struct ColliderData;
+/**
+ * \brief Set of component types, indexed by ComponentTypeId
+ */
+using EntityMask = ComponentMask;
+const EntityMask ALL_COMPONENTS_MASK = ComponentMask::All();
 /**
 * \brief Systems are classes used by the Engine to init and update features, new features can be added through PySystem
 */
@@ -81,9 +88,29 @@ public:
 
 	Engine& GetEngine() const;
 	bool GetInitlialized() const;
+	/**
+	* \brief Component types read by OnUpdate, used by the SystemScheduler to find which systems can run concurrently
+	*/
+	EntityMask GetReadMask() const;
+	/**
+	* \brief Component types written by OnUpdate
+	*/
+	EntityMask GetWriteMask() const;
+	/**
+	* \brief Main thread systems are never sent to the thread pool (window, Python, editor)
+	*/
+	bool IsMainThreadOnly() const;
 protected:
+	/**
+	* \brief Declare the data accessed by OnUpdate, systems that do not declare it conflict with every other system
+	*/
+	void SetComponentAccess(EntityMask readMask, EntityMask writeMask, bool mainThreadOnly);
+
 	bool m_Enable = true;
 	bool m_Initialized = false;
+	EntityMask m_ReadMask = ALL_COMPONENTS_MASK;
+	EntityMask m_WriteMask = ALL_COMPONENTS_MASK;
+	bool m_MainThreadOnly = true;
 
 	Engine& m_Engine;
 };
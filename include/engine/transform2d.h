@@ -28,10 +28,20 @@
 #include <engine/entity.h>
 #include <engine/component.h>
 #include <engine/vector.h>
+#include <engine/paged_vector.h>
+#include <engine/snapshot.h>
 
 namespace sfge
 {
 
+/**
+ * \brief Last seen version of a component that has not copied its transform yet
+ */
+const unsigned INVALID_TRANSFORM_VERSION = ~0U;
+/**
+ * \brief Last seen version of a component whose entity has no transform
+ */
+const unsigned NO_TRANSFORM_VERSION = ~0U - 1U;
 
 struct Transform2d
 {
@@ -40,6 +50,152 @@ struct Transform2d
 	float EulerAngle = 0.0f;
 };
 
+/**
+ * \brief Proxy to a x/y pair stored in two separate arrays, behaves like a Vec2f.
+ * The assignments increment the version of the transform, writes through x and y do not
+ */
+struct Vec2fRef
+{
+	float& x;
+	float& y;
+	unsigned& version;
+
+	Vec2fRef(const Vec2fRef& v) = default;
+	Vec2fRef& operator=(const Vec2f& v);
+	Vec2fRef& operator=(const Vec2fRef& v);
+	Vec2fRef& operator+=(const Vec2f& rhs);
+	Vec2fRef& operator-=(const Vec2f& rhs);
+	Vec2f operator+(const Vec2f& rhs) const;
+	Vec2f operator-(const Vec2f& rhs) const;
+	operator Vec2f() const;
+	operator sf::Vector2f() const;
+};
+
+/**
+ * \brief Proxy to a transform of the Transform2dStorage, reads and writes go directly to its arrays.
+ * Reads leave Version untouched, assigning the position, the scale, the angle or a whole transform increments it
+ */
+struct Transform2dRef
+{
+	Vec2fRef Position;
+	Vec2fRef Scale;
+	unsigned& Version;
+
+	Transform2dRef(Vec2fRef position, Vec2fRef scale, float& eulerAngle, unsigned& version);
+	Transform2dRef(const Transform2dRef& transform) = default;
+	Transform2dRef& operator=(const Transform2d& transform);
+	Transform2dRef& operator=(const Transform2dRef& transform);
+	operator Transform2d() const;
+
+	float GetEulerAngle() const;
+	void SetEulerAngle(float eulerAngle);
+private:
+	float& m_EulerAngle;
+};
+
+/**
+ * \brief Pointer-like handle to a Transform2dRef, returned by Transform2dManager::GetComponentPtr
+ */
+class Transform2dPtr
+{
+public:
+	explicit Transform2dPtr(Transform2dRef ref) : m_Ref(ref) {}
+	Transform2dRef* operator->() const { return &m_Ref; }
+	Transform2dRef& operator*() const { return m_Ref; }
+private:
+	mutable Transform2dRef m_Ref;
+};
+
+/**
+ * \brief Struct-of-arrays storage of the transforms, each field is paged so addresses stay stable on resize
+ * and the kernels work on contiguous floats within a page.
+ * Every transform has a version incremented by the writes through its Transform2dRef, readers compare it to skip unchanged transforms.
+ */
+class Transform2dStorage
+{
+public:
+	using value_type = Transform2d;
+	using reference = Transform2dRef;
+	using pointer = Transform2dPtr;
+
+	/**
+	 * \brief Mutable access, only the writes through the returned proxy increment the version of the transform
+	 */
+	Transform2dRef operator[](size_t index);
+	Transform2dPtr GetPtr(size_t index);
+	/**
+	 * \brief Read only access, leaves the version untouched and is safe to call from concurrent readers
+	 */
+	Transform2d Get(size_t index) const;
+	unsigned GetVersion(size_t index) const;
+	void MarkChanged(size_t index);
+	size_t size() const;
+	void resize(size_t newSize);
+	void clear();
+	/**
+	 * \brief Allocator of the next pages of every array
+	 */
+	void SetAllocator(Allocator* allocator);
+
+	size_t GetPageNmb() const;
+	size_t GetPageLength(size_t page) const;
+
+	ComponentStorage<float>& GetPositionsX() { return m_PositionsX; }
+	ComponentStorage<float>& GetPositionsY() { return m_PositionsY; }
+	ComponentStorage<float>& GetScalesX() { return m_ScalesX; }
+	ComponentStorage<float>& GetScalesY() { return m_ScalesY; }
+	ComponentStorage<float>& GetAngles() { return m_Angles; }
+	ComponentStorage<unsigned>& GetVersions() { return m_Versions; }
+private:
+	ComponentStorage<float> m_PositionsX;
+	ComponentStorage<float> m_PositionsY;
+	ComponentStorage<float> m_ScalesX;
+	ComponentStorage<float> m_ScalesY;
+	ComponentStorage<float> m_Angles;
+	ComponentStorage<unsigned> m_Versions;
+};
+
+/**
+ * \brief Bytes of the pages of every array of the storage
+ */
+size_t GetContainerFootprint(const Transform2dStorage& storage);
+
+/**
+ * \brief Wrap the angles once in [-180, 180] like Transform2dManager::OnUpdate. Uses AVX or SSE2 when available.
+ * The versions of the wrapped angles are incremented when given
+ */
+void WrapAngles(float* angles, size_t length, unsigned* versions = nullptr);
+/**
+ * \brief Add delta to all the positions
+ */
+void TranslatePositions(float* positionsX, float* positionsY, size_t length, Vec2f delta);
+/**
+ * \brief pixels = meters * pixelPerMeter - offsets, in place is allowed
+ */
+void MetersToPixels(const float* metersX, const float* metersY,
+	const float* offsetsX, const float* offsetsY,
+	float* pixelsX, float* pixelsY, size_t length, float pixelPerMeter);
+/**
+ * \brief World transform of a local transform relative to parent, in the SFML order: translation, rotation then scale
+ */
+Transform2d ComposeTransforms(const Transform2d& parent, const Transform2d& local);
+/**
+ * \brief Local position relative to parent of a world position, inverse of ComposeTransforms on the position
+ */
+Vec2f InverseTransformPosition(const Transform2d& parent, Vec2f worldPosition);
+
+/**
+ * \brief Entry of the depth-sorted hierarchy, with the versions used to compute its world transform
+ */
+struct TransformHierarchyNode
+{
+	Entity entity = INVALID_ENTITY;
+	Entity parent = INVALID_ENTITY;
+	unsigned depth = 0;
+	unsigned localVersion = INVALID_TRANSFORM_VERSION;
+	unsigned parentVersion = INVALID_TRANSFORM_VERSION;
+};
+
 namespace editor
 {
 struct Transform2dInfo : ComponentInfo
@@ -49,15 +205,98 @@ struct Transform2dInfo : ComponentInfo
 };
 }
 
+/**
+ * \brief Manages the local transforms and the world transforms of the entities with a parent.
+ * Children are kept in a flat array sorted by depth so parents are always computed before their children,
+ * only the branches whose local or parent version changed are recomputed.
+ */
 class Transform2dManager :
-	public SingleComponentManager<Transform2d, editor::Transform2dInfo, ComponentType::TRANSFORM2D>
+	public SingleComponentManager<Transform2d, editor::Transform2dInfo, ComponentType::TRANSFORM2D, Transform2dStorage>,
+	public ISnapshotable
 {
 public:
-	using SingleComponentManager::SingleComponentManager;
-	Transform2d* AddComponent(Entity entity) override;
+	Transform2dManager(Engine& engine);
+	void OnEngineInit() override;
+	Transform2dPtr AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
+	/**
+	 * \brief Parse the transform once and copy it to every entity
+	 */
+	void CreateComponents(json& componentJson, const std::vector<Entity>& entities) override;
 	void DestroyComponent(Entity entity) override;
+	void OnDestroy(Entity entity) override;
+	void OnDestroyEntities(const std::vector<Entity>& entities) override;
+	void OnResize(size_t newSize) override;
 	void OnUpdate(float dt) override;
+	void OnBeforeSceneLoad() override;
+	void OnAfterSceneLoad() override;
+	/**
+	 * \brief Move every transform by delta
+	 */
+	void TranslateAll(Vec2f delta);
+	/**
+	 * \brief Copy of the transform that does not count as a change
+	 */
+	Transform2d GetTransform(Entity entity) const;
+	/**
+	 * \brief Version of the transform, different from the last seen one when the transform may have changed
+	 */
+	unsigned GetVersion(Entity entity) const;
+
+	/**
+	 * \brief Attach entity to parent keeping its local transform, INVALID_ENTITY detaches it.
+	 * Fails when it would create a cycle
+	 */
+	bool SetParent(Entity entity, Entity parent);
+	Entity GetParent(Entity entity) const;
+	/**
+	 * \brief Recompute the world transforms of the changed branches, done in OnUpdate
+	 */
+	void UpdateWorldTransforms();
+	/**
+	 * \brief Cached world transform, the local one for entities without parent
+	 */
+	Transform2d GetWorldTransform(Entity entity) const;
+	/**
+	 * \brief Version of the world transform, keeps increasing when the entity is attached or detached
+	 */
+	unsigned GetWorldVersion(Entity entity) const;
+	/**
+	 * \brief Move the entity to a world position, converted to its parent space when it has one
+	 */
+	void SetWorldPosition(Entity entity, Vec2f position);
+	const std::vector<TransformHierarchyNode>& GetHierarchy() const;
+
+	/**
+	 * \brief Local transforms, plus the world transforms and the hierarchy
+	 */
+	void ReportMemory(MemoryTracker& memoryTracker) const override;
+
+	/**
+	 * \brief Save the local transforms and the parents, the world transforms are recomputed on restore
+	 */
+	void SaveSnapshot(WorldSnapshot& snapshot) override;
+	bool CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const override;
+	/**
+	 * \brief Every restored transform counts as changed, its version goes past all the ones seen before
+	 */
+	bool RestoreSnapshot(WorldSnapshot::Reader& reader) override;
+private:
+	void Detach(Entity entity);
+	/**
+	 * \brief Make the world transform of a child its local one and forget its parent, the hierarchy node is left to the caller
+	 */
+	void KeepWorldTransform(size_t index);
+	void RemoveFromHierarchy(Entity entity);
+	void SortHierarchy();
+	void SetWorldTransform(size_t index, const Transform2d& world);
+
+	Transform2dStorage m_WorldTransforms;
+	std::vector<Entity> m_Parents;
+	std::vector<TransformHierarchyNode> m_Hierarchy;
+	bool m_HierarchyDirty = false;
+	//Parents from the scene file, as 1-based entity indexes resolved once all the entities exist
+	std::vector<std::pair<Entity, Entity>> m_SceneParents;
 };
 
 }
@@ -0,0 +1,77 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_VIRTUAL_ARENA_H
+#define SFGE_VIRTUAL_ARENA_H
+
+#include <engine/memory.h>
+
+namespace sfge
+{
+
+/**
+ * \brief Linear allocator over a reserved range of address space. Pages are committed when the allocations reach them
+ * and decommitted by clear() above the high-water mark, so the reservation can be large while the resident memory
+ * follows what is really used. Like the LinearAllocator, memory is given back with clear()
+ */
+class VirtualArena : public Allocator
+{
+public:
+
+    /**
+     * \brief Reserve reserveSize bytes, rounded up to the page size. clear() keeps highWaterMark bytes committed
+     */
+    VirtualArena(size_t reserveSize, size_t highWaterMark = 0);
+    ~VirtualArena();
+
+    /**
+     * \brief Returns nullptr only when the reservation is full or the pages cannot be committed
+     */
+    void* allocate(size_t size, ptr_type alignment) override;
+    void deallocate(void* p) override;
+    void clear();
+
+    size_t getCommittedMemory() const { return _committed_memory; }
+    size_t getHighWaterMark() const { return _high_water_mark; }
+
+    static size_t getPageSize();
+
+private:
+
+    VirtualArena(const VirtualArena&);
+
+    //Prevent copies because it might cause errors
+    VirtualArena& operator=(const VirtualArena&);
+
+    bool commit(size_t size);
+    void decommit(size_t keptSize);
+
+    void* _current_pos;
+    size_t _committed_memory;
+    size_t _high_water_mark;
+};
+
+}
+
+#endif
@@ -26,10 +26,12 @@ SOFTWARE.
 #define SFGE_SHAPE_H_
 
 #include <list>
+#include <algorithm>
 
 #include <engine/system.h>
 #include <engine/component.h>
 #include <engine/transform2d.h>
+#include <engine/memory.h>
 #include <editor/editor.h>
 //Externals
 #include <SFML/Graphics.hpp>
@@ -46,23 +48,44 @@ enum class ShapeType
 	CONVEX,
 };
 
+/**
+ * \brief Size and alignment of a slot of the ShapeManager pool, big enough for any SFML shape used by the Shape component
+ */
+const size_t SHAPE_OBJECT_ALIGNMENT = std::max({alignof(sf::CircleShape), alignof(sf::RectangleShape), alignof(sf::ConvexShape)});
+const size_t SHAPE_OBJECT_SIZE = (std::max({sizeof(sf::CircleShape), sizeof(sf::RectangleShape), sizeof(sf::ConvexShape)}) +
+	SHAPE_OBJECT_ALIGNMENT - 1) / SHAPE_OBJECT_ALIGNMENT * SHAPE_OBJECT_ALIGNMENT;
+
+/**
+ * \brief Gives the SFML shapes allocated from a pool back to it, deletes the other ones
+ */
+struct ShapeDeleter
+{
+	PoolAllocator* pool = nullptr;
+	void operator()(sf::Shape* shape) const;
+};
+using ShapePtr = std::unique_ptr<sf::Shape, ShapeDeleter>;
+
 class Shape : public Offsetable
 {
 public:
   	Shape();
 	Shape(Transform2d* transform, sf::Vector2f offset);
   	Shape ( Shape && ) = default; //move constructor
+  	Shape& operator=( Shape && ) = default; //move assignment, used when the sparse storage is repacked
   	Shape ( const Shape & ) = delete; //delete copy constructor
   	virtual ~Shape();
 	void Draw(sf::RenderWindow& window) const;
 	void SetFillColor(sf::Color color) const;
 	void Update() const;
+	void SetShape(ShapePtr shape);
 	void SetShape(std::unique_ptr<sf::Shape> shape);
 	sf::Shape* GetShape();
+	void SetOffset(sf::Vector2f offset) override;
 protected:
 	friend class ShapeManager;
 	Transform2d transform;
-	std::unique_ptr<sf::Shape> m_Shape = nullptr;
+	unsigned m_TransformVersion = INVALID_TRANSFORM_VERSION;
+	ShapePtr m_Shape = nullptr;
 	Entity entity = INVALID_ENTITY;
 };
 class ShapeManager;
@@ -79,12 +102,13 @@ struct ShapeInfo : ComponentInfo
 }
 
 class ShapeManager :
-	public SingleComponentManager<Shape, editor::ShapeInfo, ComponentType::SHAPE2D>
+	public SparseComponentManager<Shape, editor::ShapeInfo, ComponentType::SHAPE2D>
 {
 
 public:
-	using SingleComponentManager::SingleComponentManager; 
+	using SparseComponentManager::SparseComponentManager; 
 	ShapeManager(ShapeManager&& shapeManager) = default;
+	~ShapeManager();
 
 	void OnEngineInit() override;
 	void DrawShapes(sf::RenderWindow &window);
@@ -94,10 +118,35 @@ public:
 	Shape* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
 	void DestroyComponent(Entity entity) override;
-
-	void OnResize(size_t new_size) override;
+	/**
+	 * \brief Size the shape pool for the shapes of the scene, only done while no shape uses the pool
+	 */
+	void ReserveComponents(size_t componentNmb) override;
+	/**
+	 * \brief New SFML shape taken from the pool, from the heap when the pool is full
+	 */
+	template<class TShape>
+	ShapePtr CreateShape()
+	{
+		static_assert(sizeof(TShape) <= SHAPE_OBJECT_SIZE && alignof(TShape) <= SHAPE_OBJECT_ALIGNMENT,
+			"TShape does not fit in the shape pool");
+		CountAllocation();
+		if (m_ShapePool != nullptr)
+		{
+			void* ptr = m_ShapePool->allocate(SHAPE_OBJECT_SIZE, SHAPE_OBJECT_ALIGNMENT);
+			if (ptr != nullptr)
+			{
+				return ShapePtr(new(ptr) TShape(), ShapeDeleter{m_ShapePool.get()});
+			}
+		}
+		return ShapePtr(new TShape(), ShapeDeleter{});
+	}
+	size_t GetShapePoolCapacity() const;
 protected:
 	Transform2dManager* m_Transform2dManager;
+	std::unique_ptr<char[]> m_ShapeMemory;
+	std::unique_ptr<PoolAllocator> m_ShapePool;
+	size_t m_ShapePoolCapacity = 0;
 };
 
 
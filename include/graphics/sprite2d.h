@@ -52,10 +52,17 @@ public:
 	void Init();
 	void Update();
 	void Draw(sf::RenderWindow& window);
-	void SetTexture(sf::Texture* newTexture);
+	void SetTexture(sf::Texture* newTexture, TextureId textureId = INVALID_TEXTURE);
+	/**
+	 * \brief Id of the texture in the TextureManager, INVALID_TEXTURE when set without id
+	 */
+	TextureId GetTextureId() const;
+	void SetOffset(sf::Vector2f offset) override;
 protected:
 	friend class SpriteManager;
 	Transform2d transform;
+	unsigned m_TransformVersion = INVALID_TRANSFORM_VERSION;
+	TextureId m_TextureId = INVALID_TEXTURE;
 	sf::Sprite sprite;
 };
 
@@ -74,11 +81,11 @@ struct SpriteInfo : ComponentInfo
 /**
 * \brief Sprite manager caching all the sprites and rendering them at the end of the frame
 */
-class SpriteManager : public SingleComponentManager<Sprite, editor::SpriteInfo, ComponentType::SPRITE2D>,
-	public LayerComponentManager<Sprite>
+class SpriteManager : public SparseComponentManager<Sprite, editor::SpriteInfo, ComponentType::SPRITE2D>,
+	public LayerComponentManager<Sprite>, public ISnapshotable
 {
 public:
-	using SingleComponentManager::SingleComponentManager;
+	using SparseComponentManager::SparseComponentManager;
 
 	void OnEngineInit() override;
 	void OnUpdate(float dt) override;
@@ -88,12 +95,32 @@ public:
 	void OnAfterSceneLoad() override;
 	Sprite* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
+	/**
+	 * \brief Load the texture once and append all the sprites to the packed arrays
+	 */
+	void CreateComponents(json& componentJson, const std::vector<Entity>& entities) override;
 	void DestroyComponent(Entity entity) override;
-
-	void OnResize(size_t new_size) override;
+	/**
+	 * \brief Save the entity, texture id, layer and offset of every sprite
+	 */
+	void SaveSnapshot(WorldSnapshot& snapshot) override;
+	bool CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const override;
+	/**
+	 * \brief Updates the sprites in place when their entities did not change, rebuilds them from their texture ids otherwise
+	 */
+	bool RestoreSnapshot(WorldSnapshot::Reader& reader) override;
 protected:
+	/**
+	 * \brief Texture of the "path" of a sprite JSON, INVALID_TEXTURE with an error logged when it cannot be loaded
+	 */
+	TextureId LoadComponentTexture(json& componentJson);
+
 	Graphics2dManager* m_GraphicsManager = nullptr;
 	Transform2dManager* m_Transform2dManager = nullptr;
+	std::vector<Entity> m_SnapshotEntities;
+	std::vector<TextureId> m_SnapshotTextureIds;
+	std::vector<int> m_SnapshotLayers;
+	std::vector<Vec2f> m_SnapshotOffsets;
 };
 
 
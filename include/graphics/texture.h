@@ -28,6 +28,7 @@ SOFTWARE.
 //STL
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 
 //Externals
@@ -36,6 +37,7 @@ SOFTWARE.
 
 #include <engine/system.h>
 #include <engine/globals.h>
+#include <engine/memory_tracker.h>
 
 namespace sfge
 {
@@ -47,7 +49,7 @@ const TextureId INVALID_TEXTURE = 0U;
 * \brief The Texture Manager is the cache of all the textures used for sprites or other objects
 *
 */
-class TextureManager : public System
+class TextureManager : public System, public IMemoryReporter
 {
 public:
 	using System::System;
@@ -70,12 +72,19 @@ public:
 	* \return The pointer to the texture in memory
 	*/
 	sf::Texture* GetTexture(TextureId textureId);
+	/**
+	 * \brief Path the texture was loaded from
+	 */
+	const std::string& GetTexturePath(TextureId textureId) const;
 	
 	void OnBeforeSceneLoad() override;
 
 	void OnAfterSceneLoad() override;
 
-
+	/**
+	 * \brief Pixels of the loaded textures, counted as 4 bytes per pixel, and the texture cache
+	 */
+	void ReportMemory(MemoryTracker& memoryTracker) const override;
 
 private:
   	bool HasValidExtension(std::string filename);
@@ -84,6 +93,10 @@ private:
 	std::vector<std::string> m_TexturePaths {INIT_ENTITY_NMB * 4};
 	std::vector<sf::Texture> m_Textures { INIT_ENTITY_NMB * 4 };
 	std::vector<size_t> m_TextureIdsRefCounts = std::vector<size_t>(INIT_ENTITY_NMB * 4, 0 );
+	/**
+	 * \brief Id of every path loaded once, so loading a texture again is a hash lookup
+	 */
+	std::unordered_map<std::string, TextureId> m_TextureIds;
 	TextureId m_IncrementId = 0U;
 
 };
@@ -38,7 +38,7 @@ class Body2d: public Offsetable
 {
 public:
 	Body2d();
-	Body2d(Transform2d *transform, Vec2f offset);
+	Body2d(Transform2dPtr transform, Vec2f offset);
 
 	p2Vec2 GetLinearVelocity() const;
 	void SetLinearVelocity(p2Vec2 velocity);
@@ -68,7 +68,8 @@ private:
 };
 }
 
-class Body2dManager : public SingleComponentManager<Body2d, editor::Body2dInfo, ComponentType::BODY2D>
+class Body2dManager : public SingleComponentManager<Body2d, editor::Body2dInfo, ComponentType::BODY2D>,
+	public ISnapshotable
 {
 public:
 	using SingleComponentManager::SingleComponentManager;
@@ -77,12 +78,28 @@ public:
 	Body2d* AddComponent(Entity entity) override;
 	void CreateComponent(json& componentJson, Entity entity) override;
 	void DestroyComponent(Entity entity) override;
+	/**
+	 * \brief Move the bodies of the new instances to their transform, the prefab initializer may have moved them
+	 */
+	void OnInstantiated(const std::vector<Entity>& entities) override;
 
 	void OnResize(size_t new_size) override;
+	/**
+	 * \brief Save the position and the linear velocity of every body
+	 */
+	void SaveSnapshot(WorldSnapshot& snapshot) override;
+	bool CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const override;
+	bool RestoreSnapshot(WorldSnapshot::Reader& reader) override;
 
 private:
 	Transform2dManager* m_Transform2dManager;
 	std::weak_ptr<p2World> m_WorldPtr;
+	std::vector<float> m_PositionsX;
+	std::vector<float> m_PositionsY;
+	std::vector<float> m_OffsetsX;
+	std::vector<float> m_OffsetsY;
+	std::vector<p2Vec2> m_SnapshotPositions;
+	std::vector<p2Vec2> m_SnapshotVelocities;
 };
 
 
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <SFML/System/Time.hpp>
 
 #include <engine/system.h>
+#include <engine/memory_tracker.h>
 #include <physics/collider2d.h>
 #include <physics/body2d.h>
 #include "p2contact.h"
@@ -71,7 +72,7 @@ public:
 /**
  * \brief The Physics Manager use Box2D to simulate 2D physics
  */
-class Physics2dManager : public System
+class Physics2dManager : public System, public IMemoryReporter
 {
 public:
 	using System::System;
@@ -102,6 +103,10 @@ public:
 
 	Body2dManager* GetBodyManager();
 	ColliderManager* GetColliderManager();
+	/**
+	 * \brief Bodies of the p2World, the body and collider components report themselves
+	 */
+	void ReportMemory(MemoryTracker& memoryTracker) const override;
 
 	//float Raycast(Vec2f startPoint, Vec2f direction, float rayLength);
 
@@ -49,7 +49,8 @@ const InstanceId INVALID_INSTANCE = 0U;
 * \brief Manage the python interpreter
 */
 class PythonEngine :
-		public System
+		public System,
+		public IMemoryReporter
 {
 public:
 	using System::System;
@@ -76,6 +77,10 @@ public:
 	void OnBeforeSceneLoad() override;
 
 	ModuleId LoadPyModule(std::string moduleFilename);
+	/**
+	 * \brief Modules and instances containers, plus the Python heap when a script started tracemalloc
+	 */
+	void ReportMemory(MemoryTracker& memoryTracker) const override;
 
 
 	PySystemManager& GetPySystemManager(){ return m_PySystemManager; }
@@ -0,0 +1,67 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifndef SFGE_STRING_INTERNER_H
+#define SFGE_STRING_INTERNER_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+
+namespace sfge
+{
+
+using StringId = unsigned;
+const StringId INVALID_STRING_ID = 0U;
+
+/**
+ * \brief Stores each distinct string once and gives it a strictly positive id, comparing two interned strings
+ * is comparing their ids
+ */
+class StringInterner
+{
+public:
+	/**
+	 * \brief Id of str, stored on first call
+	 */
+	StringId Intern(std::string_view str);
+	/**
+	 * \brief Id of str if it was interned, INVALID_STRING_ID otherwise. Never stores anything
+	 */
+	StringId Find(std::string_view str) const;
+	/**
+	 * \brief Interned string, empty for INVALID_STRING_ID
+	 */
+	const std::string& GetString(StringId stringId) const;
+	size_t GetSize() const;
+	void Clear();
+private:
+	//A deque keeps the strings in place so the views used as keys stay valid
+	std::deque<std::string> m_Strings;
+	std::unordered_map<std::string_view, StringId> m_StringIds;
+};
+
+}
+#endif
@@ -10,6 +10,7 @@ texture_manager = graphics2d_manager.texture_manager
 class PlanetSystem(System):
     screen_size: Vector2f
     entity_nmb = None  # type: int
+    entities = None  # type: list
     center_mass = 1000.0
     planet_mass = 1.0
     gravity_const = 1000.0
@@ -17,18 +18,20 @@ class PlanetSystem(System):
     def init(self):
         self.entity_nmb = 256
         self.screen_size = engine.config.screen_size
-        entity_manager.resize(self.entity_nmb)
 
-        for i in range(self.entity_nmb):
-            new_entity = entity_manager.create_entity(i+1)
+        planet_prefab = Prefab()
+        planet_prefab.name = "Planet"
+        planet_prefab.add_component(System.Transform2d)
+        planet_prefab.add_component(System.Body, '{"body_type": 0}')
+        planet_prefab.add_component(System.Sprite, '{"path": "data/sprites/round.png"}')
+        self.entities = scene_manager.instantiate(planet_prefab, self.entity_nmb, self.init_planet)
 
-            transform = transform2d_manager.add_component(new_entity)  # type: Transform2d
-            transform.position = Vec2f(random.randint(0, self.screen_size.x), random.randint(0, self.screen_size.y))
+    def init_planet(self, entity, index):
+        transform = transform2d_manager.get_component(entity)  # type: Transform2d
+        transform.position = Vec2f(random.randint(0, self.screen_size.x), random.randint(0, self.screen_size.y))
 
-            body2d = body2d_manager.add_component(new_entity)  # type: Body2d
-            body2d.velocity = self.calculate_init_speed(transform)
-
-            sprite_manager.create_component(new_entity, "data/sprites/round.png")
+        body2d = body2d_manager.get_component(entity)  # type: Body2d
+        body2d.velocity = self.calculate_init_speed(transform)
 
     def calculate_init_speed(self, transform):
         delta_to_center = self.screen_size / 2.0 - transform.position
@@ -50,8 +53,8 @@ class PlanetSystem(System):
         return Physics2dManager.pixel2meter(delta_to_center / delta_to_center.magnitude * force)
 
     def fixed_update(self):
-        for i in range(self.entity_nmb):
-            transform = transform2d_manager.get_component(i+1)  # type: Transform2d
+        for entity in self.entities:
+            transform = transform2d_manager.get_component(entity)  # type: Transform2d
 
-            body2d = body2d_manager.get_component(i+1)  # type: Body2d
+            body2d = body2d_manager.get_component(entity)  # type: Body2d
             body2d.apply_force(self.calculate_new_force(transform))
@@ -3,10 +3,10 @@ from SFGE import *
 
 class StayOnscreenSystem(System):
 
-    bodies_entites: list
+    bodies_entites: EntityView
 
     def init(self):
-        self.bodies_entites = entity_manager.get_entities_with_type(System.Body)
+        self.bodies_entites = entity_manager.get_view(System.Body, System.Transform2d)
 
     def fixed_update(self):
         config = engine.config
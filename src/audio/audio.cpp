@@ -29,6 +29,7 @@ namespace sfge
 {
 void AudioManager::OnEngineInit()
 {
+	SetComponentAccess(EntityMask(), static_cast<EntityMask>(ComponentType::SOUND), false);
 	m_SoundManager.OnEngineInit();
 	m_SoundBufferManager.OnEngineInit();
 	
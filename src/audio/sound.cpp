@@ -53,7 +53,9 @@ static std::set<std::string> sndExtensionSet
 SoundManager::SoundManager(Engine& engine): BasicComponentManager(engine)
 {
 	m_Components.resize(MAX_SOUND_CHANNELS-MUSIC_INSTANCES_NMB);
+	//The sound infos hold the buffer ids, they are needed with or without editor
 	m_ComponentsInfo.resize(MAX_SOUND_CHANNELS-MUSIC_INSTANCES_NMB);
+	m_HasComponentInfos = true;
 }
 
 SoundManager::~SoundManager()
@@ -96,7 +98,7 @@ void SoundManager::CreateComponent(json & componentJson, Entity entity)
 				return;
 			}
 			sound->SetEntity(entity);
-			const int index = sound - &m_Components[0];
+			const auto index = m_Components.IndexOf(sound);
 			auto* soundInfo = &m_ComponentsInfo[index];
 			const SoundBufferId soundBufferId = m_SoundBufferManager->LoadSoundBuffer(path);
 			if (soundBufferId != INVALID_SOUND_BUFFER)
@@ -208,6 +210,7 @@ SoundBufferManager::~SoundBufferManager()
 
 void SoundBufferManager::OnEngineInit()
 {
+	m_Engine.GetMemoryManager()->AddMemoryReporter(this);
 	if (const auto config = m_Engine.GetConfig())
 	{
 		if (config->devMode)
@@ -370,6 +373,17 @@ sf::SoundBuffer* SoundBufferManager::GetSoundBuffer(SoundBufferId soundBufferId)
 	return m_SoundBuffers[soundBufferId - 1].get();
 }
 
+void SoundBufferManager::ReportMemory(MemoryTracker& memoryTracker) const
+{
+	size_t sampleBytes = 0;
+	for (const auto& soundBuffer : m_SoundBuffers)
+	{
+		if (soundBuffer != nullptr)
+			sampleBytes += static_cast<size_t>(soundBuffer->getSampleCount()) * sizeof(sf::Int16);
+	}
+	memoryTracker.ReportFootprint(MemoryTag::SOUNDS, "Sound buffers", sampleBytes);
+}
+
 }
 
 void sfge::editor::SoundInfo::DrawOnInspector()
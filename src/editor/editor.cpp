@@ -24,6 +24,8 @@ SOFTWARE.
 
 
 
+#include <cstring>
+
 #include <imgui.h>
 #include <imgui-SFML.h>
 
@@ -112,12 +114,13 @@ void Editor::OnUpdate(float dt)
 			ImGui::Separator();
 			for (auto i = 0u; i < configPtr->currentEntitiesNmb; i++)
 			{
-				if(m_EntityManager->GetMask(i+1) != INVALID_ENTITY)
+				if(m_EntityManager->GetMask(i+1).Any())
 				{
-					auto& entityInfo = m_EntityManager->GetEntityInfo(i+1);
-					if(ImGui::Selectable(entityInfo.name.c_str(), selectedEntity-1 == i))
+					const auto& entityInfo = m_EntityManager->GetEntityInfo(i+1);
+					const std::string label = entityInfo.name.empty() ? "Entity " + std::to_string(i + 1) : entityInfo.name;
+					if(ImGui::Selectable(label.c_str(), GetEntityIndex(selectedEntity)-1 == i))
 					{
-						selectedEntity = i + 1;
+						selectedEntity = m_EntityManager->GetEntity(i + 1);
 					}
 				}
 			}
@@ -139,7 +142,14 @@ void Editor::OnUpdate(float dt)
 			if(selectedEntity != INVALID_ENTITY)
 			{
 				auto& entityInfo = m_EntityManager->GetEntityInfo(selectedEntity);
-				ImGui::InputText("Name", &entityInfo.name[0u], 15);
+				char nameBuffer[64];
+				std::strncpy(nameBuffer, entityInfo.name.c_str(), sizeof(nameBuffer) - 1);
+				nameBuffer[sizeof(nameBuffer) - 1] = '\0';
+				//Renaming goes through the entity manager to keep the name index up to date
+				if(ImGui::InputText("Name", nameBuffer, sizeof(nameBuffer)))
+				{
+					m_EntityManager->SetEntityName(selectedEntity, nameBuffer);
+				}
 
 				for(auto& drawableComponentManager: m_DrawableObservers)
                 {
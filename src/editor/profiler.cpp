@@ -24,24 +24,125 @@ SOFTWARE.
 
 #include <editor/profiler.h>
 #include <engine/engine.h>
+#include <engine/memory_manager.h>
 #include <imgui.h>
 
 namespace sfge::editor
 {
-ProfilerEditorWindow::ProfilerEditorWindow(Engine& engine): m_ProfilerFrameData(engine.GetProfilerFrameData ())
+static const char* MEMORY_REPORT_FILENAME = "memory_report.json";
+
+static float ToKilobytes(size_t bytes)
+{
+  return static_cast<float>(bytes) / 1024.0f;
+}
+
+MemoryEditorWindow::MemoryEditorWindow(Engine& engine): m_MemoryManager(*engine.GetMemoryManager())
+{
+
+}
+
+void MemoryEditorWindow::Draw()
+{
+  m_MemoryManager.UpdateMemoryReport();
+  const auto& memoryTracker = m_MemoryManager.GetMemoryTracker();
+
+  ImGui::Columns(5, "MemoryTags");
+  ImGui::Text("Tag"); ImGui::NextColumn();
+  ImGui::Text("Current"); ImGui::NextColumn();
+  ImGui::Text("Peak"); ImGui::NextColumn();
+  ImGui::Text("Allocations"); ImGui::NextColumn();
+  ImGui::Text("Footprint"); ImGui::NextColumn();
+  ImGui::Separator();
+  for (int i = 0; i < static_cast<int>(MemoryTag::LENGTH); i++)
+  {
+    const auto memoryTag = static_cast<MemoryTag>(i);
+    const MemoryTagStats stats = memoryTracker.GetStats(memoryTag);
+    if (ImGui::Selectable(GetMemoryTagName(memoryTag), m_SelectedTag == i, ImGuiSelectableFlags_SpanAllColumns))
+    {
+      m_SelectedTag = i;
+    }
+    ImGui::NextColumn();
+    //Tags without recorded allocations only have their footprint
+    if (stats.tracked)
+    {
+      ImGui::Text("%.1f KB", ToKilobytes(stats.currentBytes)); ImGui::NextColumn();
+      ImGui::Text("%.1f KB", ToKilobytes(stats.peakBytes)); ImGui::NextColumn();
+      ImGui::Text("%zu", stats.allocationNmb); ImGui::NextColumn();
+    }
+    else
+    {
+      ImGui::TextDisabled("-"); ImGui::NextColumn();
+      ImGui::TextDisabled("-"); ImGui::NextColumn();
+      ImGui::TextDisabled("-"); ImGui::NextColumn();
+    }
+    ImGui::Text("%.1f KB", ToKilobytes(stats.footprintBytes)); ImGui::NextColumn();
+  }
+  ImGui::Columns(1);
+  ImGui::Separator();
+
+  const auto selectedTag = static_cast<MemoryTag>(m_SelectedTag);
+  const MemoryTagStats selectedStats = memoryTracker.GetStats(selectedTag);
+  if (selectedStats.tracked)
+  {
+    float histogram[MEMORY_HISTOGRAM_SIZE];
+    for (size_t i = 0; i < MEMORY_HISTOGRAM_SIZE; i++)
+    {
+      histogram[i] = static_cast<float>(selectedStats.histogram[i]);
+    }
+    ImGui::PlotHistogram("Allocation sizes", histogram, static_cast<int>(MEMORY_HISTOGRAM_SIZE), 0,
+      "log2 of the size", 0.0f, FLT_MAX, ImVec2(0.0f, 80.0f));
+  }
+  else
+  {
+    ImGui::TextDisabled("Allocations not recorded, footprints only");
+  }
+  for (const auto& footprint : memoryTracker.GetFootprints())
+  {
+    if (footprint.memoryTag == selectedTag)
+    {
+      ImGui::Text("%s: %.1f KB", footprint.name.c_str(), ToKilobytes(footprint.bytes));
+    }
+  }
+  ImGui::Separator();
+
+  if (const auto* componentAllocator = m_MemoryManager.GetComponentTlsfAllocator())
+  {
+    ImGui::Text("Component memory: %.1f / %.1f KB, largest free block %.1f KB, fragmentation %.2f",
+      ToKilobytes(componentAllocator->getUsedMemory()), ToKilobytes(componentAllocator->getSize()),
+      ToKilobytes(componentAllocator->getLargestFreeBlock()), componentAllocator->getFragmentation());
+  }
+  if (ImGui::Button("Dump to JSON"))
+  {
+    m_MemoryManager.WriteMemoryReport(MEMORY_REPORT_FILENAME);
+  }
+}
+
+ProfilerEditorWindow::ProfilerEditorWindow(Engine& engine): m_ProfilerFrameData(engine.GetProfilerFrameData ()), m_MemoryWindow(engine)
 {
 
 }
 void ProfilerEditorWindow::Update ()
 {
   ImGui::Begin("Stats");
+  if (ImGui::BeginTabBar("StatsTabs"))
   {
-    std::ostringstream oss;
-    oss << "FPS: "<< 1.0f/m_ProfilerFrameData.frameTotalTime.asSeconds ()<<"\n"
-    << "Fixed Update: "<<m_ProfilerFrameData.frameFixedUpdate.asMicroseconds ()<<", "<<m_ProfilerFrameData.frameFixedUpdate.asSeconds ()/m_ProfilerFrameData.frameTotalTime.asSeconds ()*100.0f<<"%\n"
-    <<"Graphics Update: "<<m_ProfilerFrameData.graphicsTime.asMicroseconds ()<<", "<<m_ProfilerFrameData.graphicsTime.asSeconds ()/m_ProfilerFrameData.frameTotalTime.asSeconds ()*100.0f;
+    if (ImGui::BeginTabItem("Profiler"))
+    {
+      std::ostringstream oss;
+      oss << "FPS: "<< 1.0f/m_ProfilerFrameData.frameTotalTime.asSeconds ()<<"\n"
+      << "Fixed Update: "<<m_ProfilerFrameData.frameFixedUpdate.asMicroseconds ()<<", "<<m_ProfilerFrameData.frameFixedUpdate.asSeconds ()/m_ProfilerFrameData.frameTotalTime.asSeconds ()*100.0f<<"%\n"
+      <<"Graphics Update: "<<m_ProfilerFrameData.graphicsTime.asMicroseconds ()<<", "<<m_ProfilerFrameData.graphicsTime.asSeconds ()/m_ProfilerFrameData.frameTotalTime.asSeconds ()*100.0f<<"%\n"
+      <<"Allocations: "<<m_ProfilerFrameData.frameAllocationNmb;
 
-    ImGui::Text("%s", oss.str().c_str());
+      ImGui::Text("%s", oss.str().c_str());
+      ImGui::EndTabItem();
+    }
+    if (ImGui::BeginTabItem("Memory"))
+    {
+      m_MemoryWindow.Draw();
+      ImGui::EndTabItem();
+    }
+    ImGui::EndTabBar();
   }
 
   ImGui::End();
@@ -0,0 +1,137 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <engine/command_buffer.h>
+
+namespace sfge
+{
+
+static thread_local size_t commandBufferIndex = 0;
+static thread_local EntityCommandBuffer* recordingCommandBuffer = nullptr;
+
+PendingEntity EntityCommandBuffer::CreateEntity()
+{
+	EntityCommand command;
+	command.type = EntityCommandType::CREATE_ENTITY;
+	command.pendingIndex = m_PendingEntityNmb;
+	m_Commands.push_back(std::move(command));
+	return PendingEntity{ m_PendingEntityNmb++ };
+}
+
+void EntityCommandBuffer::DestroyEntity(Entity entity)
+{
+	EntityCommand command;
+	command.type = EntityCommandType::DESTROY_ENTITY;
+	command.entity = entity;
+	m_Commands.push_back(std::move(command));
+}
+
+void EntityCommandBuffer::AddComponent(Entity entity, ComponentTypeId componentTypeId, const json& componentJson)
+{
+	EntityCommand command;
+	command.type = EntityCommandType::ADD_COMPONENT;
+	command.entity = entity;
+	command.componentTypeId = componentTypeId;
+	command.componentJson = componentJson;
+	m_Commands.push_back(std::move(command));
+}
+
+void EntityCommandBuffer::AddComponent(PendingEntity entity, ComponentTypeId componentTypeId, const json& componentJson)
+{
+	EntityCommand command;
+	command.type = EntityCommandType::ADD_COMPONENT;
+	command.pendingIndex = entity.index;
+	command.componentTypeId = componentTypeId;
+	command.componentJson = componentJson;
+	m_Commands.push_back(std::move(command));
+}
+
+void EntityCommandBuffer::RemoveComponent(Entity entity, ComponentTypeId componentTypeId)
+{
+	EntityCommand command;
+	command.type = EntityCommandType::REMOVE_COMPONENT;
+	command.entity = entity;
+	command.componentTypeId = componentTypeId;
+	m_Commands.push_back(std::move(command));
+}
+
+void EntityCommandBuffer::Append(EntityCommandBuffer& other)
+{
+	for (auto& command : other.m_Commands)
+	{
+		if (command.entity == INVALID_ENTITY)
+			command.pendingIndex += m_PendingEntityNmb;
+		m_Commands.push_back(std::move(command));
+	}
+	m_PendingEntityNmb += other.m_PendingEntityNmb;
+	other.Clear();
+}
+
+std::vector<EntityCommand>& EntityCommandBuffer::GetCommands()
+{
+	return m_Commands;
+}
+
+size_t EntityCommandBuffer::GetPendingEntityNmb() const
+{
+	return m_PendingEntityNmb;
+}
+
+bool EntityCommandBuffer::IsEmpty() const
+{
+	return m_Commands.empty();
+}
+
+size_t EntityCommandBuffer::GetCapacity() const
+{
+	return m_Commands.capacity();
+}
+
+void EntityCommandBuffer::Clear()
+{
+	m_Commands.clear();
+	m_PendingEntityNmb = 0;
+}
+
+size_t GetCommandBufferIndex()
+{
+	return commandBufferIndex;
+}
+
+void SetCommandBufferIndex(size_t index)
+{
+	commandBufferIndex = index;
+}
+
+EntityCommandBuffer* GetRecordingCommandBuffer()
+{
+	return recordingCommandBuffer;
+}
+
+void SetRecordingCommandBuffer(EntityCommandBuffer* commandBuffer)
+{
+	recordingCommandBuffer = commandBuffer;
+}
+
+}
@@ -0,0 +1,102 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <sstream>
+
+#include <engine/component_registry.h>
+#include <engine/component.h>
+#include <utility/log.h>
+
+namespace sfge
+{
+
+ComponentTypeRegistry::ComponentTypeRegistry()
+{
+	RegisterBuiltinType("Transform2d", ComponentType::TRANSFORM2D);
+	RegisterBuiltinType("Sprite", ComponentType::SPRITE2D);
+	RegisterBuiltinType("Shape", ComponentType::SHAPE2D);
+	RegisterBuiltinType("Body", ComponentType::BODY2D);
+	RegisterBuiltinType("Collider", ComponentType::COLLIDER2D);
+	RegisterBuiltinType("Sound", ComponentType::SOUND);
+	RegisterBuiltinType("PyComponent", ComponentType::PYCOMPONENT);
+	RegisterBuiltinType("Animation2d", ComponentType::ANIMATION2D);
+}
+
+void ComponentTypeRegistry::RegisterBuiltinType(const std::string& typeName, ComponentType componentType)
+{
+	const ComponentTypeId typeId = GetComponentTypeId(componentType);
+	if (m_TypeNames.size() <= typeId)
+	{
+		m_TypeNames.resize(typeId + 1);
+	}
+	m_TypeNames[typeId] = typeName;
+	m_TypeIds[typeName] = typeId;
+}
+
+ComponentTypeId ComponentTypeRegistry::RegisterType(const std::string& typeName)
+{
+	const auto typeIt = m_TypeIds.find(typeName);
+	if (typeIt != m_TypeIds.end())
+	{
+		return typeIt->second;
+	}
+	if (m_TypeNames.size() >= MAX_COMPONENT_TYPES)
+	{
+		std::ostringstream oss;
+		oss << "[Error] Cannot register component type: " << typeName << ", the " << MAX_COMPONENT_TYPES << " component types are used";
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_COMPONENT_TYPE_ID;
+	}
+	const auto typeId = static_cast<ComponentTypeId>(m_TypeNames.size());
+	m_TypeNames.push_back(typeName);
+	m_TypeIds[typeName] = typeId;
+	return typeId;
+}
+
+ComponentTypeId ComponentTypeRegistry::GetTypeId(const std::string& typeName) const
+{
+	const auto typeIt = m_TypeIds.find(typeName);
+	if (typeIt == m_TypeIds.end())
+	{
+		return INVALID_COMPONENT_TYPE_ID;
+	}
+	return typeIt->second;
+}
+
+const std::string& ComponentTypeRegistry::GetTypeName(ComponentTypeId typeId) const
+{
+	static const std::string unknownTypeName;
+	if (typeId >= m_TypeNames.size())
+	{
+		return unknownTypeName;
+	}
+	return m_TypeNames[typeId];
+}
+
+size_t ComponentTypeRegistry::GetTypeNmb() const
+{
+	return m_TypeNames.size();
+}
+
+}
@@ -66,10 +66,20 @@ std::unique_ptr<Configuration> Configuration::LoadConfig(json& configJson)
 			configJson["gravity"]["y"]
 		);
 	}
+	if (CheckJsonExists(configJson, "broadPhaseType"))
+	{
+		newConfig->broadPhaseType = static_cast<p2BroadPhaseType>(configJson["broadPhaseType"]);
+	}
 	newConfig->maxFramerate = configJson["maxFramerate"];
 
 	if(CheckJsonExists(configJson, "devMode"))
 		newConfig->devMode = configJson["devMode"];
+	if(CheckJsonExists(configJson, "componentMemorySize"))
+		newConfig->componentMemorySize = configJson["componentMemorySize"];
+	if(CheckJsonExists(configJson, "frameArenaSize"))
+		newConfig->frameArenaSize = configJson["frameArenaSize"];
+	if(CheckJsonExists(configJson, "memoryReportFilename"))
+		newConfig->memoryReportFilename = configJson["memoryReportFilename"].get<std::string>();
 	return newConfig;
 }
 
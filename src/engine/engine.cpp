@@ -127,6 +127,11 @@ void Engine::InitModules()
         Log::GetInstance ()->Msg (oss.str ());
     }
     m_ThreadPool.resize(std::thread::hardware_concurrency ()-1);
+	if (m_Config != nullptr)
+	{
+		m_MemoryManager.Init(m_Config->componentMemorySize);
+		m_MemoryManager.InitFrameArenas(m_ThreadPool.size() + 1, m_Config->frameArenaSize);
+	}
 
 	m_SystemsContainer->entityManager.OnEngineInit();
 	m_SystemsContainer->transformManager.OnEngineInit();
@@ -138,6 +143,20 @@ void Engine::InitModules()
 	m_SystemsContainer->physicsManager.OnEngineInit();
 	m_SystemsContainer->editor.OnEngineInit();
 
+	//Serial order of the update, systems only run concurrently when their component access does not conflict
+	m_UpdateScheduler.Clear();
+	m_UpdateScheduler.AddSystem(&m_SystemsContainer->pythonEngine);
+	m_UpdateScheduler.AddSystem(&m_SystemsContainer->sceneManager);
+	m_UpdateScheduler.AddSystem(&m_SystemsContainer->editor);
+	m_UpdateScheduler.AddSystem(&m_SystemsContainer->audioManager);
+	m_UpdateScheduler.AddSystem(&m_SystemsContainer->transformManager);
+	m_UpdateScheduler.AddSystem(&m_SystemsContainer->graphics2dManager);
+	m_UpdateScheduler.AddSystem(m_SystemsContainer->graphics2dManager.GetSpriteManager());
+	m_UpdateScheduler.AddSystem(m_SystemsContainer->graphics2dManager.GetShapeManager());
+	//The window clear declares no component, it keeps its serial place after the editor
+	m_UpdateScheduler.AddDependency(&m_SystemsContainer->editor, &m_SystemsContainer->graphics2dManager);
+	m_UpdateScheduler.Build();
+
 	m_Window = m_SystemsContainer->graphics2dManager.GetWindow();
 	running = true;
 }
@@ -158,6 +177,7 @@ void Engine::Start()
 
 		rmt_ScopedOpenGLSample(SFGE_Frame_GL);
 		rmt_ScopedCPUSample(SFGE_Frame,0)
+		ResetFrameAllocationNmb();
 
 		bool isFixedUpdateFrame = false;
 		sf::Event event{};
@@ -197,13 +217,8 @@ void Engine::Start()
 			m_FrameData.frameFixedUpdate = deltaFixedUpdateTime;
 			isFixedUpdateFrame = true;
 		}
-		m_SystemsContainer->pythonEngine.OnUpdate(dt.asSeconds());
-
-		m_SystemsContainer->sceneManager.OnUpdate(dt.asSeconds());
-
-		m_SystemsContainer->editor.OnUpdate(dt.asSeconds());
-        m_SystemsContainer->transformManager.OnUpdate(dt.asSeconds());
-		m_SystemsContainer->graphics2dManager.OnUpdate(dt.asSeconds());
+		m_UpdateScheduler.Update(dt.asSeconds(), m_ThreadPool, &m_SystemsContainer->entityManager.GetCommandBuffer());
+		m_SystemsContainer->entityManager.ApplyCommandBuffers();
 
 
 
@@ -224,6 +239,9 @@ void Engine::Start()
 			m_FrameData.frameTotalTime = dt;
 		}
 		m_DeltaTime = dt.asSeconds();
+		m_FrameData.frameAllocationNmb = GetFrameAllocationNmb();
+		//The jobs of the frame are done, their temporaries can go
+		m_MemoryManager.SwapFrameArenas();
 	}
 
 	rmt_UnbindOpenGL();
@@ -232,6 +250,10 @@ void Engine::Start()
 
 void Engine::Destroy() 
 {
+	if (m_Config != nullptr && !m_Config->memoryReportFilename.empty())
+	{
+		m_MemoryManager.WriteMemoryReport(m_Config->memoryReportFilename);
+	}
 
 	m_SystemsContainer->pythonEngine.Destroy();
 	m_SystemsContainer->entityManager.Destroy();
@@ -248,6 +270,7 @@ void Engine::Destroy()
 void Engine::Clear() 
 {
 	m_SystemsContainer->entityManager.OnBeforeSceneLoad();
+	m_SystemsContainer->transformManager.OnBeforeSceneLoad();
 	m_SystemsContainer->graphics2dManager.OnBeforeSceneLoad();
 	m_SystemsContainer->audioManager.OnBeforeSceneLoad();
 	m_SystemsContainer->sceneManager.OnBeforeSceneLoad();
@@ -261,6 +284,7 @@ void Engine::Collect()
 {
 
 	m_SystemsContainer->entityManager.OnAfterSceneLoad();
+	m_SystemsContainer->transformManager.OnAfterSceneLoad();
 	m_SystemsContainer->graphics2dManager.OnAfterSceneLoad();
 	m_SystemsContainer->audioManager.OnAfterSceneLoad();
 	m_SystemsContainer->sceneManager.OnAfterSceneLoad();
@@ -271,6 +295,42 @@ void Engine::Collect()
 }
 
 
+void Engine::SaveSnapshot(WorldSnapshot& snapshot)
+{
+	rmt_ScopedCPUSample(SaveSnapshot, 0);
+	snapshot.Clear();
+	m_SystemsContainer->entityManager.SaveSnapshot(snapshot);
+	m_SystemsContainer->transformManager.SaveSnapshot(snapshot);
+	m_SystemsContainer->physicsManager.GetBodyManager()->SaveSnapshot(snapshot);
+	m_SystemsContainer->graphics2dManager.GetSpriteManager()->SaveSnapshot(snapshot);
+}
+
+bool Engine::RestoreSnapshot(const WorldSnapshot& snapshot)
+{
+	rmt_ScopedCPUSample(RestoreSnapshot, 0);
+	//Check every section first so a truncated or mismatching snapshot leaves the world untouched
+	auto checkReader = snapshot.GetReader();
+	size_t entityNmb = 0;
+	const bool valid = m_SystemsContainer->entityManager.CheckSnapshot(checkReader, entityNmb) &&
+		m_SystemsContainer->transformManager.CheckSnapshot(checkReader, entityNmb) &&
+		m_SystemsContainer->physicsManager.GetBodyManager()->CheckSnapshot(checkReader, entityNmb) &&
+		m_SystemsContainer->graphics2dManager.GetSpriteManager()->CheckSnapshot(checkReader, entityNmb) &&
+		checkReader.IsAtEnd();
+	auto reader = snapshot.GetReader();
+	//Same order as SaveSnapshot, the entities first so the destroyed ones are cleaned up before the components are restored
+	const bool restored = valid &&
+		m_SystemsContainer->entityManager.RestoreSnapshot(reader) &&
+		m_SystemsContainer->transformManager.RestoreSnapshot(reader) &&
+		m_SystemsContainer->physicsManager.GetBodyManager()->RestoreSnapshot(reader) &&
+		m_SystemsContainer->graphics2dManager.GetSpriteManager()->RestoreSnapshot(reader) &&
+		reader.IsAtEnd();
+	if (!restored)
+	{
+		Log::GetInstance()->Error("Snapshot does not match the current world");
+	}
+	return restored;
+}
+
 Configuration * Engine::GetConfig() const
 {
 	return m_Config.get();
@@ -317,6 +377,11 @@ Transform2dManager* Engine::GetTransform2dManager()
 	return m_SystemsContainer ? &m_SystemsContainer->transformManager : nullptr;
 }
 
+MemoryManager* Engine::GetMemoryManager()
+{
+	return &m_MemoryManager;
+}
+
 Editor* Engine::GetEditor() 
 {
 	return m_SystemsContainer ? &m_SystemsContainer->editor : nullptr;
@@ -22,11 +22,16 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+
 #include <engine/engine.h>
 #include <engine/config.h>
 #include <engine/entity.h>
 #include <engine/globals.h>
 #include <python/python_engine.h>
+#include <utility/log.h>
+#include <engine/scene.h>
+#include <Remotery.h>
 
 namespace sfge
 {
@@ -35,19 +40,139 @@ void editor::EntityInfo::DrawOnInspector()
 
 }
 
+EntityView::EntityView(EntityMask mask) : m_Mask(mask), m_Indexes(INIT_ENTITY_NMB, -1)
+{
+}
+
+EntityMask EntityView::GetMask() const
+{
+	return m_Mask;
+}
+
+bool EntityView::Match(EntityMask entityMask) const
+{
+	return m_Mask.Any() && m_Mask.IsSubsetOf(entityMask);
+}
+
+bool EntityView::Contains(Entity entity) const
+{
+	const Entity entityIndex = GetEntityIndex(entity);
+	//A stale handle of a reused slot is not in the view
+	return entityIndex != INVALID_ENTITY && entityIndex <= m_Indexes.size() && m_Indexes[entityIndex - 1] != -1 &&
+		m_Entities[m_Indexes[entityIndex - 1]] == entity;
+}
+
+size_t EntityView::Size() const
+{
+	return m_Entities.size();
+}
+
+const std::vector<Entity>& EntityView::GetEntities() const
+{
+	return m_Entities;
+}
+
+std::vector<Entity>::const_iterator EntityView::begin() const
+{
+	return m_Entities.cbegin();
+}
+
+std::vector<Entity>::const_iterator EntityView::end() const
+{
+	return m_Entities.cend();
+}
+
+void EntityView::Insert(Entity entity)
+{
+	if (Contains(entity))
+		return;
+	const Entity entityIndex = GetEntityIndex(entity);
+	if (entityIndex > m_Indexes.size())
+	{
+		m_Indexes.resize(entityIndex, -1);
+	}
+	m_Indexes[entityIndex - 1] = static_cast<int>(m_Entities.size());
+	m_Entities.push_back(entity);
+}
+
+void EntityView::Remove(Entity entity)
+{
+	if (!Contains(entity))
+		return;
+	const int index = m_Indexes[GetEntityIndex(entity) - 1];
+	const Entity lastEntity = m_Entities.back();
+	m_Entities[index] = lastEntity;
+	m_Indexes[GetEntityIndex(lastEntity) - 1] = index;
+	m_Entities.pop_back();
+	m_Indexes[GetEntityIndex(entity) - 1] = -1;
+}
+
+void EntityView::Clear()
+{
+	m_Entities.clear();
+	std::fill(m_Indexes.begin(), m_Indexes.end(), -1);
+}
+
+void EntityView::Resize(size_t newSize)
+{
+	m_Indexes.resize(newSize, -1);
+}
+
 void EntityManager::OnEngineInit()
 {
 	OnBeforeSceneLoad();
+	//One buffer for the main thread and one per worker of the thread pool
+	m_CommandBuffers.resize(m_Engine.GetThreadPool().size() + 1);
+	m_Engine.GetMemoryManager()->AddMemoryReporter(this);
+}
+
+void EntityManager::ReportMemory(MemoryTracker& memoryTracker) const
+{
+	size_t commandBufferBytes = GetContainerFootprint(m_CommandBuffers);
+	for (auto& commandBuffer : m_CommandBuffers)
+	{
+		commandBufferBytes += commandBuffer.GetCapacity() * sizeof(EntityCommand);
+	}
+	memoryTracker.ReportFootprint(MemoryTag::ENTITIES, "Entities",
+		GetContainerFootprint(m_MaskArray) + GetContainerFootprint(m_Generations) +
+		m_AliveEntities.capacity() / 8 + m_InFreeEntities.capacity() / 8 + GetContainerFootprint(m_FreeEntities));
+	memoryTracker.ReportFootprint(MemoryTag::ENTITIES, "Entity command buffers", commandBufferBytes);
+	memoryTracker.ReportFootprint(MemoryTag::EDITOR, "Entity names",
+		GetContainerFootprint(m_EntityNames) + m_NamedEntities.size() * sizeof(std::pair<StringId, std::pair<Entity, size_t>>));
+	memoryTracker.ReportFootprint(MemoryTag::EDITOR, "Entity infos", GetContainerFootprint(m_EntityInfos));
 }
 
 void EntityManager::OnBeforeSceneLoad()
 {
-	m_MaskArray = std::vector<EntityMask>(INIT_ENTITY_NMB, INVALID_ENTITY);
+	m_MaskArray = std::vector<EntityMask>(INIT_ENTITY_NMB);
+	m_Generations.resize(INIT_ENTITY_NMB, 0U);
+	m_AliveEntities.resize(INIT_ENTITY_NMB);
+	//Handles from the previous scene must not alias the new entities
+	for (auto i = 0u; i < m_AliveEntities.size(); i++)
+	{
+		if (m_AliveEntities[i])
+		{
+			m_Generations[i]++;
+			m_AliveEntities[i] = false;
+		}
+	}
+	ResetFreeEntities();
+	m_EntityNames.assign(m_AliveEntities.size(), INVALID_STRING_ID);
+	m_NamedEntities.clear();
+	for (auto& entityInfo : m_EntityInfos)
+	{
+		entityInfo.name.clear();
+	}
+	//Views are kept alive as systems hold references to them
+	for (auto& view : m_Views)
+	{
+		view->Clear();
+	}
 }
 
 EntityMask EntityManager::GetMask(Entity entity)
 {
-	return m_MaskArray[entity-1];
+	return m_MaskArray[GetEntityIndex(entity) - 1];
 }
 
 Entity EntityManager::CreateEntity(Entity wantedEntity)
@@ -55,76 +180,393 @@ Entity EntityManager::CreateEntity(Entity wantedEntity)
 
     if(wantedEntity == INVALID_ENTITY)
     {
-        for (Entity entity = 1U; entity <= m_MaskArray.size(); entity++)
+        while (!m_FreeEntities.empty())
         {
-            if(m_MaskArray[entity-1] == INVALID_ENTITY)
+			const Entity entityIndex = m_FreeEntities.back();
+			m_FreeEntities.pop_back();
+			m_InFreeEntities[entityIndex - 1] = false;
+            if(!m_AliveEntities[entityIndex - 1])
             {
-                return entity;
+				ReserveEntity(entityIndex);
+                return GetEntity(entityIndex);
             }
         }
     }
     else
     {
-        if(m_MaskArray[wantedEntity-1] == INVALID_ENTITY)
+		const Entity entityIndex = GetEntityIndex(wantedEntity);
+        if(entityIndex <= m_AliveEntities.size() && !m_AliveEntities[entityIndex - 1])
         {
-			{
-				std::ostringstream oss;
-				oss << "Entity: " << wantedEntity;
-				m_EntityInfos[wantedEntity - 1].name = oss.str();
-			}
-        	return wantedEntity;
+			ReserveEntity(entityIndex);
+        	return GetEntity(entityIndex);
         }
     }
 	return INVALID_ENTITY;
 }
 
+std::vector<Entity> EntityManager::CreateEntities(size_t count)
+{
+	const auto freeNmb = static_cast<size_t>(std::count(m_AliveEntities.begin(), m_AliveEntities.end(), false));
+	if (freeNmb < count)
+	{
+		ResizeEntityNmb(m_AliveEntities.size() + count - freeNmb);
+	}
+	std::vector<Entity> entities;
+	entities.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		entities.push_back(CreateEntity(INVALID_ENTITY));
+	}
+	return entities;
+}
+
 void EntityManager::DestroyEntity(Entity entity)
 {
+	if (!IsEntityValid(entity))
+	{
+		std::ostringstream oss;
+		oss << "[Error] Trying to destroy invalid or stale entity: " << GetEntityIndex(entity) << " generation: " << GetEntityGeneration(entity);
+		Log::GetInstance()->Error(oss.str());
+		return;
+	}
     for(auto& destroyObserver : m_DestroyObservers)
 	{
     	destroyObserver->OnDestroy(entity);
 	}
-	m_MaskArray[entity-1] = INVALID_ENTITY;
+	ReleaseEntity(entity);
+}
+
+void EntityManager::DestroyEntities(const std::vector<Entity>& entities)
+{
+	rmt_ScopedCPUSample(DestroyEntities, 0);
+	m_DestroyedEntities.clear();
+	for (const Entity entity : entities)
+	{
+		if (IsEntityValid(entity))
+		{
+			m_DestroyedEntities.push_back(entity);
+		}
+	}
+	std::sort(m_DestroyedEntities.begin(), m_DestroyedEntities.end(), [](Entity lhs, Entity rhs)
+	{
+		return GetEntityIndex(lhs) < GetEntityIndex(rhs);
+	});
+	m_DestroyedEntities.erase(std::unique(m_DestroyedEntities.begin(), m_DestroyedEntities.end()), m_DestroyedEntities.end());
+	if (m_DestroyedEntities.empty())
+		return;
+	for (auto& destroyObserver : m_DestroyObservers)
+	{
+		destroyObserver->OnDestroyEntities(m_DestroyedEntities);
+	}
+	//Highest index first so the lowest one ends on top of the free stack
+	for (auto entityIt = m_DestroyedEntities.rbegin(); entityIt != m_DestroyedEntities.rend(); ++entityIt)
+	{
+		ReleaseEntity(*entityIt);
+	}
+}
+
+void EntityManager::ReleaseEntity(Entity entity)
+{
+	const Entity entityIndex = GetEntityIndex(entity);
+	UpdateViews(entity, m_MaskArray[entityIndex - 1], EntityMask());
+	m_MaskArray[entityIndex - 1] = EntityMask();
+	RemoveEntityName(entityIndex);
+	m_AliveEntities[entityIndex - 1] = false;
+	m_Generations[entityIndex - 1]++;
+	if (!m_InFreeEntities[entityIndex - 1])
+	{
+		m_FreeEntities.push_back(entityIndex);
+		m_InFreeEntities[entityIndex - 1] = true;
+	}
+}
+
+bool EntityManager::IsEntityValid(Entity entity) const
+{
+	const Entity entityIndex = GetEntityIndex(entity);
+	return entityIndex != INVALID_ENTITY &&
+		entityIndex <= m_AliveEntities.size() &&
+		m_AliveEntities[entityIndex - 1] &&
+		GetEntityGeneration(entity) == (m_Generations[entityIndex - 1] & ENTITY_GENERATION_MASK);
+}
+
+Entity EntityManager::GetEntity(Entity entityIndex) const
+{
+	entityIndex = GetEntityIndex(entityIndex);
+	return MakeEntity(entityIndex, m_Generations[entityIndex - 1]);
+}
+
+void EntityManager::ReserveEntity(Entity entityIndex)
+{
+	m_AliveEntities[entityIndex - 1] = true;
+}
+
+void EntityManager::ResetFreeEntities()
+{
+	m_FreeEntities.clear();
+	m_InFreeEntities.assign(m_AliveEntities.size(), false);
+	//Pushed in reverse so the lowest free index is created first
+	for (auto entityIndex = static_cast<Entity>(m_AliveEntities.size()); entityIndex > 0; entityIndex--)
+	{
+		if (!m_AliveEntities[entityIndex - 1])
+		{
+			m_FreeEntities.push_back(entityIndex);
+			m_InFreeEntities[entityIndex - 1] = true;
+		}
+	}
 }
 
 bool EntityManager::HasComponent(Entity entity, ComponentType componentType)
 {
-	return (m_MaskArray[entity - 1] & static_cast<int>(componentType)) == static_cast<int>(componentType);
+	return HasComponent(entity, GetComponentTypeId(componentType));
+}
+
+bool EntityManager::HasComponent(Entity entity, ComponentTypeId componentTypeId)
+{
+	return m_MaskArray[GetEntityIndex(entity) - 1].Test(componentTypeId);
 }
 
 void EntityManager::AddComponentType(Entity entity, ComponentType componentType)
 {
+	AddComponentType(entity, GetComponentTypeId(componentType));
+}
 
-	m_MaskArray[entity - 1] = m_MaskArray[entity - 1] | static_cast<int>(componentType);
+void EntityManager::AddComponentType(Entity entity, ComponentTypeId componentTypeId)
+{
+	const Entity entityIndex = GetEntityIndex(entity);
+	const EntityMask oldMask = m_MaskArray[entityIndex - 1];
+	m_MaskArray[entityIndex - 1].Set(componentTypeId);
+	UpdateViews(entity, oldMask, m_MaskArray[entityIndex - 1]);
 }
 
 void EntityManager::RemoveComponentType(Entity entity, ComponentType componentType)
 {
-	m_MaskArray[entity - 1] &= ~static_cast<int>(componentType);
+	RemoveComponentType(entity, GetComponentTypeId(componentType));
+}
+
+void EntityManager::RemoveComponentType(Entity entity, ComponentTypeId componentTypeId)
+{
+	const Entity entityIndex = GetEntityIndex(entity);
+	const EntityMask oldMask = m_MaskArray[entityIndex - 1];
+	m_MaskArray[entityIndex - 1].Reset(componentTypeId);
+	UpdateViews(entity, oldMask, m_MaskArray[entityIndex - 1]);
+}
+
+ComponentTypeRegistry& EntityManager::GetComponentTypeRegistry()
+{
+	return m_ComponentTypeRegistry;
+}
+
+EntityCommandBuffer& EntityManager::GetCommandBuffer()
+{
+	if (auto* commandBuffer = GetRecordingCommandBuffer())
+		return *commandBuffer;
+	return m_CommandBuffers[GetCommandBufferIndex()];
+}
+
+void EntityManager::ApplyCommandBuffers()
+{
+	rmt_ScopedCPUSample(ApplyEntityCommands, 0);
+	auto* sceneManager = m_Engine.GetSceneManager();
+	for (auto& commandBuffer : m_CommandBuffers)
+	{
+		if (commandBuffer.IsEmpty())
+			continue;
+		m_PendingEntities.assign(commandBuffer.GetPendingEntityNmb(), INVALID_ENTITY);
+		//Consecutive destroy commands are applied as one batch
+		std::vector<Entity> destroyBatch;
+		for (auto& command : commandBuffer.GetCommands())
+		{
+			if (command.type == EntityCommandType::DESTROY_ENTITY)
+			{
+				destroyBatch.push_back(command.entity != INVALID_ENTITY ? command.entity : m_PendingEntities[command.pendingIndex]);
+				continue;
+			}
+			if (!destroyBatch.empty())
+			{
+				DestroyEntities(destroyBatch);
+				destroyBatch.clear();
+			}
+			if (command.type == EntityCommandType::CREATE_ENTITY)
+			{
+				Entity entity = CreateEntity(INVALID_ENTITY);
+				if (entity == INVALID_ENTITY)
+				{
+					ResizeEntityNmb(m_MaskArray.size() * 2);
+					entity = CreateEntity(INVALID_ENTITY);
+				}
+				m_PendingEntities[command.pendingIndex] = entity;
+				continue;
+			}
+			const Entity entity = command.entity != INVALID_ENTITY ? command.entity : m_PendingEntities[command.pendingIndex];
+			//Another command may have destroyed it already
+			if (!IsEntityValid(entity))
+				continue;
+			IComponentFactory* componentFactory = nullptr;
+			if (command.componentTypeId != INVALID_COMPONENT_TYPE_ID)
+				componentFactory = sceneManager->GetComponentFactory(command.componentTypeId);
+			switch (command.type)
+			{
+			case EntityCommandType::ADD_COMPONENT:
+				if (componentFactory != nullptr)
+					componentFactory->CreateComponent(command.componentJson, entity);
+				AddComponentType(entity, command.componentTypeId);
+				break;
+			case EntityCommandType::REMOVE_COMPONENT:
+				if (componentFactory != nullptr)
+					componentFactory->DestroyComponent(entity);
+				RemoveComponentType(entity, command.componentTypeId);
+				break;
+			default:
+				break;
+			}
+		}
+		if (!destroyBatch.empty())
+		{
+			DestroyEntities(destroyBatch);
+		}
+		commandBuffer.Clear();
+	}
+}
+
+void EntityManager::UpdateViews(Entity entity, EntityMask oldMask, EntityMask newMask)
+{
+	if (oldMask == newMask)
+		return;
+	//Views always store the current handle, even when called with an old-style index
+	entity = GetEntity(entity);
+	for (auto& view : m_Views)
+	{
+		const bool oldMatch = view->Match(oldMask);
+		const bool newMatch = view->Match(newMask);
+		if (!oldMatch && newMatch)
+		{
+			view->Insert(entity);
+		}
+		else if (oldMatch && !newMatch)
+		{
+			view->Remove(entity);
+		}
+	}
 }
 
 editor::EntityInfo& EntityManager::GetEntityInfo(Entity entity)
 {
-	return m_EntityInfos[entity - 1];
+	if (m_EntityInfos.size() < m_MaskArray.size())
+	{
+		const size_t oldSize = m_EntityInfos.size();
+		m_EntityInfos.resize(m_MaskArray.size());
+		for (size_t i = oldSize; i < m_EntityInfos.size(); i++)
+		{
+			m_EntityInfos[i].SetEntity(static_cast<Entity>(i + 1));
+			m_EntityInfos[i].name = m_EntityNameInterner.GetString(m_EntityNames[i]);
+		}
+	}
+	return m_EntityInfos[GetEntityIndex(entity) - 1];
 }
 
-Entity EntityManager::GetEntityByName(std::string entityName) const
+void EntityManager::SetEntityName(Entity entity, const std::string& entityName)
 {
-	const auto entityNmb = m_EntityInfos.size();
-	for(int i = 0; i < entityNmb; i++)
+	const Entity entityIndex = GetEntityIndex(entity);
+	RemoveEntityName(entityIndex);
+	if (!entityName.empty())
 	{
-		if(m_EntityInfos[i].name == entityName)
+		const StringId nameId = m_EntityNameInterner.Intern(entityName);
+		m_EntityNames[entityIndex - 1] = nameId;
+		auto namedIt = m_NamedEntities.find(nameId);
+		if (namedIt == m_NamedEntities.end())
+		{
+			m_NamedEntities.emplace(nameId, std::make_pair(entityIndex, size_t(1)));
+		}
+		else
 		{
-			return i + 1;
+			namedIt->second.first = std::min(namedIt->second.first, entityIndex);
+			namedIt->second.second++;
 		}
 	}
-	return INVALID_ENTITY;
+	if (entityIndex <= m_EntityInfos.size())
+	{
+		m_EntityInfos[entityIndex - 1].name = entityName;
+	}
+}
+
+const std::string& EntityManager::GetEntityName(Entity entity) const
+{
+	return m_EntityNameInterner.GetString(m_EntityNames[GetEntityIndex(entity) - 1]);
+}
+
+Entity EntityManager::GetEntityByName(const std::string& entityName) const
+{
+	//A name never interned cannot belong to any entity
+	const StringId nameId = m_EntityNameInterner.Find(entityName);
+	if (nameId == INVALID_STRING_ID)
+	{
+		return INVALID_ENTITY;
+	}
+	const auto namedIt = m_NamedEntities.find(nameId);
+	if (namedIt == m_NamedEntities.end())
+	{
+		return INVALID_ENTITY;
+	}
+	return GetEntity(namedIt->second.first);
+}
+
+void EntityManager::RemoveEntityName(Entity entityIndex)
+{
+	const StringId nameId = m_EntityNames[entityIndex - 1];
+	if (nameId == INVALID_STRING_ID)
+		return;
+	m_EntityNames[entityIndex - 1] = INVALID_STRING_ID;
+	if (entityIndex <= m_EntityInfos.size())
+	{
+		m_EntityInfos[entityIndex - 1].name.clear();
+	}
+	auto namedIt = m_NamedEntities.find(nameId);
+	if (--namedIt->second.second == 0)
+	{
+		m_NamedEntities.erase(namedIt);
+		return;
+	}
+	if (namedIt->second.first != entityIndex)
+		return;
+	//Only entities sharing the name of the lowest one pay for the scan
+	for (auto i = static_cast<size_t>(entityIndex); i < m_EntityNames.size(); i++)
+	{
+		if (m_EntityNames[i] == nameId)
+		{
+			namedIt->second.first = static_cast<Entity>(i + 1);
+			break;
+		}
+	}
+}
+
+void EntityManager::RebuildNameIndex()
+{
+	m_NamedEntities.clear();
+	for (size_t i = 0; i < m_EntityNames.size(); i++)
+	{
+		if (m_EntityNames[i] == INVALID_STRING_ID)
+			continue;
+		//Ascending indexes, the first one inserted is the lowest
+		auto& namedEntity = m_NamedEntities.emplace(m_EntityNames[i], std::make_pair(static_cast<Entity>(i + 1), size_t(0))).first->second;
+		namedEntity.second++;
+	}
+	for (size_t i = 0; i < m_EntityInfos.size(); i++)
+	{
+		m_EntityInfos[i].name = m_EntityNameInterner.GetString(m_EntityNames[i]);
+	}
 }
 
 void EntityManager::ResizeEntityNmb(size_t newSize)
 {
 	m_MaskArray.resize(newSize);
-	m_EntityInfos.resize(newSize);
+	m_EntityNames.resize(newSize, INVALID_STRING_ID);
+	m_Generations.resize(newSize, 0U);
+	m_AliveEntities.resize(newSize, false);
+	ResetFreeEntities();
+	for (auto& view : m_Views)
+	{
+		view->Resize(newSize);
+	}
 	for (auto* resizeObserver : m_ResizeObservers)
 	{
 		resizeObserver->OnResize(newSize);
@@ -141,21 +583,139 @@ void EntityManager::AddResizeObserver(ResizeObserver *resizeObserver)
 }
 void EntityManager::AddDestroyObserver(DestroyObserver *destroyObserver)
 {
-	m_DestroyObservers.emplace(destroyObserver);
+	if (std::find(m_DestroyObservers.begin(), m_DestroyObservers.end(), destroyObserver) == m_DestroyObservers.end())
+	{
+		m_DestroyObservers.push_back(destroyObserver);
+	}
+}
+
+void EntityManager::SaveSnapshot(WorldSnapshot& snapshot)
+{
+	const size_t entityNmb = m_MaskArray.size();
+	m_SnapshotAliveEntities.resize(entityNmb);
+	for (size_t i = 0; i < entityNmb; i++)
+	{
+		m_SnapshotAliveEntities[i] = m_AliveEntities[i] ? 1 : 0;
+	}
+	snapshot.Write(entityNmb);
+	snapshot.WriteArray(m_SnapshotAliveEntities.data(), entityNmb);
+	snapshot.WriteArray(m_Generations.data(), entityNmb);
+	snapshot.WriteArray(m_MaskArray.data(), entityNmb);
+	snapshot.WriteArray(m_EntityNames.data(), entityNmb);
 }
 
-std::vector<Entity> EntityManager::GetEntitiesWithType(ComponentType componentType)
+bool EntityManager::CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const
 {
-	std::vector<Entity> entitiesWithComponent;
-	entitiesWithComponent.reserve(m_MaskArray.size());
-	for(int i = 0; i<m_MaskArray.size();i++)
+	size_t snapshotEntityNmb = 0;
+	if (!reader.Read(snapshotEntityNmb) ||
+		!reader.SkipArray<std::uint8_t>(snapshotEntityNmb) ||
+		!reader.SkipArray<unsigned>(snapshotEntityNmb) ||
+		!reader.SkipArray<EntityMask>(snapshotEntityNmb) ||
+		!reader.SkipArray<StringId>(snapshotEntityNmb))
+		return false;
+	entityNmb = std::max(snapshotEntityNmb, m_MaskArray.size());
+	return true;
+}
+
+bool EntityManager::RestoreSnapshot(WorldSnapshot::Reader& reader)
+{
+	rmt_ScopedCPUSample(EntityRestoreSnapshot, 0);
+	//The whole section is read before the world is touched
+	size_t entityNmb = 0;
+	if (!reader.Read(entityNmb))
+		return false;
+	m_SnapshotAliveEntities.resize(entityNmb);
+	m_SnapshotGenerations.resize(entityNmb);
+	m_SnapshotMasks.resize(entityNmb);
+	m_SnapshotNames.resize(entityNmb);
+	if (!reader.ReadArray(m_SnapshotAliveEntities.data(), entityNmb) ||
+		!reader.ReadArray(m_SnapshotGenerations.data(), entityNmb) ||
+		!reader.ReadArray(m_SnapshotMasks.data(), entityNmb) ||
+		!reader.ReadArray(m_SnapshotNames.data(), entityNmb))
+		return false;
+	if (entityNmb > m_MaskArray.size())
+	{
+		ResizeEntityNmb(entityNmb);
+	}
+	//Entities that did not exist when the snapshot was taken go through the usual destruction
+	std::vector<Entity> destroyedEntities;
+	for (size_t i = 0; i < m_AliveEntities.size(); i++)
+	{
+		if (!m_AliveEntities[i])
+			continue;
+		if (i >= entityNmb || !m_SnapshotAliveEntities[i] || m_SnapshotGenerations[i] != m_Generations[i])
+		{
+			destroyedEntities.push_back(MakeEntity(static_cast<Entity>(i + 1), m_Generations[i]));
+		}
+	}
+	DestroyEntities(destroyedEntities);
+
+	//Components restored by the snapshot, or whose data is kept when the entity is destroyed (bodies and colliders).
+	//The other ones were destroyed with the entities and are not brought back
+	const EntityMask snapshotMask = static_cast<EntityMask>(ComponentType::TRANSFORM2D) |
+		static_cast<EntityMask>(ComponentType::SPRITE2D) |
+		static_cast<EntityMask>(ComponentType::BODY2D) |
+		static_cast<EntityMask>(ComponentType::COLLIDER2D);
+	for (size_t i = 0; i < entityNmb; i++)
+	{
+		//Entities alive through the restore keep their other components, the destroyed ones have an empty mask
+		m_MaskArray[i] = (m_SnapshotMasks[i] & snapshotMask) | (m_MaskArray[i] & ~snapshotMask);
+		m_EntityNames[i] = m_SnapshotNames[i];
+		const bool wasAlive = m_AliveEntities[i];
+		m_AliveEntities[i] = m_SnapshotAliveEntities[i] != 0;
+		if (wasAlive || !m_AliveEntities[i])
+		{
+			//Surviving entities already have their saved generation, free slots keep theirs
+			continue;
+		}
+		//A free slot has a generation one past the last handle given out, the saved handle is only valid again
+		//when no other entity used the slot since the snapshot
+		if (m_Generations[i] <= m_SnapshotGenerations[i] + 1)
+		{
+			m_Generations[i] = m_SnapshotGenerations[i];
+		}
+	}
+	RebuildNameIndex();
+	ResetFreeEntities();
+	for (auto& view : m_Views)
+	{
+		view->Clear();
+		for (Entity entityIndex = 1U; entityIndex <= m_MaskArray.size(); entityIndex++)
+		{
+			if (m_AliveEntities[entityIndex - 1] && view->Match(m_MaskArray[entityIndex - 1]))
+			{
+				view->Insert(GetEntity(entityIndex));
+			}
+		}
+	}
+	return true;
+}
+
+const std::vector<Entity>& EntityManager::GetEntitiesWithType(ComponentType componentType)
+{
+	return GetView(static_cast<EntityMask>(componentType)).GetEntities();
+}
+
+EntityView& EntityManager::GetView(EntityMask mask)
+{
+	for (auto& view : m_Views)
+	{
+		if (view->GetMask() == mask)
+		{
+			return *view;
+		}
+	}
+	m_Views.push_back(std::make_unique<EntityView>(mask));
+	auto& view = *m_Views.back();
+	view.Resize(m_MaskArray.size());
+	for (Entity entity = 1U; entity <= m_MaskArray.size(); entity++)
 	{
-		if(HasComponent(i+1, componentType))
+		if (view.Match(m_MaskArray[entity - 1]))
 		{
-			entitiesWithComponent.push_back(i + 1);
+			view.Insert(GetEntity(entity));
 		}
 	}
-	return entitiesWithComponent;
+	return view;
 }
 
 }
@@ -0,0 +1,142 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <new>
+
+#include <engine/frame_arena.h>
+
+namespace sfge
+{
+
+FrameArena::FrameArena(size_t bufferSize, size_t reserveSize) :
+	m_BufferSize(bufferSize),
+	m_FirstBuffer(reserveSize > bufferSize ? reserveSize : bufferSize, bufferSize),
+	m_SecondBuffer(reserveSize > bufferSize ? reserveSize : bufferSize, bufferSize),
+	m_Buffers{ &m_FirstBuffer, &m_SecondBuffer }
+{
+}
+
+FrameArena::~FrameArena()
+{
+	ClearBuffer(0);
+	ClearBuffer(1);
+}
+
+void FrameArena::SetMemoryTracker(MemoryTracker* memoryTracker)
+{
+	m_MemoryTracker = memoryTracker;
+	if (m_MemoryTracker != nullptr)
+		m_MemoryTracker->SetTagTracked(MemoryTag::FRAME);
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	//The virtual arena does not accept empty allocations
+	if (size == 0)
+		size = 1;
+	auto* buffer = m_Buffers[m_CurrentBuffer];
+	const size_t usedMemory = buffer->getUsedMemory();
+	void* p = buffer->allocate(size, static_cast<ptr_type>(alignment));
+	if (p != nullptr)
+	{
+		RecordAllocation(buffer->getUsedMemory() - usedMemory);
+		return p;
+	}
+	CountAllocation();
+	p = ::operator new(size, std::align_val_t(alignment));
+	m_Overflows[m_CurrentBuffer].push_back({ p, alignment });
+	RecordAllocation(size);
+	return p;
+}
+
+void FrameArena::Swap()
+{
+	m_CurrentBuffer = 1 - m_CurrentBuffer;
+	ClearBuffer(m_CurrentBuffer);
+}
+
+size_t FrameArena::GetBufferSize() const
+{
+	return m_BufferSize;
+}
+
+size_t FrameArena::GetUsedMemory() const
+{
+	return m_Buffers[m_CurrentBuffer]->getUsedMemory();
+}
+
+size_t FrameArena::GetCommittedMemory() const
+{
+	return m_FirstBuffer.getCommittedMemory() + m_SecondBuffer.getCommittedMemory();
+}
+
+size_t FrameArena::GetOverflowNmb() const
+{
+	return m_Overflows[m_CurrentBuffer].size();
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+	return Allocate(bytes, alignment);
+}
+
+void FrameArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	//Everything is given back at once when the buffer is cleared
+	(void) p;
+	(void) bytes;
+	(void) alignment;
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+void FrameArena::RecordAllocation(size_t size)
+{
+	if (m_MemoryTracker == nullptr)
+		return;
+	m_MemoryTracker->RecordAllocation(MemoryTag::FRAME, size);
+	m_RecordedBytes[m_CurrentBuffer] += size;
+	m_RecordedAllocationNmb[m_CurrentBuffer]++;
+}
+
+void FrameArena::ClearBuffer(size_t bufferIndex)
+{
+	if (m_MemoryTracker != nullptr && m_RecordedAllocationNmb[bufferIndex] != 0)
+	{
+		m_MemoryTracker->RecordDeallocation(MemoryTag::FRAME, m_RecordedBytes[bufferIndex], m_RecordedAllocationNmb[bufferIndex]);
+	}
+	m_RecordedBytes[bufferIndex] = 0;
+	m_RecordedAllocationNmb[bufferIndex] = 0;
+	m_Buffers[bufferIndex]->clear();
+	for (const auto& overflow : m_Overflows[bufferIndex])
+	{
+		::operator delete(overflow.p, std::align_val_t(overflow.alignment));
+	}
+	m_Overflows[bufferIndex].clear();
+}
+
+}
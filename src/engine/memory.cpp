@@ -22,11 +22,31 @@
  SOFTWARE.
  */
 
+#include <atomic>
+#include <cstdint>
+
 #include <engine/memory.h>
+#include <engine/memory_tracker.h>
 
 namespace sfge
 {
 
+static std::atomic<size_t> frameAllocationNmb{0};
+
+void CountAllocation()
+{
+    frameAllocationNmb.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t GetFrameAllocationNmb()
+{
+    return frameAllocationNmb.load(std::memory_order_relaxed);
+}
+
+void ResetFrameAllocationNmb()
+{
+    frameAllocationNmb.store(0, std::memory_order_relaxed);
+}
 
 LinearAllocator::LinearAllocator(size_t size, void* start) : Allocator(size, start), _current_pos(start) { assert(size > 0); }
 
@@ -242,6 +262,256 @@ void FreeListAllocator::deallocate(void* p)
     _used_memory -= block_size;
 }
 
+namespace
+{
+//Index of the highest set bit, -1 for 0
+int FindLastSet(std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? 63 - __builtin_clzll(x) : -1;
+#else
+    if (x == 0)
+        return -1;
+    int bit = 0;
+    for (int shift = 32; shift > 0; shift >>= 1)
+    {
+        if (x >> shift)
+        {
+            x >>= shift;
+            bit += shift;
+        }
+    }
+    return bit;
+#endif
+}
+
+//Index of the lowest set bit, -1 for 0
+int FindFirstSet(std::uint64_t x)
+{
+    return FindLastSet(x & (~x + 1));
+}
+}
+
+TlsfAllocator::TlsfAllocator(size_t size, void* start) : Allocator(size, start), _fl_bitmap(0), _sl_bitmap(), _free_memory(0)
+{
+    for (auto& firstLevel : _blocks)
+        for (auto*& head : firstLevel)
+            head = nullptr;
+
+    ptr_type adjustment = alignForwardAdjustment(start, ALIGN_SIZE);
+    assert(size > adjustment + 2 * BLOCK_OVERHEAD + MIN_BLOCK_SIZE);
+    //One block covering the whole memory followed by a used sentinel of size 0, so every block has a next one
+    size_t blockSize = (size - adjustment - 2 * BLOCK_OVERHEAD) & ~(ALIGN_SIZE - 1);
+    if (sizeof(size_t) > 4 && blockSize >> FL_INDEX_MAX)
+        blockSize = ((size_t(1) << FL_INDEX_MAX) - 1) & ~(ALIGN_SIZE - 1);
+
+    auto* block = (Block*)((ptr_type)start + adjustment);
+    block->prev_physical = nullptr;
+    block->size = blockSize;
+    Block* sentinel = nextPhysical(block);
+    sentinel->prev_physical = block;
+    sentinel->size = 0;
+    insertFreeBlock(block);
+}
+
+TlsfAllocator::~TlsfAllocator()
+{
+    _fl_bitmap = 0;
+}
+
+void TlsfAllocator::mappingInsert(size_t size, size_t& fl, size_t& sl)
+{
+    if (size < SMALL_BLOCK_SIZE)
+    {
+        fl = 0;
+        sl = size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+    }
+    else
+    {
+        const size_t lastBit = FindLastSet(size);
+        sl = (size >> (lastBit - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+        fl = lastBit - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+void TlsfAllocator::mappingSearch(size_t size, size_t& fl, size_t& sl)
+{
+    //Round up to the next list so any block found in it is big enough
+    if (size >= SMALL_BLOCK_SIZE)
+        size += (size_t(1) << (FindLastSet(size) - SL_INDEX_COUNT_LOG2)) - 1;
+    mappingInsert(size, fl, sl);
+}
+
+TlsfAllocator::Block* TlsfAllocator::searchSuitableBlock(size_t& fl, size_t& sl) const
+{
+    unsigned slMap = _sl_bitmap[fl] & (~0U << sl);
+    if (!slMap)
+    {
+        const unsigned flMap = fl + 1 < FL_INDEX_COUNT ? _fl_bitmap & (~0U << (fl + 1)) : 0U;
+        if (!flMap)
+            return nullptr;
+        fl = FindFirstSet(flMap);
+        slMap = _sl_bitmap[fl];
+    }
+    sl = FindFirstSet(slMap);
+    return _blocks[fl][sl];
+}
+
+void TlsfAllocator::insertFreeBlock(Block* block)
+{
+    size_t fl, sl;
+    const size_t size = blockSize(block);
+    mappingInsert(size, fl, sl);
+    Block* head = _blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if (head != nullptr)
+        head->prev_free = block;
+    _blocks[fl][sl] = block;
+    _fl_bitmap |= 1U << fl;
+    _sl_bitmap[fl] |= 1U << sl;
+    block->size = size | FREE_BIT;
+    _free_memory += size;
+}
+
+void TlsfAllocator::removeFreeBlock(Block* block)
+{
+    size_t fl, sl;
+    const size_t size = blockSize(block);
+    mappingInsert(size, fl, sl);
+    if (block->prev_free != nullptr)
+        block->prev_free->next_free = block->next_free;
+    if (block->next_free != nullptr)
+        block->next_free->prev_free = block->prev_free;
+    if (_blocks[fl][sl] == block)
+    {
+        _blocks[fl][sl] = block->next_free;
+        if (block->next_free == nullptr)
+        {
+            _sl_bitmap[fl] &= ~(1U << sl);
+            if (!_sl_bitmap[fl])
+                _fl_bitmap &= ~(1U << fl);
+        }
+    }
+    block->size = size;
+    _free_memory -= size;
+}
+
+TlsfAllocator::Block* TlsfAllocator::locateFreeBlock(size_t size)
+{
+    size_t fl, sl;
+    mappingSearch(size, fl, sl);
+    if (fl >= FL_INDEX_COUNT)
+        return nullptr;
+    Block* block = searchSuitableBlock(fl, sl);
+    if (block != nullptr)
+        removeFreeBlock(block);
+    return block;
+}
+
+void* TlsfAllocator::prepareUsed(Block* block, size_t size)
+{
+    if (blockSize(block) >= size + sizeof(Block))
+    {
+        auto* remaining = (Block*)((ptr_type)blockPayload(block) + size);
+        remaining->size = blockSize(block) - size - BLOCK_OVERHEAD;
+        remaining->prev_physical = block;
+        nextPhysical(remaining)->prev_physical = remaining;
+        block->size = size;
+        insertFreeBlock(remaining);
+    }
+    _used_memory += blockSize(block) + BLOCK_OVERHEAD;
+    _num_allocations++;
+    return blockPayload(block);
+}
+
+void* TlsfAllocator::allocate(size_t size, ptr_type alignment)
+{
+    assert(size != 0 && alignment != 0);
+    size = (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    if (size < MIN_BLOCK_SIZE)
+        size = MIN_BLOCK_SIZE;
+
+    if ((size_t)alignment <= ALIGN_SIZE)
+    {
+        Block* block = locateFreeBlock(size);
+        return block != nullptr ? prepareUsed(block, size) : nullptr;
+    }
+
+    //Take a block big enough to give back the unaligned front as a free block
+    Block* block = locateFreeBlock(size + alignment + sizeof(Block));
+    if (block == nullptr)
+        return nullptr;
+    const auto payload = (ptr_type)blockPayload(block);
+    auto aligned = (ptr_type)alignForward((void*)payload, alignment);
+    if (aligned != payload && (size_t)(aligned - payload) < sizeof(Block))
+        aligned = (ptr_type)alignForward((void*)(payload + sizeof(Block)), alignment);
+    const size_t gap = aligned - payload;
+    if (gap != 0)
+    {
+        Block* alignedBlock = payloadBlock((void*)aligned);
+        alignedBlock->size = blockSize(block) - gap;
+        alignedBlock->prev_physical = block;
+        nextPhysical(alignedBlock)->prev_physical = alignedBlock;
+        block->size = gap - BLOCK_OVERHEAD;
+        insertFreeBlock(block);
+        block = alignedBlock;
+    }
+    void* p = prepareUsed(block, size);
+    assert(alignForwardAdjustment(p, alignment) == 0);
+    return p;
+}
+
+void TlsfAllocator::deallocate(void* p)
+{
+    assert(p != nullptr);
+    Block* block = payloadBlock(p);
+    assert(!isFree(block));
+    _used_memory -= blockSize(block) + BLOCK_OVERHEAD;
+    _num_allocations--;
+
+    //Merge with the free neighbours, two free blocks are never next to each other
+    Block* prev = block->prev_physical;
+    if (prev != nullptr && isFree(prev))
+    {
+        removeFreeBlock(prev);
+        prev->size += BLOCK_OVERHEAD + blockSize(block);
+        block = prev;
+        nextPhysical(block)->prev_physical = block;
+    }
+    Block* next = nextPhysical(block);
+    if (isFree(next))
+    {
+        removeFreeBlock(next);
+        block->size += BLOCK_OVERHEAD + blockSize(next);
+        nextPhysical(block)->prev_physical = block;
+    }
+    insertFreeBlock(block);
+}
+
+size_t TlsfAllocator::getLargestFreeBlock() const
+{
+    if (!_fl_bitmap)
+        return 0;
+    //Only the highest non-empty list can hold the largest block
+    const int fl = FindLastSet(_fl_bitmap);
+    const int sl = FindLastSet(_sl_bitmap[fl]);
+    size_t largest = 0;
+    for (const Block* block = _blocks[fl][sl]; block != nullptr; block = block->next_free)
+    {
+        if (blockSize(block) > largest)
+            largest = blockSize(block);
+    }
+    return largest;
+}
+
+float TlsfAllocator::getFragmentation() const
+{
+    if (_free_memory == 0)
+        return 0.0f;
+    return 1.0f - float(getLargestFreeBlock()) / float(_free_memory);
+}
+
 PoolAllocator::PoolAllocator(size_t objectSize, ptr_type objectAlignment, size_t size, void* mem) : Allocator(size, mem), _objectSize(objectSize), _objectAlignment(objectAlignment)
 {
     assert(objectSize >= sizeof(void*));
@@ -250,12 +520,17 @@ PoolAllocator::PoolAllocator(size_t objectSize, ptr_type objectAlignment, size_t
     ptr_type adjustment = alignForwardAdjustment(mem, objectAlignment);
     _free_list = (void**)((ptr_type)mem + adjustment);
     size_t numObjects = (size-adjustment)/objectSize;
+    if(numObjects == 0)
+    {
+        _free_list = nullptr;
+        return;
+    }
     void** p = _free_list;
 
-    //Initialize free blocks list 
+    //Initialize free blocks list, objectSize is in bytes
     for(size_t i = 0; i < numObjects-1; i++)
     {
-        *p = (p + objectSize );
+        *p = (void*)((ptr_type)p + objectSize);
         p = (void**) *p;
     }
 
@@ -286,6 +561,68 @@ void PoolAllocator::deallocate(void* p)
     _num_allocations--;
 }
 
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(size_t objectSize, ptr_type objectAlignment, size_t size, void* mem) :
+    Allocator(size, mem), _objectSize(objectSize), _objectAlignment(objectAlignment), _head(0), _allocation_nmb(0)
+{
+    assert(objectSize >= sizeof(Link) && objectSize % alignof(Link) == 0 && objectSize % objectAlignment == 0);
+
+    ptr_type adjustment = alignForwardAdjustment(mem, objectAlignment < (ptr_type)alignof(Link) ? alignof(Link) : objectAlignment);
+    _first_slot = (void*)((ptr_type)mem + adjustment);
+    _object_nmb = size > size_t(adjustment) ? (size - adjustment) / objectSize : 0;
+    assert(_object_nmb < 0xFFFFFFFFu);
+
+    for (size_t i = 1; i <= _object_nmb; i++)
+    {
+        new(slotLink(std::uint32_t(i))) Link(std::uint32_t(i < _object_nmb ? i + 1 : 0));
+    }
+    _head.store(_object_nmb > 0 ? 1 : 0, std::memory_order_release);
+}
+
+ConcurrentPoolAllocator::~ConcurrentPoolAllocator()
+{
+    assert(_allocation_nmb.load() == 0);
+    _first_slot = nullptr;
+}
+
+void* ConcurrentPoolAllocator::allocate(size_t size, ptr_type alignment)
+{
+    assert(size == _objectSize && alignment == _objectAlignment);
+    std::uint64_t head = _head.load(std::memory_order_acquire);
+    std::uint32_t index;
+    while (true)
+    {
+        index = std::uint32_t(head);
+        if (index == 0)
+            return nullptr;
+        //The slot may be popped and written by another thread meanwhile, the tag then makes the CAS fail
+        const std::uint32_t next = slotLink(index)->load(std::memory_order_relaxed);
+        const std::uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+        if (_head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+            break;
+    }
+    _allocation_nmb.fetch_add(1, std::memory_order_relaxed);
+    return (void*)slotLink(index);
+}
+
+void ConcurrentPoolAllocator::deallocate(void* p)
+{
+    assert(p != nullptr);
+    const auto offset = (ptr_type)p - (ptr_type)_first_slot;
+    assert(offset >= 0 && size_t(offset) % _objectSize == 0 && size_t(offset) / _objectSize < _object_nmb);
+    const auto index = std::uint32_t(size_t(offset) / _objectSize + 1);
+
+    //Links are constructed once by the constructor, a stale pop may still read this one
+    Link* link = slotLink(index);
+    std::uint64_t head = _head.load(std::memory_order_relaxed);
+    std::uint64_t newHead;
+    do
+    {
+        link->store(std::uint32_t(head), std::memory_order_relaxed);
+        newHead = (((head >> 32) + 1) << 32) | index;
+    } while (!_head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+    _allocation_nmb.fetch_sub(1, std::memory_order_relaxed);
+}
+
 ProxyAllocator::ProxyAllocator(Allocator& allocator) : Allocator(allocator.getSize(), allocator.getStart()), _allocator(allocator) { }
 
 ProxyAllocator::~ProxyAllocator() { }
@@ -293,10 +630,11 @@ ProxyAllocator::~ProxyAllocator() { }
 void* ProxyAllocator::allocate(size_t size, ptr_type alignment)
 {
     assert(size != 0);
-    _num_allocations++;
     size_t mem = _allocator.getUsedMemory();
 
     void* p = _allocator.allocate(size, alignment);
+    if (p != nullptr)
+        _num_allocations++;
     _used_memory += _allocator.getUsedMemory() - mem;
     return p;
 }
@@ -309,4 +647,28 @@ void ProxyAllocator::deallocate(void* p)
     _used_memory -= mem - _allocator.getUsedMemory();
 }
 
+TrackingAllocator::TrackingAllocator(Allocator& allocator, MemoryTracker& memoryTracker, MemoryTag memoryTag) :
+    ProxyAllocator(allocator), _memory_tracker(memoryTracker), _memory_tag(memoryTag)
+{
+    _memory_tracker.SetTagTracked(_memory_tag);
+}
+
+TrackingAllocator::~TrackingAllocator() { }
+
+void* TrackingAllocator::allocate(size_t size, ptr_type alignment)
+{
+    size_t mem = _used_memory;
+    void* p = ProxyAllocator::allocate(size, alignment);
+    if (p != nullptr)
+        _memory_tracker.RecordAllocation(_memory_tag, _used_memory - mem);
+    return p;
+}
+
+void TrackingAllocator::deallocate(void* p)
+{
+    size_t mem = _used_memory;
+    ProxyAllocator::deallocate(p);
+    _memory_tracker.RecordDeallocation(_memory_tag, mem - _used_memory);
+}
+
 }
\ No newline at end of file
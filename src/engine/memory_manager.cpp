@@ -0,0 +1,155 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <algorithm>
+#include <fstream>
+
+#include <engine/memory_manager.h>
+#include <engine/command_buffer.h>
+#include <engine/globals.h>
+#include <utility/log.h>
+
+namespace sfge
+{
+
+MemoryManager::~MemoryManager()
+{
+	m_FrameArenas.clear();
+	m_TrackedComponentAllocator = nullptr;
+	m_ComponentAllocator = nullptr;
+	m_ComponentMemory = nullptr;
+}
+
+void MemoryManager::Init(size_t componentMemorySize)
+{
+	if (m_TrackedComponentAllocator != nullptr && m_TrackedComponentAllocator->getNumAllocations() != 0)
+	{
+		Log::GetInstance()->Error("Cannot resize the component memory while components use it");
+		return;
+	}
+	m_TrackedComponentAllocator = nullptr;
+	m_ComponentAllocator = nullptr;
+	m_ComponentMemory = std::make_unique<char[]>(componentMemorySize);
+	m_ComponentAllocator = std::make_unique<TlsfAllocator>(componentMemorySize, m_ComponentMemory.get());
+	m_TrackedComponentAllocator = std::make_unique<TrackingAllocator>(*m_ComponentAllocator, m_MemoryTracker, MemoryTag::COMPONENTS);
+}
+
+Allocator* MemoryManager::GetComponentAllocator()
+{
+	return m_TrackedComponentAllocator.get();
+}
+
+const TlsfAllocator* MemoryManager::GetComponentTlsfAllocator() const
+{
+	return m_ComponentAllocator.get();
+}
+
+void MemoryManager::InitFrameArenas(size_t threadNmb, size_t frameArenaSize)
+{
+	m_FrameArenas.clear();
+	for (size_t i = 0; i < threadNmb; i++)
+	{
+		m_FrameArenas.push_back(std::make_unique<FrameArena>(frameArenaSize));
+		m_FrameArenas.back()->SetMemoryTracker(&m_MemoryTracker);
+	}
+}
+
+FrameArena& MemoryManager::GetFrameArena()
+{
+	return GetFrameArena(GetCommandBufferIndex());
+}
+
+FrameArena& MemoryManager::GetFrameArena(size_t threadIndex)
+{
+	//Used before the Engine is initialized, only the main thread has one
+	if (m_FrameArenas.empty())
+	{
+		InitFrameArenas(1, DEFAULT_FRAME_ARENA_SIZE);
+	}
+	return *m_FrameArenas[threadIndex];
+}
+
+size_t MemoryManager::GetFrameArenaNmb() const
+{
+	return m_FrameArenas.size();
+}
+
+void MemoryManager::SwapFrameArenas()
+{
+	for (auto& frameArena : m_FrameArenas)
+	{
+		frameArena->Swap();
+	}
+}
+
+MemoryTracker& MemoryManager::GetMemoryTracker()
+{
+	return m_MemoryTracker;
+}
+
+void MemoryManager::AddMemoryReporter(IMemoryReporter* memoryReporter)
+{
+	if (std::find(m_MemoryReporters.begin(), m_MemoryReporters.end(), memoryReporter) == m_MemoryReporters.end())
+	{
+		m_MemoryReporters.push_back(memoryReporter);
+	}
+}
+
+void MemoryManager::UpdateMemoryReport()
+{
+	m_MemoryTracker.ClearFootprints();
+	for (const auto* memoryReporter : m_MemoryReporters)
+	{
+		memoryReporter->ReportMemory(m_MemoryTracker);
+	}
+	for (size_t i = 0; i < m_FrameArenas.size(); i++)
+	{
+		m_MemoryTracker.ReportFootprint(MemoryTag::FRAME, "Frame arena " + std::to_string(i),
+			m_FrameArenas[i]->GetCommittedMemory());
+	}
+}
+
+bool MemoryManager::WriteMemoryReport(const std::string& filename)
+{
+	UpdateMemoryReport();
+	json memoryJson = m_MemoryTracker.ToJson();
+	if (m_ComponentAllocator != nullptr)
+	{
+		json& componentMemoryJson = memoryJson["componentMemory"];
+		componentMemoryJson["size"] = m_ComponentAllocator->getSize();
+		componentMemoryJson["usedMemory"] = m_ComponentAllocator->getUsedMemory();
+		componentMemoryJson["largestFreeBlock"] = m_ComponentAllocator->getLargestFreeBlock();
+		componentMemoryJson["fragmentation"] = m_ComponentAllocator->getFragmentation();
+	}
+	std::ofstream reportFile(filename);
+	if (!reportFile)
+	{
+		Log::GetInstance()->Error("Cannot write the memory report to " + filename);
+		return false;
+	}
+	reportFile << memoryJson.dump(4);
+	return true;
+}
+
+}
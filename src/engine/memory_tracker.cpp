@@ -0,0 +1,173 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <engine/memory_tracker.h>
+
+namespace sfge
+{
+
+const char* GetMemoryTagName(MemoryTag memoryTag)
+{
+	switch (memoryTag)
+	{
+	case MemoryTag::COMPONENTS:
+		return "Components";
+	case MemoryTag::ENTITIES:
+		return "Entities";
+	case MemoryTag::TEXTURES:
+		return "Textures";
+	case MemoryTag::SOUNDS:
+		return "Sounds";
+	case MemoryTag::PHYSICS:
+		return "Physics";
+	case MemoryTag::PYTHON:
+		return "Python";
+	case MemoryTag::EDITOR:
+		return "Editor";
+	case MemoryTag::FRAME:
+		return "Frame";
+	default:
+		return "Other";
+	}
+}
+
+static size_t GetHistogramBucket(size_t size)
+{
+	size_t bucket = 0;
+	while (size > 1 && bucket < MEMORY_HISTOGRAM_SIZE - 1)
+	{
+		size >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+void MemoryTracker::SetTagTracked(MemoryTag memoryTag)
+{
+	m_TagCounters[static_cast<size_t>(memoryTag)].tracked.store(true, std::memory_order_relaxed);
+}
+
+bool MemoryTracker::IsTagTracked(MemoryTag memoryTag) const
+{
+	return m_TagCounters[static_cast<size_t>(memoryTag)].tracked.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::RecordAllocation(MemoryTag memoryTag, size_t size)
+{
+	auto& counters = m_TagCounters[static_cast<size_t>(memoryTag)];
+	const size_t currentBytes = counters.currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	while (peakBytes < currentBytes &&
+		!counters.peakBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed))
+	{
+	}
+	counters.allocationNmb.fetch_add(1, std::memory_order_relaxed);
+	counters.histogram[GetHistogramBucket(size)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::RecordDeallocation(MemoryTag memoryTag, size_t size, size_t deallocationNmb)
+{
+	auto& counters = m_TagCounters[static_cast<size_t>(memoryTag)];
+	counters.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+	counters.deallocationNmb.fetch_add(deallocationNmb, std::memory_order_relaxed);
+}
+
+void MemoryTracker::ClearFootprints()
+{
+	m_Footprints.clear();
+}
+
+void MemoryTracker::ReportFootprint(MemoryTag memoryTag, const std::string& name, size_t bytes)
+{
+	m_Footprints.push_back({ memoryTag, name, bytes });
+}
+
+const std::vector<MemoryFootprint>& MemoryTracker::GetFootprints() const
+{
+	return m_Footprints;
+}
+
+MemoryTagStats MemoryTracker::GetStats(MemoryTag memoryTag) const
+{
+	const auto& counters = m_TagCounters[static_cast<size_t>(memoryTag)];
+	MemoryTagStats stats;
+	stats.tracked = counters.tracked.load(std::memory_order_relaxed);
+	stats.currentBytes = counters.currentBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	stats.allocationNmb = counters.allocationNmb.load(std::memory_order_relaxed);
+	stats.deallocationNmb = counters.deallocationNmb.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < MEMORY_HISTOGRAM_SIZE; i++)
+	{
+		stats.histogram[i] = counters.histogram[i].load(std::memory_order_relaxed);
+	}
+	for (const auto& footprint : m_Footprints)
+	{
+		if (footprint.memoryTag == memoryTag)
+			stats.footprintBytes += footprint.bytes;
+	}
+	return stats;
+}
+
+json MemoryTracker::ToJson() const
+{
+	json memoryJson;
+	json tagsJson = json::object();
+	for (size_t i = 0; i < static_cast<size_t>(MemoryTag::LENGTH); i++)
+	{
+		const auto memoryTag = static_cast<MemoryTag>(i);
+		const MemoryTagStats stats = GetStats(memoryTag);
+		json tagJson;
+		tagJson["footprintBytes"] = stats.footprintBytes;
+		//The allocation counters of a tag without recorded allocations would only be zeros
+		if (stats.tracked)
+		{
+			tagJson["currentBytes"] = stats.currentBytes;
+			tagJson["peakBytes"] = stats.peakBytes;
+			tagJson["allocationNmb"] = stats.allocationNmb;
+			tagJson["deallocationNmb"] = stats.deallocationNmb;
+			//Only the buckets in use, keyed by their lower bound
+			json histogramJson = json::object();
+			for (size_t bucket = 0; bucket < MEMORY_HISTOGRAM_SIZE; bucket++)
+			{
+				if (stats.histogram[bucket] != 0)
+					histogramJson[std::to_string(size_t(1) << bucket)] = stats.histogram[bucket];
+			}
+			tagJson["histogram"] = histogramJson;
+		}
+		tagsJson[GetMemoryTagName(memoryTag)] = tagJson;
+	}
+	memoryJson["tags"] = tagsJson;
+	json footprintsJson = json::array();
+	for (const auto& footprint : m_Footprints)
+	{
+		footprintsJson.push_back({
+			{ "tag", GetMemoryTagName(footprint.memoryTag) },
+			{ "name", footprint.name },
+			{ "bytes", footprint.bytes } });
+	}
+	memoryJson["footprints"] = footprintsJson;
+	return memoryJson;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <engine/prefab.h>
+
+namespace sfge
+{
+
+void Prefab::SetName(const std::string& name)
+{
+	m_Name = name;
+}
+
+const std::string& Prefab::GetName() const
+{
+	return m_Name;
+}
+
+void Prefab::AddComponent(ComponentTypeId componentTypeId, json componentJson)
+{
+	PrefabComponent prefabComponent;
+	prefabComponent.componentTypeId = componentTypeId;
+	prefabComponent.componentJson = std::move(componentJson);
+	m_Components.push_back(std::move(prefabComponent));
+	m_Mask.Set(componentTypeId);
+}
+
+void Prefab::AddComponent(ComponentType componentType, json componentJson)
+{
+	AddComponent(GetComponentTypeId(componentType), std::move(componentJson));
+}
+
+const std::vector<PrefabComponent>& Prefab::GetComponents() const
+{
+	return m_Components;
+}
+
+ComponentMask Prefab::GetMask() const
+{
+	return m_Mask;
+}
+
+}
@@ -42,6 +42,7 @@
 #include <physics/physics2d.h>
 #include <audio/audio.h>
 #include <engine/engine.h>
+#include <engine/command_buffer.h>
 
 // for convenience
 
@@ -195,6 +196,7 @@ void SceneManager::LoadSceneFromJson(json& sceneJson, std::unique_ptr<editor::Sc
 		{
 			m_EntityManager->ResizeEntityNmb(entityNmb);
 		}
+		ReserveSceneComponents(sceneJson["entities"]);
 		for(auto& entityJson : sceneJson["entities"])
 		{
 			Entity entity = INVALID_ENTITY;
@@ -208,13 +210,7 @@ void SceneManager::LoadSceneFromJson(json& sceneJson, std::unique_ptr<editor::Sc
 			}
 			if(CheckJsonExists(entityJson, "name"))
 			{
-				m_EntityManager->GetEntityInfo(entity).name = entityJson["name"].get<std::string>();
-			}
-			else
-			{
-				std::ostringstream oss;
-				oss << "Entity " << entity;
-				m_EntityManager->GetEntityInfo(entity).name = oss.str();
+				m_EntityManager->SetEntityName(entity, entityJson["name"].get<std::string>());
 			}
 			if (entity != INVALID_ENTITY && 
 				CheckJsonExists(entityJson, "components"))
@@ -224,12 +220,11 @@ void SceneManager::LoadSceneFromJson(json& sceneJson, std::unique_ptr<editor::Sc
 				{
 					if (CheckJsonExists(componentJson, "type"))
 					{
-						const ComponentType componentType = componentJson["type"];
-						const auto index = static_cast<int>(log2(static_cast<double>(componentType)));
-						if(m_ComponentManager[index] != nullptr)
+						const ComponentTypeId componentTypeId = GetComponentTypeIdFromJson(componentJson);
+						if(componentTypeId < m_ComponentManager.size() && m_ComponentManager[componentTypeId] != nullptr)
 						{
-							m_ComponentManager[index]->CreateComponent(componentJson, entity);
-							m_EntityManager->AddComponentType(entity, componentType);
+							m_ComponentManager[componentTypeId]->CreateComponent(componentJson, entity);
+							m_EntityManager->AddComponentType(entity, componentTypeId);
 						}
 					}
 					else
@@ -270,6 +265,144 @@ void SceneManager::LoadSceneFromJson(json& sceneJson, std::unique_ptr<editor::Sc
 	
 }
 
+Prefab SceneManager::CreatePrefab(json& prefabJson) const
+{
+	Prefab prefab;
+	if (CheckJsonParameter(prefabJson, "name", json::value_t::string))
+	{
+		prefab.SetName(prefabJson["name"].get<std::string>());
+	}
+	if (!CheckJsonExists(prefabJson, "components"))
+	{
+		Log::GetInstance()->Error("[Error] No components in the prefab JSON");
+		return prefab;
+	}
+	for (auto& componentJson : prefabJson["components"])
+	{
+		if (!CheckJsonExists(componentJson, "type"))
+		{
+			std::ostringstream oss;
+			oss << "[Error] No type specified for prefab component with json content: " << componentJson;
+			Log::GetInstance()->Error(oss.str());
+			continue;
+		}
+		prefab.AddComponent(GetComponentTypeIdFromJson(componentJson), componentJson);
+	}
+	return prefab;
+}
+
+std::vector<Entity> SceneManager::Instantiate(const Prefab& prefab, size_t count,
+	const PrefabInitializer& initializer, bool parallel)
+{
+	rmt_ScopedCPUSample(PrefabInstantiate, 0);
+	auto entities = m_EntityManager->CreateEntities(count);
+	for (const auto& prefabComponent : prefab.GetComponents())
+	{
+		auto* componentFactory = GetComponentFactory(prefabComponent.componentTypeId);
+		if (componentFactory == nullptr)
+		{
+			std::ostringstream oss;
+			oss << "[Error] No component manager for prefab component type " << prefabComponent.componentTypeId;
+			Log::GetInstance()->Error(oss.str());
+			continue;
+		}
+		json componentJson = prefabComponent.componentJson;
+		componentFactory->CreateComponents(componentJson, entities);
+		for (const Entity entity : entities)
+		{
+			m_EntityManager->AddComponentType(entity, prefabComponent.componentTypeId);
+		}
+	}
+	if (initializer)
+	{
+		auto& threadPool = m_Engine.GetThreadPool();
+		const size_t chunkNmb = parallel ? static_cast<size_t>(threadPool.size()) + 1 : 1;
+		auto initializeRange = [&entities, &initializer](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				initializer(entities[i], i);
+			}
+		};
+		//Each chunk records in its own buffer, appended in chunk order so the result does not depend on the workers
+		auto& commandBuffer = m_EntityManager->GetCommandBuffer();
+		std::vector<EntityCommandBuffer> chunkCommandBuffers(chunkNmb > 1 ? chunkNmb : 0);
+		std::vector<std::future<void>> futures;
+		for (size_t chunk = 1; chunk < chunkNmb; chunk++)
+		{
+			const size_t begin = chunk * count / chunkNmb;
+			const size_t end = (chunk + 1) * count / chunkNmb;
+			auto* chunkCommandBuffer = &chunkCommandBuffers[chunk];
+			futures.push_back(threadPool.push([&initializeRange, chunkCommandBuffer, begin, end](int threadId)
+			{
+				//Worker buffers come after the main thread one
+				SetCommandBufferIndex(static_cast<size_t>(threadId) + 1);
+				SetRecordingCommandBuffer(chunkCommandBuffer);
+				initializeRange(begin, end);
+				SetRecordingCommandBuffer(nullptr);
+			}));
+		}
+		auto* previousCommandBuffer = GetRecordingCommandBuffer();
+		if (chunkNmb > 1)
+			SetRecordingCommandBuffer(&chunkCommandBuffers[0]);
+		initializeRange(0, count / chunkNmb);
+		SetRecordingCommandBuffer(previousCommandBuffer);
+		for (auto& future : futures)
+		{
+			future.get();
+		}
+		for (auto& chunkCommandBuffer : chunkCommandBuffers)
+		{
+			commandBuffer.Append(chunkCommandBuffer);
+		}
+	}
+	for (const auto& prefabComponent : prefab.GetComponents())
+	{
+		if (auto* componentFactory = GetComponentFactory(prefabComponent.componentTypeId))
+		{
+			componentFactory->OnInstantiated(entities);
+		}
+	}
+	return entities;
+}
+
+ComponentTypeId SceneManager::GetComponentTypeIdFromJson(json& componentJson) const
+{
+	if (componentJson["type"].is_string())
+	{
+		return m_EntityManager->GetComponentTypeRegistry().GetTypeId(componentJson["type"]);
+	}
+	const ComponentType componentType = componentJson["type"];
+	return GetComponentTypeId(componentType);
+}
+
+void SceneManager::ReserveSceneComponents(json& entitiesJson)
+{
+	std::vector<size_t> componentNmbs(m_ComponentManager.size(), 0);
+	for (auto& entityJson : entitiesJson)
+	{
+		if (!CheckJsonExists(entityJson, "components"))
+			continue;
+		for (auto& componentJson : entityJson["components"])
+		{
+			if (!CheckJsonExists(componentJson, "type"))
+				continue;
+			const ComponentTypeId componentTypeId = GetComponentTypeIdFromJson(componentJson);
+			if (componentTypeId < componentNmbs.size())
+			{
+				componentNmbs[componentTypeId]++;
+			}
+		}
+	}
+	for (size_t i = 0; i < componentNmbs.size(); i++)
+	{
+		if (componentNmbs[i] != 0 && m_ComponentManager[i] != nullptr)
+		{
+			m_ComponentManager[i]->ReserveComponents(componentNmbs[i]);
+		}
+	}
+}
+
 std::list<std::string> SceneManager::GetAllScenes()
 {
 	std::list<std::string> scenes;
@@ -309,8 +442,20 @@ void SceneManager::LoadSceneFromName(const std::string& sceneName)
 }
 void SceneManager::AddComponentManager(IComponentFactory *componentFactory, ComponentType componentType)
 {
-	const auto index = static_cast<int>(log2((double)componentType));
-	m_ComponentManager[index] = componentFactory;
+	AddComponentManager(componentFactory, GetComponentTypeId(componentType));
+}
+void SceneManager::AddComponentManager(IComponentFactory *componentFactory, ComponentTypeId componentTypeId)
+{
+	if (componentTypeId < m_ComponentManager.size())
+	{
+		m_ComponentManager[componentTypeId] = componentFactory;
+	}
+}
+IComponentFactory* SceneManager::GetComponentFactory(ComponentTypeId componentTypeId) const
+{
+	if (componentTypeId >= m_ComponentManager.size())
+		return nullptr;
+	return m_ComponentManager[componentTypeId];
 }
 void SceneManager::OnUpdate(float dt)
 {
@@ -0,0 +1,145 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <engine/scheduler.h>
+#include <engine/command_buffer.h>
+#include <Remotery.h>
+
+namespace sfge
+{
+
+void SystemScheduler::AddSystem(System* system)
+{
+	m_Systems.push_back(system);
+}
+
+void SystemScheduler::AddDependency(System* before, System* after)
+{
+	m_Dependencies.emplace_back(before, after);
+}
+
+void SystemScheduler::Clear()
+{
+	m_Systems.clear();
+	m_Dependencies.clear();
+	m_Waves.clear();
+	m_CommandBuffers.clear();
+}
+
+bool SystemScheduler::IsConflicting(const System& previousSystem, const System& nextSystem)
+{
+	return previousSystem.GetWriteMask().Intersects(nextSystem.GetReadMask() | nextSystem.GetWriteMask()) ||
+		nextSystem.GetWriteMask().Intersects(previousSystem.GetReadMask());
+}
+
+void SystemScheduler::Build()
+{
+	std::vector<size_t> levels(m_Systems.size(), 0);
+	size_t maxLevel = 0;
+	for (size_t i = 0; i < m_Systems.size(); i++)
+	{
+		for (size_t j = 0; j < i; j++)
+		{
+			const bool isDependency = std::find(m_Dependencies.begin(), m_Dependencies.end(),
+				std::make_pair(m_Systems[j], m_Systems[i])) != m_Dependencies.end();
+			if (isDependency || IsConflicting(*m_Systems[j], *m_Systems[i]))
+			{
+				levels[i] = std::max(levels[i], levels[j] + 1);
+			}
+		}
+		maxLevel = std::max(maxLevel, levels[i]);
+	}
+	m_Waves.assign(m_Systems.empty() ? 0 : maxLevel + 1, std::vector<size_t>());
+	for (size_t i = 0; i < m_Systems.size(); i++)
+	{
+		m_Waves[levels[i]].push_back(i);
+	}
+	m_Futures.reserve(m_Systems.size());
+	m_CommandBuffers.resize(m_Systems.size());
+}
+
+void SystemScheduler::Update(float dt, ctpl::thread_pool& threadPool, EntityCommandBuffer* commandBuffer)
+{
+	rmt_ScopedCPUSample(SystemSchedulerUpdate, 0);
+	const bool useThreadPool = threadPool.size() > 0;
+	for (auto& wave : m_Waves)
+	{
+		m_Futures.clear();
+		if (useThreadPool && wave.size() > 1)
+		{
+			for (const auto systemIndex : wave)
+			{
+				auto* system = m_Systems[systemIndex];
+				if (!system->IsMainThreadOnly())
+				{
+					auto* systemCommandBuffer = commandBuffer != nullptr ? &m_CommandBuffers[systemIndex] : nullptr;
+					m_Futures.push_back(threadPool.push([system, dt, systemCommandBuffer](int threadId)
+					{
+						//Worker buffers come after the main thread one
+						SetCommandBufferIndex(static_cast<size_t>(threadId) + 1);
+						SetRecordingCommandBuffer(systemCommandBuffer);
+						system->OnUpdate(dt);
+						SetRecordingCommandBuffer(nullptr);
+					}));
+				}
+			}
+		}
+		for (const auto systemIndex : wave)
+		{
+			auto* system = m_Systems[systemIndex];
+			if (!useThreadPool || wave.size() == 1 || system->IsMainThreadOnly())
+			{
+				auto* previousCommandBuffer = GetRecordingCommandBuffer();
+				if (commandBuffer != nullptr)
+					SetRecordingCommandBuffer(&m_CommandBuffers[systemIndex]);
+				system->OnUpdate(dt);
+				SetRecordingCommandBuffer(previousCommandBuffer);
+			}
+		}
+		for (auto& future : m_Futures)
+		{
+			future.get();
+		}
+	}
+	//Same order as running the systems one after the other, whatever worker ran them
+	if (commandBuffer != nullptr)
+	{
+		for (const auto& wave : m_Waves)
+		{
+			for (const auto systemIndex : wave)
+			{
+				commandBuffer->Append(m_CommandBuffers[systemIndex]);
+			}
+		}
+	}
+}
+
+const std::vector<std::vector<size_t>>& SystemScheduler::GetWaves() const
+{
+	return m_Waves;
+}
+
+}
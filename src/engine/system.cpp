@@ -48,4 +48,26 @@ bool System::GetInitlialized() const
 {
 	return m_Initialized;
 }
+
+EntityMask System::GetReadMask() const
+{
+	return m_ReadMask;
+}
+
+EntityMask System::GetWriteMask() const
+{
+	return m_WriteMask;
+}
+
+bool System::IsMainThreadOnly() const
+{
+	return m_MainThreadOnly;
+}
+
+void System::SetComponentAccess(EntityMask readMask, EntityMask writeMask, bool mainThreadOnly)
+{
+	m_ReadMask = readMask;
+	m_WriteMask = writeMask;
+	m_MainThreadOnly = mainThreadOnly;
+}
 }
@@ -6,68 +6,778 @@
  */
 
 
+#include <algorithm>
+
 #include <engine/transform2d.h>
 #include <imgui.h>
 #include <engine/engine.h>
+#include <utility/log.h>
+#include <Remotery.h>
+
+#if defined(SFGE_AVX)
+#include <immintrin.h>
+#elif defined(SFGE_SSE2)
+#include <emmintrin.h>
+#endif
 namespace sfge
 {
+Vec2fRef& Vec2fRef::operator=(const Vec2f& v)
+{
+	x = v.x;
+	y = v.y;
+	version++;
+	return *this;
+}
+
+Vec2fRef& Vec2fRef::operator=(const Vec2fRef& v)
+{
+	return *this = static_cast<Vec2f>(v);
+}
+
+Vec2fRef& Vec2fRef::operator+=(const Vec2f& rhs)
+{
+	x += rhs.x;
+	y += rhs.y;
+	version++;
+	return *this;
+}
+
+Vec2fRef& Vec2fRef::operator-=(const Vec2f& rhs)
+{
+	x -= rhs.x;
+	y -= rhs.y;
+	version++;
+	return *this;
+}
+
+Vec2f Vec2fRef::operator+(const Vec2f& rhs) const
+{
+	return Vec2f(x + rhs.x, y + rhs.y);
+}
+
+Vec2f Vec2fRef::operator-(const Vec2f& rhs) const
+{
+	return Vec2f(x - rhs.x, y - rhs.y);
+}
+
+Vec2fRef::operator Vec2f() const
+{
+	return Vec2f(x, y);
+}
+
+Vec2fRef::operator sf::Vector2f() const
+{
+	return sf::Vector2f(x, y);
+}
+
+Transform2dRef::Transform2dRef(Vec2fRef position, Vec2fRef scale, float& eulerAngle, unsigned& version) :
+	Position(position), Scale(scale), Version(version), m_EulerAngle(eulerAngle)
+{
+}
+
+Transform2dRef& Transform2dRef::operator=(const Transform2d& transform)
+{
+	Position.x = transform.Position.x;
+	Position.y = transform.Position.y;
+	Scale.x = transform.Scale.x;
+	Scale.y = transform.Scale.y;
+	m_EulerAngle = transform.EulerAngle;
+	Version++;
+	return *this;
+}
+
+Transform2dRef& Transform2dRef::operator=(const Transform2dRef& transform)
+{
+	return *this = static_cast<Transform2d>(transform);
+}
+
+Transform2dRef::operator Transform2d() const
+{
+	Transform2d transform;
+	transform.Position = Position;
+	transform.Scale = Scale;
+	transform.EulerAngle = m_EulerAngle;
+	return transform;
+}
+
+float Transform2dRef::GetEulerAngle() const
+{
+	return m_EulerAngle;
+}
+
+void Transform2dRef::SetEulerAngle(float eulerAngle)
+{
+	m_EulerAngle = eulerAngle;
+	Version++;
+}
+
+Transform2dRef Transform2dStorage::operator[](size_t index)
+{
+	return Transform2dRef(
+		Vec2fRef{m_PositionsX[index], m_PositionsY[index], m_Versions[index]},
+		Vec2fRef{m_ScalesX[index], m_ScalesY[index], m_Versions[index]},
+		m_Angles[index],
+		m_Versions[index]);
+}
+
+Transform2dPtr Transform2dStorage::GetPtr(size_t index)
+{
+	return Transform2dPtr((*this)[index]);
+}
+
+Transform2d Transform2dStorage::Get(size_t index) const
+{
+	Transform2d transform;
+	transform.Position = Vec2f(m_PositionsX[index], m_PositionsY[index]);
+	transform.Scale = Vec2f(m_ScalesX[index], m_ScalesY[index]);
+	transform.EulerAngle = m_Angles[index];
+	return transform;
+}
+
+unsigned Transform2dStorage::GetVersion(size_t index) const
+{
+	return m_Versions[index];
+}
+
+void Transform2dStorage::MarkChanged(size_t index)
+{
+	m_Versions[index]++;
+}
+
+size_t Transform2dStorage::size() const
+{
+	return m_Angles.size();
+}
+
+void Transform2dStorage::resize(size_t newSize)
+{
+	const size_t oldSize = size();
+	m_PositionsX.resize(newSize);
+	m_PositionsY.resize(newSize);
+	m_ScalesX.resize(newSize);
+	m_ScalesY.resize(newSize);
+	m_Angles.resize(newSize);
+	m_Versions.resize(newSize);
+	for (size_t i = oldSize; i < newSize; i++)
+	{
+		m_ScalesX[i] = 1.0f;
+		m_ScalesY[i] = 1.0f;
+	}
+}
+
+void Transform2dStorage::clear()
+{
+	m_PositionsX.clear();
+	m_PositionsY.clear();
+	m_ScalesX.clear();
+	m_ScalesY.clear();
+	m_Angles.clear();
+	m_Versions.clear();
+}
+
+void Transform2dStorage::SetAllocator(Allocator* allocator)
+{
+	m_PositionsX.SetAllocator(allocator);
+	m_PositionsY.SetAllocator(allocator);
+	m_ScalesX.SetAllocator(allocator);
+	m_ScalesY.SetAllocator(allocator);
+	m_Angles.SetAllocator(allocator);
+	m_Versions.SetAllocator(allocator);
+}
+
+size_t GetContainerFootprint(const Transform2dStorage& storage)
+{
+	const size_t floatNmb = 5;
+	return storage.GetPageNmb() * COMPONENT_PAGE_SIZE * (floatNmb * sizeof(float) + sizeof(unsigned));
+}
+
+size_t Transform2dStorage::GetPageNmb() const
+{
+	return m_Angles.GetPageNmb();
+}
+
+size_t Transform2dStorage::GetPageLength(size_t page) const
+{
+	return m_Angles.GetPageLength(page);
+}
+
+static void WrapAngle(float* angles, unsigned* versions, size_t index)
+{
+	if (angles[index] > 180.0f)
+	{
+		angles[index] -= 360.0f;
+		if (versions != nullptr)
+			versions[index]++;
+	}
+	if (angles[index] < -180.0f)
+	{
+		angles[index] += 360.0f;
+		if (versions != nullptr)
+			versions[index]++;
+	}
+}
+
+void WrapAngles(float* angles, size_t length, unsigned* versions)
+{
+	//Angles out of range are rare, the vector loops only test them and the wrap itself is scalar
+	size_t i = 0;
+#if defined(SFGE_AVX)
+	const __m256 max = _mm256_set1_ps(180.0f);
+	const __m256 min = _mm256_set1_ps(-180.0f);
+	for (; i + 8 <= length; i += 8)
+	{
+		const __m256 angle = _mm256_loadu_ps(angles + i);
+		const __m256 outOfRange = _mm256_or_ps(_mm256_cmp_ps(angle, max, _CMP_GT_OQ), _mm256_cmp_ps(angle, min, _CMP_LT_OQ));
+		if (_mm256_movemask_ps(outOfRange) != 0)
+		{
+			for (size_t j = i; j < i + 8; j++)
+			{
+				WrapAngle(angles, versions, j);
+			}
+		}
+	}
+#endif
+#if defined(SFGE_SSE2)
+	const __m128 max4 = _mm_set1_ps(180.0f);
+	const __m128 min4 = _mm_set1_ps(-180.0f);
+	for (; i + 4 <= length; i += 4)
+	{
+		const __m128 angle = _mm_loadu_ps(angles + i);
+		const __m128 outOfRange = _mm_or_ps(_mm_cmpgt_ps(angle, max4), _mm_cmplt_ps(angle, min4));
+		if (_mm_movemask_ps(outOfRange) != 0)
+		{
+			for (size_t j = i; j < i + 4; j++)
+			{
+				WrapAngle(angles, versions, j);
+			}
+		}
+	}
+#endif
+	for (; i < length; i++)
+	{
+		WrapAngle(angles, versions, i);
+	}
+}
+
+static void AddScalar(float* values, size_t length, float delta)
+{
+	size_t i = 0;
+#if defined(SFGE_AVX)
+	const __m256 delta8 = _mm256_set1_ps(delta);
+	for (; i + 8 <= length; i += 8)
+	{
+		_mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), delta8));
+	}
+#endif
+#if defined(SFGE_SSE2)
+	const __m128 delta4 = _mm_set1_ps(delta);
+	for (; i + 4 <= length; i += 4)
+	{
+		_mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), delta4));
+	}
+#endif
+	for (; i < length; i++)
+	{
+		values[i] += delta;
+	}
+}
+
+void TranslatePositions(float* positionsX, float* positionsY, size_t length, Vec2f delta)
+{
+	AddScalar(positionsX, length, delta.x);
+	AddScalar(positionsY, length, delta.y);
+}
+
+static void ScaleAndSubtract(const float* values, const float* offsets, float* results, size_t length, float scale)
+{
+	size_t i = 0;
+#if defined(SFGE_AVX)
+	const __m256 scale8 = _mm256_set1_ps(scale);
+	for (; i + 8 <= length; i += 8)
+	{
+		const __m256 result = _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(values + i), scale8), _mm256_loadu_ps(offsets + i));
+		_mm256_storeu_ps(results + i, result);
+	}
+#endif
+#if defined(SFGE_SSE2)
+	const __m128 scale4 = _mm_set1_ps(scale);
+	for (; i + 4 <= length; i += 4)
+	{
+		const __m128 result = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(values + i), scale4), _mm_loadu_ps(offsets + i));
+		_mm_storeu_ps(results + i, result);
+	}
+#endif
+	for (; i < length; i++)
+	{
+		results[i] = values[i] * scale - offsets[i];
+	}
+}
+
+void MetersToPixels(const float* metersX, const float* metersY,
+	const float* offsetsX, const float* offsetsY,
+	float* pixelsX, float* pixelsY, size_t length, float pixelPerMeter)
+{
+	ScaleAndSubtract(metersX, offsetsX, pixelsX, length, pixelPerMeter);
+	ScaleAndSubtract(metersY, offsetsY, pixelsY, length, pixelPerMeter);
+}
+
+Transform2d ComposeTransforms(const Transform2d& parent, const Transform2d& local)
+{
+	Transform2d world;
+	const Vec2f scaledPosition(local.Position.x * parent.Scale.x, local.Position.y * parent.Scale.y);
+	world.Position = parent.Position + scaledPosition.Rotate(parent.EulerAngle);
+	world.Scale = Vec2f(local.Scale.x * parent.Scale.x, local.Scale.y * parent.Scale.y);
+	world.EulerAngle = local.EulerAngle + parent.EulerAngle;
+	return world;
+}
+
+Vec2f InverseTransformPosition(const Transform2d& parent, Vec2f worldPosition)
+{
+	const Vec2f rotatedPosition = (worldPosition - parent.Position).Rotate(-parent.EulerAngle);
+	return Vec2f(
+		parent.Scale.x != 0.0f ? rotatedPosition.x / parent.Scale.x : 0.0f,
+		parent.Scale.y != 0.0f ? rotatedPosition.y / parent.Scale.y : 0.0f);
+}
+
 void editor::Transform2dInfo::DrawOnInspector()
 {
-	auto* transform = transformManager->GetComponentPtr(m_Entity);
+	auto transform = transformManager->GetComponentPtr(m_Entity);
 	float pos[2] = { transform->Position.x, transform->Position.y };
 	ImGui::Separator();
 	ImGui::Text("Transform");
 	ImGui::InputFloat2("Position", pos);
 	float scale[2] = { transform->Scale.x, transform->Scale.y };
 	ImGui::InputFloat2("Scale", scale);
-	ImGui::InputFloat("Angle", &transform->EulerAngle);
+	float angle = transform->GetEulerAngle();
+	if (ImGui::InputFloat("Angle", &angle))
+		transform->SetEulerAngle(angle);
 }
 
 
-Transform2d* Transform2dManager::AddComponent(Entity entity)
+Transform2dManager::Transform2dManager(Engine& engine) : SingleComponentManager(engine)
 {
+	m_WorldTransforms.resize(INIT_ENTITY_NMB);
+	m_Parents.resize(INIT_ENTITY_NMB, INVALID_ENTITY);
+}
 
-	auto& transform = GetComponentRef(entity);
+void Transform2dManager::OnEngineInit()
+{
+	SingleComponentManager::OnEngineInit();
+	m_WorldTransforms.SetAllocator(m_Engine.GetMemoryManager()->GetComponentAllocator());
+	SetComponentAccess(EntityMask(), static_cast<EntityMask>(ComponentType::TRANSFORM2D), false);
+}
+
+Transform2dPtr Transform2dManager::AddComponent(Entity entity)
+{
+
+	auto transform = GetComponentPtr(entity);
 	m_Engine.GetEntityManager()->AddComponentType(entity, ComponentType::TRANSFORM2D);
-	auto& transformInfo = GetComponentInfo(entity);
-	transformInfo.SetEntity(entity);
-	transformInfo.transformManager = this;
-	return &transform;
+	if (HasComponentInfos())
+	{
+		auto& transformInfo = GetComponentInfo(entity);
+		transformInfo.SetEntity(entity);
+		transformInfo.transformManager = this;
+	}
+	return transform;
 }
 
 void Transform2dManager::CreateComponent(json& componentJson, Entity entity)
 {
 
 	//Log::GetInstance()->Msg("Create component Transform");
-	auto* transform = AddComponent(entity);
+	auto transform = AddComponent(entity);
 	if (CheckJsonExists(componentJson, "position"))
 		transform->Position = GetVectorFromJson(componentJson, "position");
 	if (CheckJsonExists(componentJson, "scale"))
 		transform->Scale = GetVectorFromJson(componentJson, "scale");
 	if (CheckJsonExists(componentJson, "angle") && CheckJsonNumber(componentJson, "angle"))
-		transform->EulerAngle = componentJson["angle"];
+		transform->SetEulerAngle(componentJson["angle"].get<float>());
+	if (CheckJsonExists(componentJson, "parent") && CheckJsonNumber(componentJson, "parent"))
+	{
+		//Parents declared before their children are attached now so the other components see the world transform
+		const Entity parentIndex = componentJson["parent"].get<Entity>();
+		const Entity parent = m_EntityManager->GetEntity(parentIndex);
+		if (parent != INVALID_ENTITY && m_EntityManager->HasComponent(parent, ComponentType::TRANSFORM2D))
+			SetParent(entity, parent);
+		else
+			m_SceneParents.emplace_back(entity, parentIndex);
+	}
+}
+
+void Transform2dManager::CreateComponents(json& componentJson, const std::vector<Entity>& entities)
+{
+	if (CheckJsonExists(componentJson, "parent"))
+	{
+		//Parents are resolved per entity
+		SingleComponentManager::CreateComponents(componentJson, entities);
+		return;
+	}
+	Transform2d transform;
+	if (CheckJsonExists(componentJson, "position"))
+		transform.Position = GetVectorFromJson(componentJson, "position");
+	if (CheckJsonExists(componentJson, "scale"))
+		transform.Scale = GetVectorFromJson(componentJson, "scale");
+	if (CheckJsonExists(componentJson, "angle") && CheckJsonNumber(componentJson, "angle"))
+		transform.EulerAngle = componentJson["angle"];
+	for (const Entity entity : entities)
+	{
+		AddComponent(entity);
+		m_Components[GetEntityIndex(entity) - 1] = transform;
+	}
 }
 
 void Transform2dManager::DestroyComponent(Entity entity)
 {
+	RemoveFromHierarchy(entity);
 	m_Engine.GetEntityManager()->RemoveComponentType(entity, ComponentType::TRANSFORM2D);
 }
 
+void Transform2dManager::OnDestroy(Entity entity)
+{
+	RemoveFromHierarchy(entity);
+}
+
+void Transform2dManager::OnDestroyEntities(const std::vector<Entity>& entities)
+{
+	//Mark the batch, then one pass over the hierarchy removes the destroyed entities and their children
+	std::vector<bool> destroyed(m_Parents.size(), false);
+	for (const Entity entity : entities)
+	{
+		const auto index = GetEntityIndex(entity);
+		if (index == 0 || index > m_Parents.size())
+			continue;
+		destroyed[index - 1] = true;
+	}
+	const auto isDestroyed = [&destroyed](Entity entity)
+	{
+		const auto index = GetEntityIndex(entity);
+		return index != 0 && index <= destroyed.size() && destroyed[index - 1];
+	};
+	const auto hierarchyEnd = std::remove_if(m_Hierarchy.begin(), m_Hierarchy.end(),
+		[this, &isDestroyed](const TransformHierarchyNode& node)
+	{
+		if (!isDestroyed(node.entity) && !isDestroyed(node.parent))
+			return false;
+		KeepWorldTransform(GetEntityIndex(node.entity) - 1);
+		return true;
+	});
+	if (hierarchyEnd != m_Hierarchy.end())
+	{
+		m_Hierarchy.erase(hierarchyEnd, m_Hierarchy.end());
+		m_HierarchyDirty = true;
+	}
+}
+
+void Transform2dManager::OnResize(size_t newSize)
+{
+	SingleComponentManager::OnResize(newSize);
+	m_WorldTransforms.resize(newSize);
+	m_Parents.resize(newSize, INVALID_ENTITY);
+}
+
+void Transform2dManager::OnBeforeSceneLoad()
+{
+	m_Hierarchy.clear();
+	std::fill(m_Parents.begin(), m_Parents.end(), INVALID_ENTITY);
+	m_SceneParents.clear();
+	m_HierarchyDirty = false;
+}
+
+void Transform2dManager::OnAfterSceneLoad()
+{
+	for (auto& sceneParent : m_SceneParents)
+	{
+		SetParent(sceneParent.first, m_EntityManager->GetEntity(sceneParent.second));
+	}
+	m_SceneParents.clear();
+}
+
 
 void Transform2dManager::OnUpdate(float dt) {
 	System::OnUpdate(dt);
-    for(auto& transform : m_Components)
+	auto& angles = m_Components.GetAngles();
+	auto& versions = m_Components.GetVersions();
+    for(auto page = 0u; page < angles.GetPageNmb(); page++)
+	{
+    	WrapAngles(angles.GetPage(page), angles.GetPageLength(page), versions.GetPage(page));
+	}
+	UpdateWorldTransforms();
+}
+
+void Transform2dManager::TranslateAll(Vec2f delta)
+{
+	auto& positionsX = m_Components.GetPositionsX();
+	auto& positionsY = m_Components.GetPositionsY();
+	for(auto page = 0u; page < positionsX.GetPageNmb(); page++)
+	{
+		TranslatePositions(positionsX.GetPage(page), positionsY.GetPage(page), positionsX.GetPageLength(page), delta);
+	}
+	for (auto& version : m_Components.GetVersions())
+	{
+		version++;
+	}
+}
+
+Transform2d Transform2dManager::GetTransform(Entity entity) const
+{
+	return m_Components.Get(GetEntityIndex(entity) - 1);
+}
+
+unsigned Transform2dManager::GetVersion(Entity entity) const
+{
+	return m_Components.GetVersion(GetEntityIndex(entity) - 1);
+}
+
+bool Transform2dManager::SetParent(Entity entity, Entity parent)
+{
+	if (parent != INVALID_ENTITY)
+	{
+		if (!m_EntityManager->IsEntityValid(parent) || !m_EntityManager->HasComponent(parent, ComponentType::TRANSFORM2D))
+		{
+			Log::GetInstance()->Error("Trying to set a parent without transform");
+			return false;
+		}
+		for (Entity ancestor = parent; ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
+		{
+			if (GetEntityIndex(ancestor) == GetEntityIndex(entity))
+			{
+				Log::GetInstance()->Error("Trying to set a parent that would create a cycle in the transform hierarchy");
+				return false;
+			}
+		}
+	}
+	const auto index = GetEntityIndex(entity) - 1;
+	const Entity oldParent = m_Parents[index];
+	if (oldParent == parent)
+		return true;
+	if (parent == INVALID_ENTITY)
+	{
+		Detach(entity);
+		return true;
+	}
+	m_Parents[index] = parent;
+	if (oldParent == INVALID_ENTITY)
+	{
+		//The world version continues from the local one so readers never see a version twice
+		m_WorldTransforms.GetVersions()[index] = m_Components.GetVersion(index) + 1;
+		TransformHierarchyNode node;
+		node.entity = entity;
+		node.parent = parent;
+		m_Hierarchy.push_back(node);
+	}
+	else
 	{
-    	if(transform.EulerAngle > 180.0f)
+		for (auto& node : m_Hierarchy)
 		{
-    		transform.EulerAngle -= 360.0f;
+			if (GetEntityIndex(node.entity) - 1 == index)
+			{
+				node.parent = parent;
+				node.localVersion = INVALID_TRANSFORM_VERSION;
+				node.parentVersion = INVALID_TRANSFORM_VERSION;
+			}
 		}
+	}
+	//Valid right away for the components created after, the next update counts it as a change
+	SetWorldTransform(index, ComposeTransforms(GetWorldTransform(parent), m_Components.Get(index)));
+	m_HierarchyDirty = true;
+	return true;
+}
 
-		if(transform.EulerAngle < -180.0f)
+Entity Transform2dManager::GetParent(Entity entity) const
+{
+	return m_Parents[GetEntityIndex(entity) - 1];
+}
+
+void Transform2dManager::Detach(Entity entity)
+{
+	const auto index = GetEntityIndex(entity) - 1;
+	if (m_Parents[index] == INVALID_ENTITY)
+		return;
+	KeepWorldTransform(index);
+	m_Hierarchy.erase(std::remove_if(m_Hierarchy.begin(), m_Hierarchy.end(),
+		[index](const TransformHierarchyNode& node) { return GetEntityIndex(node.entity) - 1 == index; }),
+		m_Hierarchy.end());
+	m_HierarchyDirty = true;
+}
+
+void Transform2dManager::KeepWorldTransform(size_t index)
+{
+	//The detached entity keeps its world transform and its version keeps increasing
+	const Transform2d world = m_WorldTransforms.Get(index);
+	auto& localVersions = m_Components.GetVersions();
+	const auto version = std::max(localVersions[index], m_WorldTransforms.GetVersion(index));
+	m_Components[index] = world;
+	localVersions[index] = version + 1;
+	m_Parents[index] = INVALID_ENTITY;
+}
+
+void Transform2dManager::RemoveFromHierarchy(Entity entity)
+{
+	if (GetEntityIndex(entity) > m_Parents.size())
+		return;
+	Detach(entity);
+	//Children of a removed transform become roots where they are
+	std::vector<Entity> children;
+	for (auto& node : m_Hierarchy)
+	{
+		if (GetEntityIndex(node.parent) == GetEntityIndex(entity))
+			children.push_back(node.entity);
+	}
+	for (const Entity child : children)
+	{
+		Detach(child);
+	}
+}
+
+void Transform2dManager::SortHierarchy()
+{
+	for (auto& node : m_Hierarchy)
+	{
+		node.depth = 0;
+		for (Entity ancestor = node.parent; ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
 		{
-			transform.EulerAngle += 360.0f;
+			node.depth++;
 		}
 	}
+	std::stable_sort(m_Hierarchy.begin(), m_Hierarchy.end(),
+		[](const TransformHierarchyNode& lhs, const TransformHierarchyNode& rhs) { return lhs.depth < rhs.depth; });
+	m_HierarchyDirty = false;
+}
+
+void Transform2dManager::UpdateWorldTransforms()
+{
+	rmt_ScopedCPUSample(TransformHierarchyUpdate, 0);
+	if (m_HierarchyDirty)
+	{
+		SortHierarchy();
+	}
+	//Parents are before their children, one pass is enough
+	for (auto& node : m_Hierarchy)
+	{
+		const auto index = GetEntityIndex(node.entity) - 1;
+		const unsigned localVersion = m_Components.GetVersion(index);
+		const unsigned parentVersion = GetWorldVersion(node.parent);
+		if (localVersion == node.localVersion && parentVersion == node.parentVersion)
+			continue;
+		SetWorldTransform(index, ComposeTransforms(GetWorldTransform(node.parent), m_Components.Get(index)));
+		node.localVersion = localVersion;
+		node.parentVersion = parentVersion;
+	}
+}
+
+void Transform2dManager::SetWorldTransform(size_t index, const Transform2d& world)
+{
+	m_WorldTransforms.GetPositionsX()[index] = world.Position.x;
+	m_WorldTransforms.GetPositionsY()[index] = world.Position.y;
+	m_WorldTransforms.GetScalesX()[index] = world.Scale.x;
+	m_WorldTransforms.GetScalesY()[index] = world.Scale.y;
+	m_WorldTransforms.GetAngles()[index] = world.EulerAngle;
+	m_WorldTransforms.MarkChanged(index);
+}
+
+Transform2d Transform2dManager::GetWorldTransform(Entity entity) const
+{
+	const auto index = GetEntityIndex(entity) - 1;
+	if (m_Parents[index] == INVALID_ENTITY)
+		return m_Components.Get(index);
+	return m_WorldTransforms.Get(index);
+}
+
+unsigned Transform2dManager::GetWorldVersion(Entity entity) const
+{
+	const auto index = GetEntityIndex(entity) - 1;
+	if (m_Parents[index] == INVALID_ENTITY)
+		return m_Components.GetVersion(index);
+	return m_WorldTransforms.GetVersion(index);
+}
+
+void Transform2dManager::SetWorldPosition(Entity entity, Vec2f position)
+{
+	const auto index = GetEntityIndex(entity) - 1;
+	const Entity parent = m_Parents[index];
+	if (parent != INVALID_ENTITY)
+	{
+		position = InverseTransformPosition(GetWorldTransform(parent), position);
+	}
+	m_Components[index].Position = position;
+}
+
+const std::vector<TransformHierarchyNode>& Transform2dManager::GetHierarchy() const
+{
+	return m_Hierarchy;
+}
+
+void Transform2dManager::ReportMemory(MemoryTracker& memoryTracker) const
+{
+	SingleComponentManager::ReportMemory(memoryTracker);
+	memoryTracker.ReportFootprint(MemoryTag::COMPONENTS, "Transform2d hierarchy",
+		GetContainerFootprint(m_WorldTransforms) + GetContainerFootprint(m_Parents) + GetContainerFootprint(m_Hierarchy));
+}
+
+void Transform2dManager::SaveSnapshot(WorldSnapshot& snapshot)
+{
+	snapshot.WritePagedVector(m_Components.GetPositionsX());
+	snapshot.WritePagedVector(m_Components.GetPositionsY());
+	snapshot.WritePagedVector(m_Components.GetScalesX());
+	snapshot.WritePagedVector(m_Components.GetScalesY());
+	snapshot.WritePagedVector(m_Components.GetAngles());
+	snapshot.Write(m_Parents.size());
+	snapshot.WriteArray(m_Parents.data(), m_Parents.size());
+}
+
+bool Transform2dManager::CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const
+{
+	//The transforms are resized with the entities before they are restored
+	const size_t transformNmb = std::max(entityNmb, m_Components.size());
+	size_t parentNmb = 0;
+	return reader.SkipPagedVector<float>(transformNmb) &&
+		reader.SkipPagedVector<float>(transformNmb) &&
+		reader.SkipPagedVector<float>(transformNmb) &&
+		reader.SkipPagedVector<float>(transformNmb) &&
+		reader.SkipPagedVector<float>(transformNmb) &&
+		reader.Read(parentNmb) && parentNmb <= std::max(entityNmb, m_Parents.size()) &&
+		reader.SkipArray<Entity>(parentNmb);
+}
+
+bool Transform2dManager::RestoreSnapshot(WorldSnapshot::Reader& reader)
+{
+	rmt_ScopedCPUSample(TransformRestoreSnapshot, 0);
+	if (!reader.ReadPagedVector(m_Components.GetPositionsX()) ||
+		!reader.ReadPagedVector(m_Components.GetPositionsY()) ||
+		!reader.ReadPagedVector(m_Components.GetScalesX()) ||
+		!reader.ReadPagedVector(m_Components.GetScalesY()) ||
+		!reader.ReadPagedVector(m_Components.GetAngles()))
+		return false;
+	size_t parentNmb = 0;
+	if (!reader.Read(parentNmb) || parentNmb > m_Parents.size())
+		return false;
+	std::fill(m_Parents.begin() + parentNmb, m_Parents.end(), INVALID_ENTITY);
+	if (!reader.ReadArray(m_Parents.data(), parentNmb))
+		return false;
+
+	auto& localVersions = m_Components.GetVersions();
+	auto& worldVersions = m_WorldTransforms.GetVersions();
+	for (size_t i = 0; i < localVersions.size(); i++)
+	{
+		const unsigned version = std::max(localVersions[i], worldVersions[i]) + 1;
+		localVersions[i] = version;
+		worldVersions[i] = version;
+	}
+	m_Hierarchy.clear();
+	for (size_t i = 0; i < m_Parents.size(); i++)
+	{
+		if (m_Parents[i] == INVALID_ENTITY)
+			continue;
+		//The parent may have been brought back with a new handle
+		m_Parents[i] = m_EntityManager->GetEntity(GetEntityIndex(m_Parents[i]));
+		TransformHierarchyNode node;
+		node.entity = m_EntityManager->GetEntity(static_cast<Entity>(i + 1));
+		node.parent = m_Parents[i];
+		m_Hierarchy.push_back(node);
+	}
+	m_HierarchyDirty = true;
+	UpdateWorldTransforms();
+	return true;
 }
 
 }
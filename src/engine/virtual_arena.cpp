@@ -0,0 +1,163 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <engine/virtual_arena.h>
+
+namespace sfge
+{
+
+//Pages are committed by chunks to limit the system calls of arenas growing a little every frame
+const size_t VIRTUAL_ARENA_COMMIT_CHUNK = 64 * 1024;
+
+static size_t AlignUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+VirtualArena::VirtualArena(size_t reserveSize, size_t highWaterMark) :
+    Allocator(0, nullptr), _current_pos(nullptr), _committed_memory(0)
+{
+    assert(reserveSize > 0);
+    const size_t pageSize = getPageSize();
+    const size_t size = AlignUp(reserveSize, pageSize);
+    _high_water_mark = AlignUp(highWaterMark < size ? highWaterMark : size, pageSize);
+#ifdef WIN32
+    void* start = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* start = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (start == MAP_FAILED)
+        start = nullptr;
+#endif
+    //Without reservation every allocation fails and the caller uses its fallback
+    if (start == nullptr)
+        return;
+    _start = start;
+    _size = size;
+    _current_pos = start;
+}
+
+VirtualArena::~VirtualArena()
+{
+    if (_start == nullptr)
+        return;
+#ifdef WIN32
+    VirtualFree(_start, 0, MEM_RELEASE);
+#else
+    munmap(_start, _size);
+#endif
+    _current_pos = nullptr;
+}
+
+void* VirtualArena::allocate(size_t size, ptr_type alignment)
+{
+    assert(size != 0);
+    if (_start == nullptr)
+        return nullptr;
+    ptr_type adjustment = alignForwardAdjustment(_current_pos, alignment);
+    const size_t neededSize = _used_memory + adjustment + size;
+
+    if (neededSize > _size)
+        return nullptr;
+    if (neededSize > _committed_memory && !commit(neededSize))
+        return nullptr;
+
+    ptr_type aligned_address = (ptr_type)_current_pos + adjustment;
+    _current_pos = (void*)(aligned_address + size);
+    _used_memory = neededSize;
+    _num_allocations++;
+
+    return (void*)aligned_address;
+}
+
+void VirtualArena::deallocate(void* p)
+{
+    (void)p;
+    assert( false && "Use clear() instead" );
+}
+
+void VirtualArena::clear()
+{
+    _num_allocations = 0;
+    _used_memory = 0;
+    _current_pos = _start;
+    if (_committed_memory > _high_water_mark)
+        decommit(_high_water_mark);
+}
+
+size_t VirtualArena::getPageSize()
+{
+#ifdef WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+bool VirtualArena::commit(size_t size)
+{
+    size_t committedSize = AlignUp(size, getPageSize());
+    if (committedSize < _committed_memory + VIRTUAL_ARENA_COMMIT_CHUNK)
+        committedSize = _committed_memory + VIRTUAL_ARENA_COMMIT_CHUNK;
+    if (committedSize > _size)
+        committedSize = _size;
+
+    void* begin = (char*)_start + _committed_memory;
+    const size_t length = committedSize - _committed_memory;
+#ifdef WIN32
+    if (VirtualAlloc(begin, length, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+        return false;
+#else
+    if (mprotect(begin, length, PROT_READ | PROT_WRITE) != 0)
+        return false;
+#endif
+    _committed_memory = committedSize;
+    return true;
+}
+
+void VirtualArena::decommit(size_t keptSize)
+{
+    void* begin = (char*)_start + keptSize;
+    const size_t length = _committed_memory - keptSize;
+#ifdef WIN32
+    VirtualFree(begin, length, MEM_DECOMMIT);
+#else
+    //Give the pages back to the system, they read as zero if committed again
+    madvise(begin, length, MADV_DONTNEED);
+    mprotect(begin, length, PROT_NONE);
+#endif
+    _committed_memory = keptSize;
+}
+
+}
@@ -39,6 +39,8 @@ namespace sfge
 
 void Graphics2dManager::OnEngineInit()
 {
+	//Only clears the window on update
+	SetComponentAccess(EntityMask(), EntityMask(), true);
 	if (const auto configPtr = m_Engine.GetConfig())
 	{
 		m_Windowless = configPtr->windowLess;
@@ -74,15 +76,12 @@ void Graphics2dManager::OnEngineInit()
 
 void Graphics2dManager::OnUpdate(float dt)
 {
+	(void) dt;
 	if (!m_Windowless)
 	{
 		rmt_ScopedCPUSample(Graphics2dUpdate,0)
+		//Sprites and shapes are updated by the engine scheduler
 		m_Window->clear();
-
-		m_SpriteManager.OnUpdate(dt);
-		m_ShapeManager.OnUpdate(dt);
-
-		
 	}
 }
 
@@ -159,6 +158,7 @@ void Graphics2dManager::OnBeforeSceneLoad()
 {
 	m_TextureManager.OnBeforeSceneLoad();
 	m_SpriteManager.OnBeforeSceneLoad();
+	m_ShapeManager.OnBeforeSceneLoad();
 }
 
 void Graphics2dManager::OnAfterSceneLoad()
@@ -34,6 +34,19 @@ SOFTWARE.
 namespace sfge
 {
 
+void ShapeDeleter::operator()(sf::Shape* shape) const
+{
+	if (pool != nullptr)
+	{
+		shape->~Shape();
+		pool->deallocate(shape);
+	}
+	else
+	{
+		delete shape;
+	}
+}
+
 Shape::Shape (): Shape (nullptr, sf::Vector2f())
 {
 
@@ -72,9 +85,21 @@ void Shape::Update() const
 		m_Shape->setScale(transform.Scale);
 	}
 }
-void Shape::SetShape (std::unique_ptr<sf::Shape> shape)
+void Shape::SetShape (ShapePtr shape)
 {
 	m_Shape = std::move(shape);
+	m_TransformVersion = INVALID_TRANSFORM_VERSION;
+}
+
+void Shape::SetShape (std::unique_ptr<sf::Shape> shape)
+{
+	SetShape(ShapePtr(shape.release()));
+}
+
+void Shape::SetOffset(sf::Vector2f offset)
+{
+	Offsetable::SetOffset(offset);
+	m_TransformVersion = INVALID_TRANSFORM_VERSION;
 }
 sf::Shape *Shape::GetShape ()
 {
@@ -118,7 +143,8 @@ void editor::ShapeInfo::DrawOnInspector ()
 
 void ShapeManager::OnEngineInit()
 {
-	SingleComponentManager::OnEngineInit();
+	SparseComponentManager::OnEngineInit();
+	SetComponentAccess(static_cast<EntityMask>(ComponentType::TRANSFORM2D), static_cast<EntityMask>(ComponentType::SHAPE2D), false);
 	m_Transform2dManager = m_Engine.GetTransform2dManager();
 }
 
@@ -127,12 +153,9 @@ void ShapeManager::DrawShapes(sf::RenderWindow &window)
 {
 
 	rmt_ScopedCPUSample(ShapeDraw,0)
-	for(auto i = 0u; i < m_Components.size(); i++)
+	for(auto& shape : m_Components)
 	{
-		if(m_EntityManager->HasComponent(i + 1, ComponentType::SHAPE2D))
-		{
-			m_Components[i].Draw(window);
-		}
+		shape.Draw(window);
 	}
 }
 
@@ -144,33 +167,63 @@ void ShapeManager::OnUpdate(const float dt)
 	auto* transformManager = m_Engine.GetTransform2dManager();
 	for (auto i = 0u; i < m_Components.size(); i++)
 	{
-		if (m_EntityManager->HasComponent(i + 1, ComponentType::SHAPE2D))
+		const Entity entity = m_DenseEntities[i];
+		auto& shape = m_Components[i];
+		const unsigned version = m_EntityManager->HasComponent(entity, ComponentType::TRANSFORM2D) ?
+			transformManager->GetWorldVersion(entity) : NO_TRANSFORM_VERSION;
+		//Static shapes are left untouched
+		if (version == shape.m_TransformVersion)
+			continue;
+		if (version != NO_TRANSFORM_VERSION)
 		{
-			if(m_EntityManager->HasComponent(i+1, ComponentType::TRANSFORM2D))
-			{
-				m_Components[i].transform = transformManager->GetComponentRef(i + 1);
-			}
-			m_Components[i].Update();
+			shape.transform = transformManager->GetWorldTransform(entity);
 		}
+		shape.m_TransformVersion = version;
+		shape.Update();
 	}
 	
 }
 
 void ShapeManager::OnBeforeSceneLoad()
 {
-	m_Components.clear ();
-	m_Components.resize (INIT_ENTITY_NMB);
+	ClearComponents();
+
+}
+
+ShapeManager::~ShapeManager()
+{
+	//The shapes must go back to the pool before it is destroyed
+	ClearComponents();
+}
+
+void ShapeManager::ReserveComponents(size_t componentNmb)
+{
+	SparseComponentManager::ReserveComponents(componentNmb);
+	if (componentNmb <= m_ShapePoolCapacity)
+		return;
+	if (m_ShapePool != nullptr && m_ShapePool->getNumAllocations() != 0)
+		return;
+	m_ShapePool = nullptr;
+	const size_t poolSize = componentNmb * SHAPE_OBJECT_SIZE + SHAPE_OBJECT_ALIGNMENT;
+	m_ShapeMemory = std::make_unique<char[]>(poolSize);
+	m_ShapePool = std::make_unique<PoolAllocator>(SHAPE_OBJECT_SIZE, SHAPE_OBJECT_ALIGNMENT, poolSize, m_ShapeMemory.get());
+	m_ShapePoolCapacity = componentNmb;
+}
 
+size_t ShapeManager::GetShapePoolCapacity() const
+{
+	return m_ShapePoolCapacity;
 }
 
 
 
 Shape *ShapeManager::AddComponent (Entity entity)
 {
-	auto shapePtr = GetComponentPtr (entity);
-	auto& shapeInfo = GetComponentInfo(entity);
-	shapeInfo.SetEntity(entity);
-	shapeInfo.shapeManager = this;
+	auto shapePtr = &EmplaceComponent(entity);
+	if (HasComponentInfos())
+	{
+		GetComponentInfo(entity).shapeManager = this;
+	}
 
 	m_Engine.GetEntityManager()->AddComponentType(entity, ComponentType::SHAPE2D);
 	return shapePtr;
@@ -185,12 +238,13 @@ void ShapeManager::CreateComponent(json& componentJson, Entity entity)
 		offset = GetVectorFromJson(componentJson, "offset");
 	}
 
-	auto& shape = m_Components[entity-1];
+	auto& shape = EmplaceComponent(entity);
 	shape.SetOffset(offset);
 
-	auto& shapeInfo = m_ComponentsInfo[entity - 1];
-	shapeInfo.shapeManager = this;
-	shapeInfo.SetEntity(entity);
+	if (HasComponentInfos())
+	{
+		GetComponentInfo(entity).shapeManager = this;
+	}
 
 	if (CheckJsonNumber(componentJson, "shape_type"))
 	{
@@ -206,9 +260,10 @@ void ShapeManager::CreateComponent(json& componentJson, Entity entity)
 				radius = componentJson["radius"];
 			}
 
-			auto circleShape = std::make_unique <sf::CircleShape>();
-			circleShape->setRadius (radius);
-			circleShape->setOrigin (radius, radius);
+			auto circleShape = CreateShape<sf::CircleShape>();
+			auto* circle = static_cast<sf::CircleShape*>(circleShape.get());
+			circle->setRadius (radius);
+			circle->setOrigin (radius, radius);
 			shape.SetShape (std::move(circleShape));
 			shape.Update ();
 		}
@@ -225,10 +280,11 @@ void ShapeManager::CreateComponent(json& componentJson, Entity entity)
 			{
 				size = GetVectorFromJson(componentJson, "size");
 			}
-			auto rect = std::make_unique<sf::RectangleShape>();
+			auto rectShape = CreateShape<sf::RectangleShape>();
+			auto* rect = static_cast<sf::RectangleShape*>(rectShape.get());
 			rect->setSize (size);
 			rect->setOrigin (size.x/2.0f, size.y/2.0f);
-            shape.SetShape (std::move (rect));
+            shape.SetShape (std::move (rectShape));
             shape.Update ();
 			
 		}
@@ -250,13 +306,8 @@ void ShapeManager::CreateComponent(json& componentJson, Entity entity)
 
 void ShapeManager::DestroyComponent(Entity entity)
 {
-	(void) entity;
-}
-
-void ShapeManager::OnResize(size_t new_size)
-{
-	m_Components.resize(new_size);
-	m_ComponentsInfo.resize(new_size);
+	RemoveComponent(entity);
+	m_EntityManager->RemoveComponentType(entity, ComponentType::SHAPE2D);
 }
 
 }
@@ -49,13 +49,24 @@ void Sprite::Draw(sf::RenderWindow& window)
 {
 	window.draw(sprite);
 }
-void Sprite::SetTexture(sf::Texture* newTexture)
+void Sprite::SetTexture(sf::Texture* newTexture, TextureId textureId)
 {
+	m_TextureId = textureId;
 	sprite.setTexture(*newTexture);
 
 	sprite.setOrigin(sf::Vector2f(sprite.getLocalBounds().width, sprite.getLocalBounds().height) / 2.0f);
 }
 
+TextureId Sprite::GetTextureId() const
+{
+	return m_TextureId;
+}
+
+void Sprite::SetOffset(sf::Vector2f offset)
+{
+	Offsetable::SetOffset(offset);
+	m_TransformVersion = INVALID_TRANSFORM_VERSION;
+}
 
 void Sprite::Init()
 {
@@ -90,7 +101,8 @@ void editor::SpriteInfo::DrawOnInspector()
 
 void SpriteManager::OnEngineInit()
 {
-	SingleComponentManager::OnEngineInit();
+	SparseComponentManager::OnEngineInit();
+	SetComponentAccess(static_cast<EntityMask>(ComponentType::TRANSFORM2D), static_cast<EntityMask>(ComponentType::SPRITE2D), false);
 	m_GraphicsManager = m_Engine.GetGraphics2dManager();
 	m_Transform2dManager = m_Engine.GetTransform2dManager();
 
@@ -98,11 +110,7 @@ void SpriteManager::OnEngineInit()
 
 Sprite* SpriteManager::AddComponent(Entity entity)
 {
-	auto& sprite = GetComponentRef(entity);
-	auto& spriteInfo = GetComponentInfo(entity);
-
-	//sprite.SetTransform(m_Transform2dManager->GetComponentPtr(entity));
-	//spriteInfo.sprite = &sprite;
+	auto& sprite = EmplaceComponent(entity);
 
 	m_EntityManager->AddComponentType(entity, ComponentType::SPRITE2D);
 	return &sprite;
@@ -117,14 +125,19 @@ void SpriteManager::OnUpdate(float dt)
 	auto* transformManager = m_Engine.GetTransform2dManager();
 	for(auto i = 0u; i < m_Components.size();i++)
 	{
-		if(m_EntityManager->HasComponent(i+1, ComponentType::SPRITE2D))
+		const Entity entity = m_DenseEntities[i];
+		auto& sprite = m_Components[i];
+		const unsigned version = m_EntityManager->HasComponent(entity, ComponentType::TRANSFORM2D) ?
+			transformManager->GetWorldVersion(entity) : NO_TRANSFORM_VERSION;
+		//Static sprites are left untouched
+		if (version == sprite.m_TransformVersion)
+			continue;
+		if (version != NO_TRANSFORM_VERSION)
 		{
-			if(m_EntityManager->HasComponent(i+1, ComponentType::TRANSFORM2D))
-			{
-				m_Components[i].transform = transformManager->GetComponentRef(i + 1);
-			}
-			m_Components[i].Update();
+			sprite.transform = transformManager->GetWorldTransform(entity);
 		}
+		sprite.m_TransformVersion = version;
+		sprite.Update();
 	}
 }
 
@@ -133,16 +146,16 @@ void SpriteManager::DrawSprites(sf::RenderWindow &window)
 {
 
 	rmt_ScopedCPUSample(SpriteDraw,0)
-	for (auto i = 0u; i < m_Components.size();i++)
+	for (auto& sprite : m_Components)
 	{
-		if(m_EntityManager->HasComponent(i + 1, ComponentType::SPRITE2D))
-			m_Components[i].Draw(window);
+		sprite.Draw(window);
 	}
 	
 }
 
 void SpriteManager::OnBeforeSceneLoad()
 {
+	ClearComponents();
 }
 
 void SpriteManager::OnAfterSceneLoad()
@@ -152,62 +165,177 @@ void SpriteManager::OnAfterSceneLoad()
 
 void SpriteManager::CreateComponent(json& componentJson, Entity entity)
 {
-	auto & newSprite = m_Components[entity - 1];
-	auto & newSpriteInfo = m_ComponentsInfo[entity - 1];
+	auto & newSprite = EmplaceComponent(entity);
+	const TextureId textureId = LoadComponentTexture(componentJson);
+	if (textureId != INVALID_TEXTURE)
+	{
+		newSprite.SetTexture(m_GraphicsManager->GetTextureManager()->GetTexture(textureId), textureId);
+	}
+	if (HasComponentInfos())
+	{
+		auto& newSpriteInfo = GetComponentInfo(entity);
+		newSpriteInfo.textureId = textureId;
+		if (CheckJsonParameter(componentJson, "path", json::value_t::string))
+		{
+			newSpriteInfo.texturePath = componentJson["path"].get<std::string>();
+		}
+	}
+	if (CheckJsonParameter(componentJson, "layer", json::value_t::number_integer))
+	{
+		newSprite.SetLayer(componentJson["layer"]);
+	}
+
+}
+
+void SpriteManager::CreateComponents(json& componentJson, const std::vector<Entity>& entities)
+{
+	rmt_ScopedCPUSample(SpriteCreateComponents, 0);
+	//The texture and the layer are shared by all the new sprites
+	const TextureId textureId = LoadComponentTexture(componentJson);
+	sf::Texture* texture = textureId != INVALID_TEXTURE ? m_GraphicsManager->GetTextureManager()->GetTexture(textureId) : nullptr;
+	std::string texturePath;
 	if (CheckJsonParameter(componentJson, "path", json::value_t::string))
 	{
-		std::string path = componentJson["path"].get<std::string>();
-		newSpriteInfo.texturePath = path;
-		sf::Texture* texture = nullptr;
-		if (FileExists(path))
+		texturePath = componentJson["path"].get<std::string>();
+	}
+	int layer = 0;
+	const bool hasLayer = CheckJsonParameter(componentJson, "layer", json::value_t::number_integer);
+	if (hasLayer)
+	{
+		layer = componentJson["layer"];
+	}
+	ReserveComponents(m_DenseEntities.size() + entities.size());
+	const bool hasComponentInfos = HasComponentInfos();
+	for (const Entity entity : entities)
+	{
+		auto& newSprite = EmplaceComponent(entity);
+		if (texture != nullptr)
 		{
-			auto* textureManager = m_GraphicsManager->GetTextureManager();
-			const TextureId textureId = textureManager->LoadTexture(path);
-			if (textureId != INVALID_TEXTURE)
-			{
-				/*{
-					std::ostringstream oss;
-					oss << "Loading Sprite with Texture at: " << path << " with texture id: " << textureId;
-					sfge::Log::GetInstance()->Msg(oss.str());
-				}*/
-				texture = textureManager->GetTexture(textureId);
-				newSprite.SetTexture(texture);
-				//newSprite.SetTransform(m_Transform2dManager->GetComponentPtr(entity));
-				newSpriteInfo.textureId = textureId;
-			}
-			else
-			{
-				std::ostringstream oss;
-				oss << "Texture file " << path << " cannot be loaded";
-				Log::GetInstance()->Error(oss.str());
-			}
+			newSprite.SetTexture(texture, textureId);
 		}
-		else
+		if (hasLayer)
 		{
-			std::ostringstream oss;
-			oss << "Texture file " << path << " does not exist";
-			Log::GetInstance()->Error(oss.str());
+			newSprite.SetLayer(layer);
+		}
+		if (hasComponentInfos)
+		{
+			auto& newSpriteInfo = GetComponentInfo(entity);
+			newSpriteInfo.textureId = textureId;
+			newSpriteInfo.texturePath = texturePath;
 		}
 	}
-	else
+}
+
+TextureId SpriteManager::LoadComponentTexture(json& componentJson)
+{
+	if (!CheckJsonParameter(componentJson, "path", json::value_t::string))
 	{
 		Log::GetInstance()->Error("[Error] No Path for Sprite");
+		return INVALID_TEXTURE;
 	}
-	if (CheckJsonParameter(componentJson, "layer", json::value_t::number_integer))
+	const std::string path = componentJson["path"].get<std::string>();
+	if (!FileExists(path))
 	{
-		newSprite.SetLayer(componentJson["layer"]);
+		std::ostringstream oss;
+		oss << "Texture file " << path << " does not exist";
+		Log::GetInstance()->Error(oss.str());
+		return INVALID_TEXTURE;
 	}
+	const TextureId textureId = m_GraphicsManager->GetTextureManager()->LoadTexture(path);
+	if (textureId == INVALID_TEXTURE)
+	{
+		std::ostringstream oss;
+		oss << "Texture file " << path << " cannot be loaded";
+		Log::GetInstance()->Error(oss.str());
+	}
+	return textureId;
+}
 
+void SpriteManager::SaveSnapshot(WorldSnapshot& snapshot)
+{
+	const size_t spriteNmb = m_DenseEntities.size();
+	m_SnapshotTextureIds.resize(spriteNmb);
+	m_SnapshotLayers.resize(spriteNmb);
+	m_SnapshotOffsets.resize(spriteNmb);
+	for (size_t i = 0; i < spriteNmb; i++)
+	{
+		m_SnapshotTextureIds[i] = m_Components[i].GetTextureId();
+		m_SnapshotLayers[i] = m_Components[i].GetLayer();
+		m_SnapshotOffsets[i] = m_Components[i].GetOffset();
+	}
+	snapshot.Write(spriteNmb);
+	snapshot.WriteArray(m_DenseEntities.data(), spriteNmb);
+	snapshot.WriteArray(m_SnapshotTextureIds.data(), spriteNmb);
+	snapshot.WriteArray(m_SnapshotLayers.data(), spriteNmb);
+	snapshot.WriteArray(m_SnapshotOffsets.data(), spriteNmb);
 }
 
-void SpriteManager::DestroyComponent(Entity entity)
+bool SpriteManager::CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const
 {
-	(void) entity;
+	(void) entityNmb;
+	size_t spriteNmb = 0;
+	return reader.Read(spriteNmb) &&
+		reader.SkipArray<Entity>(spriteNmb) &&
+		reader.SkipArray<TextureId>(spriteNmb) &&
+		reader.SkipArray<int>(spriteNmb) &&
+		reader.SkipArray<Vec2f>(spriteNmb);
 }
 
-void SpriteManager::OnResize(size_t new_size)
+bool SpriteManager::RestoreSnapshot(WorldSnapshot::Reader& reader)
+{
+	rmt_ScopedCPUSample(SpriteRestoreSnapshot, 0);
+	size_t spriteNmb = 0;
+	if (!reader.Read(spriteNmb))
+		return false;
+	m_SnapshotEntities.resize(spriteNmb);
+	m_SnapshotTextureIds.resize(spriteNmb);
+	m_SnapshotLayers.resize(spriteNmb);
+	m_SnapshotOffsets.resize(spriteNmb);
+	if (!reader.ReadArray(m_SnapshotEntities.data(), spriteNmb) ||
+		!reader.ReadArray(m_SnapshotTextureIds.data(), spriteNmb) ||
+		!reader.ReadArray(m_SnapshotLayers.data(), spriteNmb) ||
+		!reader.ReadArray(m_SnapshotOffsets.data(), spriteNmb))
+		return false;
+	//Entities brought back in a slot used since the snapshot have a new handle
+	for (auto& entity : m_SnapshotEntities)
+	{
+		entity = m_EntityManager->GetEntity(GetEntityIndex(entity));
+	}
+
+	auto* textureManager = m_GraphicsManager->GetTextureManager();
+	if (m_SnapshotEntities != m_DenseEntities)
+	{
+		//Sprites were added or removed since the snapshot, they are rebuilt from their texture ids
+		ClearComponents();
+		for (size_t i = 0; i < spriteNmb; i++)
+		{
+			EmplaceComponent(m_SnapshotEntities[i]);
+		}
+	}
+	const bool hasComponentInfos = HasComponentInfos();
+	for (size_t i = 0; i < spriteNmb; i++)
+	{
+		auto& sprite = m_Components[i];
+		const TextureId textureId = m_SnapshotTextureIds[i];
+		if (sprite.GetTextureId() != textureId && textureId != INVALID_TEXTURE)
+		{
+			sprite.SetTexture(textureManager->GetTexture(textureId), textureId);
+		}
+		sprite.SetLayer(m_SnapshotLayers[i]);
+		sprite.SetOffset(m_SnapshotOffsets[i]);
+		if (hasComponentInfos)
+		{
+			auto& spriteInfo = m_ComponentsInfo[i];
+			spriteInfo.textureId = textureId;
+			spriteInfo.texturePath = textureId != INVALID_TEXTURE ? textureManager->GetTexturePath(textureId) : "";
+		}
+	}
+	return true;
+}
+
+void SpriteManager::DestroyComponent(Entity entity)
 {
-	m_Components.resize(new_size);
-	m_ComponentsInfo.resize(new_size);
+	RemoveComponent(entity);
+	m_EntityManager->RemoveComponentType(entity, ComponentType::SPRITE2D);
 }
 }
@@ -57,6 +57,7 @@ static std::set<std::string> imgExtensionSet
 void TextureManager::OnEngineInit()
 {
 	System::OnEngineInit();
+	m_Engine.GetMemoryManager()->AddMemoryReporter(this);
 	if(const auto config = m_Engine.GetConfig())
 	{
 		if(config->devMode)
@@ -101,12 +102,10 @@ TextureId TextureManager::LoadTexture(std::string filename)
 	}
 
 	auto textureId = INVALID_TEXTURE;
-	for (TextureId checkedId = 1U; checkedId <= m_IncrementId; checkedId++)
+	const auto textureIdIt = m_TextureIds.find(filename);
+	if (textureIdIt != m_TextureIds.end())
 	{
-		if (filename == m_TexturePaths[checkedId-1])
-		{
-			textureId = checkedId;
-		}
+		textureId = textureIdIt->second;
 	}
 	//Was or still is loaded
 	if (textureId != INVALID_TEXTURE)
@@ -129,7 +128,7 @@ TextureId TextureManager::LoadTexture(std::string filename)
 				return INVALID_TEXTURE;
 			}
 			m_TextureIdsRefCounts[textureId-1] = 1U;
-			return m_IncrementId;
+			return textureId;
 		}
 	}
 	//Texture was never loaded
@@ -146,6 +145,7 @@ TextureId TextureManager::LoadTexture(std::string filename)
 		}
 
 		m_TexturePaths[textureId-1] = filename;
+		m_TextureIds[filename] = textureId;
 		m_TextureIdsRefCounts[textureId-1] = 1U;
 
 		m_IncrementId++;
@@ -165,6 +165,24 @@ sf::Texture* TextureManager::GetTexture(TextureId textureId)
 	return &m_Textures[textureId-1];
 }
 
+void TextureManager::ReportMemory(MemoryTracker& memoryTracker) const
+{
+	size_t pixelBytes = 0;
+	for (TextureId textureId = 1; textureId <= m_IncrementId && textureId <= m_Textures.size(); textureId++)
+	{
+		const sf::Vector2u size = m_Textures[textureId - 1].getSize();
+		pixelBytes += size_t(size.x) * size.y * 4;
+	}
+	memoryTracker.ReportFootprint(MemoryTag::TEXTURES, "Textures", pixelBytes);
+	memoryTracker.ReportFootprint(MemoryTag::TEXTURES, "Texture cache",
+		GetContainerFootprint(m_TexturePaths) + GetContainerFootprint(m_Textures) + GetContainerFootprint(m_TextureIdsRefCounts));
+}
+
+const std::string& TextureManager::GetTexturePath(TextureId textureId) const
+{
+	return m_TexturePaths[textureId-1];
+}
+
 bool TextureManager::HasValidExtension(std::string filename)
 {
 	const std::string::size_type filenameExtensionIndex = filename.find_last_of('.');
@@ -35,7 +35,7 @@ Body2d::Body2d() : Offsetable(sf::Vector2f())
 {
 }
 
-Body2d::Body2d(Transform2d *transform, Vec2f offset) : Offsetable(offset)
+Body2d::Body2d(Transform2dPtr transform, Vec2f offset) : Offsetable(offset)
 {
 	
 }
@@ -155,16 +155,57 @@ void Body2dManager::OnEngineInit()
 
 void Body2dManager::OnFixedUpdate()
 {
-	for (auto i = 0u; i < m_Components.size(); i++)
+	const auto& bodyView = m_EntityManager->GetView<ComponentType::BODY2D, ComponentType::TRANSFORM2D>();
+	const size_t bodyNmb = bodyView.Size();
+	//The velocity graphs are editor only
+	const bool hasComponentInfos = HasComponentInfos();
+	//Scratch buffers only grow, no allocation once warmed up
+	if (m_PositionsX.size() < bodyNmb)
 	{
-		const Entity entity = i + 1;
-		if (m_EntityManager->HasComponent(entity, ComponentType::BODY2D) &&
-			m_EntityManager->HasComponent(entity, ComponentType::TRANSFORM2D))
+		m_PositionsX.resize(bodyNmb);
+		m_PositionsY.resize(bodyNmb);
+		m_OffsetsX.resize(bodyNmb);
+		m_OffsetsY.resize(bodyNmb);
+	}
+	for (size_t i = 0; i < bodyNmb; i++)
+	{
+		const Entity entity = bodyView.GetEntities()[i];
+		auto & body2d = GetComponentRef(entity);
+		if (hasComponentInfos)
+		{
+			GetComponentInfo(entity).AddVelocity(body2d.GetBody()->GetLinearVelocity());
+		}
+		const auto bodyPosition = body2d.GetBody()->GetPosition();
+		const auto offset = body2d.GetOffset();
+		m_PositionsX[i] = bodyPosition.x;
+		m_PositionsY[i] = bodyPosition.y;
+		m_OffsetsX[i] = offset.x;
+		m_OffsetsY[i] = offset.y;
+	}
+	MetersToPixels(m_PositionsX.data(), m_PositionsY.data(), m_OffsetsX.data(), m_OffsetsY.data(),
+		m_PositionsX.data(), m_PositionsY.data(), bodyNmb, Physics2dManager::pixelPerMeter);
+
+	auto& transforms = m_Transform2dManager->GetComponents();
+	auto& transformsX = transforms.GetPositionsX();
+	auto& transformsY = transforms.GetPositionsY();
+	for (size_t i = 0; i < bodyNmb; i++)
+	{
+		const Entity entity = bodyView.GetEntities()[i];
+		const auto index = GetEntityIndex(entity) - 1;
+		//Bodies are in world space, children go back to the space of their parent
+		if (m_Transform2dManager->GetParent(entity) != INVALID_ENTITY)
+		{
+			const Vec2f position(m_PositionsX[i], m_PositionsY[i]);
+			if (m_Transform2dManager->GetWorldTransform(entity).Position != position)
+				m_Transform2dManager->SetWorldPosition(entity, position);
+			continue;
+		}
+		//Sleeping and static bodies keep their transform version
+		if (transformsX[index] != m_PositionsX[i] || transformsY[index] != m_PositionsY[i])
 		{
-			auto & transform = m_Transform2dManager->GetComponentRef(entity);
-			auto & body2d = GetComponentRef(entity);
-			m_ComponentsInfo[i].AddVelocity(body2d.GetBody()->GetLinearVelocity());
-			transform.Position = meter2pixel(body2d.GetBody()->GetPosition()) - static_cast<sf::Vector2f>(body2d.GetOffset());
+			transformsX[index] = m_PositionsX[i];
+			transformsY[index] = m_PositionsY[i];
+			transforms.MarkChanged(index);
 		}
 	}
 }
@@ -176,21 +217,24 @@ Body2d* Body2dManager::AddComponent(Entity entity)
 		p2BodyDef bodyDef;
 		bodyDef.type = p2BodyType::STATIC;
 
-		auto* transform = m_Transform2dManager->GetComponentPtr(entity);
-		const auto pos = transform->Position;
+		auto transform = m_Transform2dManager->GetComponentPtr(entity);
+		const Vec2f pos = m_Transform2dManager->GetWorldTransform(entity).Position;
 		bodyDef.position = pixel2meter(pos);
 
 		auto* body = world->CreateBody(&bodyDef);
-		m_Components[entity - 1] = Body2d(transform, sf::Vector2f());
-		m_Components[entity - 1].SetBody(body);
+		m_Components[GetEntityIndex(entity) - 1] = Body2d(transform, sf::Vector2f());
+		m_Components[GetEntityIndex(entity) - 1].SetBody(body);
 
-		auto& componentInfo = m_ComponentsInfo[entity-1];
-		componentInfo.bodyManager = this;
-		componentInfo.SetEntity(entity);
-		componentInfo.name = "Body";
+		if (HasComponentInfos())
+		{
+			auto& componentInfo = GetComponentInfo(entity);
+			componentInfo.bodyManager = this;
+			componentInfo.SetEntity(entity);
+			componentInfo.name = "Body";
+		}
 
 		m_EntityManager->AddComponentType(entity, ComponentType::BODY2D);
-		return &m_Components[entity - 1];
+		return &m_Components[GetEntityIndex(entity) - 1];
 	}
 	return nullptr;
 }
@@ -213,18 +257,35 @@ void Body2dManager::CreateComponent(json& componentJson, Entity entity)
 		const auto offset = GetVectorFromJson(componentJson, "offset");
 		const auto velocity = GetVectorFromJson(componentJson, "velocity");
 
-		auto* transform = m_Transform2dManager->GetComponentPtr(entity);
-		const auto pos = transform->Position + offset;
+		auto transform = m_Transform2dManager->GetComponentPtr(entity);
+		const auto pos = m_Transform2dManager->GetWorldTransform(entity).Position + offset;
 		bodyDef.position = pixel2meter(pos);
 		
 		auto* body = world->CreateBody(&bodyDef);
 		body->SetLinearVelocity(pixel2meter(velocity));
-		m_Components[entity - 1] = Body2d(transform, offset);
-		m_Components[entity - 1].SetBody(body);
+		m_Components[GetEntityIndex(entity) - 1] = Body2d(transform, offset);
+		m_Components[GetEntityIndex(entity) - 1].SetBody(body);
 
 
-		m_ComponentsInfo[entity - 1].bodyManager = this;
-		m_ComponentsInfo[entity - 1].SetEntity(entity);
+		if (HasComponentInfos())
+		{
+			auto& componentInfo = GetComponentInfo(entity);
+			componentInfo.bodyManager = this;
+			componentInfo.SetEntity(entity);
+		}
+	}
+}
+
+void Body2dManager::OnInstantiated(const std::vector<Entity>& entities)
+{
+	for (const Entity entity : entities)
+	{
+		auto* body = m_Components[GetEntityIndex(entity) - 1].GetBody();
+		if (body == nullptr)
+			continue;
+		const Vec2f position = m_Transform2dManager->GetWorldTransform(entity).Position +
+			m_Components[GetEntityIndex(entity) - 1].GetOffset();
+		body->SetPosition(pixel2meter(position));
 	}
 }
 
@@ -235,8 +296,53 @@ void Body2dManager::DestroyComponent(Entity entity)
 
 void Body2dManager::OnResize(size_t new_size)
 {
-	m_Components.resize(new_size);
-	m_ComponentsInfo.resize(new_size);
+	SingleComponentManager::OnResize(new_size);
+}
+
+void Body2dManager::SaveSnapshot(WorldSnapshot& snapshot)
+{
+	const size_t bodyNmb = m_Components.size();
+	m_SnapshotPositions.resize(bodyNmb);
+	m_SnapshotVelocities.resize(bodyNmb);
+	for (size_t i = 0; i < bodyNmb; i++)
+	{
+		auto* body = m_Components[i].GetBody();
+		m_SnapshotPositions[i] = body != nullptr ? body->GetPosition() : p2Vec2();
+		m_SnapshotVelocities[i] = body != nullptr ? body->GetLinearVelocity() : p2Vec2();
+	}
+	snapshot.Write(bodyNmb);
+	snapshot.WriteArray(m_SnapshotPositions.data(), bodyNmb);
+	snapshot.WriteArray(m_SnapshotVelocities.data(), bodyNmb);
+}
+
+bool Body2dManager::CheckSnapshot(WorldSnapshot::Reader& reader, size_t& entityNmb) const
+{
+	size_t bodyNmb = 0;
+	return reader.Read(bodyNmb) && bodyNmb <= std::max(entityNmb, m_Components.size()) &&
+		reader.SkipArray<p2Vec2>(bodyNmb) &&
+		reader.SkipArray<p2Vec2>(bodyNmb);
+}
+
+bool Body2dManager::RestoreSnapshot(WorldSnapshot::Reader& reader)
+{
+	size_t bodyNmb = 0;
+	if (!reader.Read(bodyNmb) || bodyNmb > m_Components.size())
+		return false;
+	m_SnapshotPositions.resize(bodyNmb);
+	m_SnapshotVelocities.resize(bodyNmb);
+	if (!reader.ReadArray(m_SnapshotPositions.data(), bodyNmb) ||
+		!reader.ReadArray(m_SnapshotVelocities.data(), bodyNmb))
+		return false;
+	//The p2Body are never destroyed, so every saved body is still there
+	for (size_t i = 0; i < bodyNmb; i++)
+	{
+		auto* body = m_Components[i].GetBody();
+		if (body == nullptr)
+			continue;
+		body->SetPosition(m_SnapshotPositions[i]);
+		body->SetLinearVelocity(m_SnapshotVelocities[i]);
+	}
+	return true;
 }
 }
 
@@ -114,7 +114,31 @@ void ColliderManager::CreateComponent(json& componentJson, Entity entity)
 					boxShape->SetSize({ size.x / 2.0f, size.y / 2.0f });
 				}
 				shape = std::move(boxShape);
-			}	
+			}
+			break;
+			case ColliderType::POLYGON:
+			{
+				auto polygonShape = std::make_unique<p2PolygonShape>();
+				std::vector<p2Vec2> points;
+				if (CheckJsonParameter(componentJson, "points", json::value_t::array))
+				{
+					for (auto& pointJson : componentJson["points"])
+					{
+						if (pointJson.size() == 2 && IsJsonValueNumeric(pointJson[0]) && IsJsonValueNumeric(pointJson[1]))
+						{
+							points.push_back(pixel2meter(sf::Vector2f(static_cast<float>(pointJson[0]), static_cast<float>(pointJson[1]))));
+						}
+					}
+				}
+				if (!polygonShape->SetVertices(points.data(), static_cast<int>(points.size())))
+				{
+					std::ostringstream oss;
+					oss << "[Error] Polygon collider needs at least 3 distinct points forming a convex polygon, json: " << componentJson;
+					Log::GetInstance()->Error(oss.str());
+					break;
+				}
+				shape = std::move(polygonShape);
+			}
 			break;
 			default:
 			{
@@ -137,14 +161,23 @@ void ColliderManager::CreateComponent(json& componentJson, Entity entity)
 			if(index != -1)
 			{
 				auto* fixture = body.GetBody()->CreateCollider(&fixtureDef);
-
+				if (fixture == nullptr)
+				{
+					std::ostringstream oss;
+					oss << "[Error] Body of entity: " << entity << " has no free collider left";
+					Log::GetInstance()->Error(oss.str());
+					return;
+				}
 
 				ColliderData& colliderData = m_Components[index];
 				colliderData.entity = entity;
 				colliderData.fixture = fixture;
 				colliderData.body = body.GetBody();
-				m_ComponentsInfo[index].data = &colliderData;
-				m_ComponentsInfo[index].SetEntity(entity);
+				if (HasComponentInfos())
+				{
+					m_ComponentsInfo[index].data = &colliderData;
+					m_ComponentsInfo[index].SetEntity(entity);
+				}
 				fixture->SetUserData(&colliderData);
 				std::cout << "Added the fixture to the collider\n";
 			}
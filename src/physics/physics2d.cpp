@@ -34,21 +34,22 @@ const float Physics2dManager::pixelPerMeter = 100.0f;
 
 void Physics2dManager::OnEngineInit()
 {
-	p2Vec2 gravity;
-	p2Vec2 screenResolution;
+	p2WorldDef worldDef;
 
 	if (const auto configPtr = m_Engine.GetConfig())
 	{
-		gravity = configPtr->gravity;
-		screenResolution = p2Vec2(static_cast<float>(configPtr->screenResolution.x), static_cast<float>(configPtr->screenResolution.y));
+		worldDef.gravity = configPtr->gravity;
+		worldDef.screenResolution = p2Vec2(static_cast<float>(configPtr->screenResolution.x), static_cast<float>(configPtr->screenResolution.y));
+		worldDef.broadPhaseType = configPtr->broadPhaseType;
 	}
 
-	m_World = std::make_shared<p2World>(gravity, screenResolution);
+	m_World = std::make_shared<p2World>(worldDef);
 	m_ContactListener = std::make_unique<ContactListener>(m_Engine);
 	m_World->SetContactListener(m_ContactListener.get());
 
 	m_BodyManager.OnEngineInit();
 	m_ColliderManager.OnEngineInit();
+	m_Engine.GetMemoryManager()->AddMemoryReporter(this);
 }
 
 void Physics2dManager::OnUpdate(float dt)
@@ -106,6 +107,14 @@ ColliderManager* Physics2dManager::GetColliderManager()
 {
 	return &m_ColliderManager;
 }
+
+void Physics2dManager::ReportMemory(MemoryTracker& memoryTracker) const
+{
+	if (m_World != nullptr)
+	{
+		memoryTracker.ReportFootprint(MemoryTag::PHYSICS, "p2World", m_World->GetMemoryFootprint());
+	}
+}
 /*
 float Physics2dManager::Raycast(Vec2f startPoint, Vec2f direction, float rayLength)
 {
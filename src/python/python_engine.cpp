@@ -40,6 +40,8 @@
 #include <utility/log.h>
 #include <engine/scene.h>
 #include <engine/engine.h>
+#include <engine/snapshot.h>
+#include <engine/prefab.h>
 #include <engine/config.h>
 #include <input/input.h>
 #include <audio/audio.h>
@@ -61,14 +63,32 @@
 namespace sfge
 {
 
+/**
+ * \brief Python iterator over the entities of an EntityView when the loop started.
+ * Scripts can destroy entities or add components while looping, the entities that left the view are skipped
+ */
+struct EntityViewIterator
+{
+	const EntityView* view;
+	std::vector<Entity> entities;
+	size_t index = 0;
+};
+
 PYBIND11_EMBEDDED_MODULE(SFGE, m)
 {
+	py::class_<WorldSnapshot> worldSnapshot(m, "WorldSnapshot");
+	worldSnapshot
+		.def(py::init<>())
+		.def("is_empty", &WorldSnapshot::IsEmpty);
+
 	py::class_<Engine> engine(m, "Engine");
 	engine
 		.def_property_readonly("config", [](Engine* engine)
 	{
 		return engine->GetConfig();
-	}, py::return_value_policy::reference);
+	}, py::return_value_policy::reference)
+		.def("save_snapshot", &Engine::SaveSnapshot)
+		.def("restore_snapshot", &Engine::RestoreSnapshot);
 
 	py::class_<Configuration, std::unique_ptr<Configuration, py::nodelete>> config(m, "Configuration");
 	config
@@ -82,11 +102,34 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 		.def("on_draw", &System::OnDraw)
 		.def("on_contact", &System::OnContact);
 
+	py::class_<Prefab> prefab(m, "Prefab");
+	prefab
+		.def(py::init<>())
+		.def_property("name", &Prefab::GetName, &Prefab::SetName)
+		.def("add_component", [](Prefab* prefab, py::object componentType, const std::string& componentJson)
+		{
+			//Builtin ComponentType or id from register_component_type, componentJson as in a scene file
+			const auto componentTypeId = py::isinstance<ComponentType>(componentType) ?
+				GetComponentTypeId(componentType.cast<ComponentType>()) :
+				componentType.cast<ComponentTypeId>();
+			prefab->AddComponent(componentTypeId, componentJson.empty() ? json::object() : json::parse(componentJson));
+		}, py::arg("component_type"), py::arg("component_json") = "");
+
 	py::class_<SceneManager> sceneManager(m, "SceneManager");
 	sceneManager
 		.def(py::init<Engine&>(), py::return_value_policy::reference)
 		.def("load_scene", &SceneManager::LoadSceneFromName)
-		.def("get_scenes", &SceneManager::GetAllScenes);
+		.def("get_scenes", &SceneManager::GetAllScenes)
+		.def("instantiate", [](SceneManager* sceneManager, const Prefab& prefab, size_t count, py::object initializer)
+		{
+			//Python initializers hold the GIL, they always run on the main thread
+			if (initializer.is_none())
+				return sceneManager->Instantiate(prefab, count);
+			return sceneManager->Instantiate(prefab, count, [&initializer](Entity entity, size_t instanceIndex)
+			{
+				initializer(entity, instanceIndex);
+			});
+		}, py::arg("prefab"), py::arg("count"), py::arg("initializer") = py::none());
 
 	py::class_<InputManager> inputManager(m, "InputManager");
 	inputManager
@@ -118,18 +161,90 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 	py::class_<Transform2dManager> transform2dManager(m , "Transform2dManager");
 	transform2dManager
 	    .def(py::init<Engine&>(), py::return_value_policy::reference)
-		.def("add_component", &Transform2dManager::AddComponent, py::return_value_policy::reference)
-	    .def("get_component", &Transform2dManager::GetComponentRef, py::return_value_policy::reference);
+		.def("add_component", [](Transform2dManager* transformManager, Entity entity)
+		{
+			return *transformManager->AddComponent(entity);
+		})
+	    .def("get_component", &Transform2dManager::GetComponentRef)
+		.def("translate_all", &Transform2dManager::TranslateAll)
+		.def("set_parent", &Transform2dManager::SetParent)
+		.def("get_parent", &Transform2dManager::GetParent)
+		.def("get_world_position", [](Transform2dManager* transformManager, Entity entity)
+		{
+			return transformManager->GetWorldTransform(entity).Position;
+		});
 
 	py::class_<EntityManager> entityManager(m, "EntityManager");
 	entityManager
 	    .def(py::init<Engine&>(), py::return_value_policy::reference)
 	    .def("create_entity", &EntityManager::CreateEntity)
 	    .def("destroy_entity", &EntityManager::DestroyEntity)
+		.def("destroy_entities", &EntityManager::DestroyEntities)
+		.def("is_entity_valid", &EntityManager::IsEntityValid)
 		.def("get_entity", &EntityManager::GetEntityByName)
-	    .def("has_component", &EntityManager::HasComponent)
+		.def("set_entity_name", &EntityManager::SetEntityName)
+		.def("get_entity_name", &EntityManager::GetEntityName)
+	    .def("has_component", py::overload_cast<Entity, ComponentType>(&EntityManager::HasComponent))
+		.def("has_component_id", py::overload_cast<Entity, ComponentTypeId>(&EntityManager::HasComponent))
+		.def("add_component_id", py::overload_cast<Entity, ComponentTypeId>(&EntityManager::AddComponentType))
+		.def("remove_component_id", py::overload_cast<Entity, ComponentTypeId>(&EntityManager::RemoveComponentType))
+		.def("register_component_type", [](EntityManager* entityManager, const std::string& typeName)
+		{
+			return entityManager->GetComponentTypeRegistry().RegisterType(typeName);
+		})
+		.def("get_component_type_id", [](EntityManager* entityManager, const std::string& typeName)
+		{
+			return entityManager->GetComponentTypeRegistry().GetTypeId(typeName);
+		})
+		.def("create_entities", &EntityManager::CreateEntities)
 		.def("resize", &EntityManager::ResizeEntityNmb)
-		.def("get_entities_with_type", &EntityManager::GetEntitiesWithType);
+		.def("get_entities_with_type", &EntityManager::GetEntitiesWithType)
+		.def("get_view", [](EntityManager* entityManager, py::args componentTypes)
+		{
+			EntityMask mask;
+			for (auto& componentType : componentTypes)
+			{
+				//Builtin ComponentType or id from register_component_type
+				if (py::isinstance<ComponentType>(componentType))
+					mask.Set(GetComponentTypeId(componentType.cast<ComponentType>()));
+				else
+					mask.Set(componentType.cast<ComponentTypeId>());
+			}
+			return &entityManager->GetView(mask);
+		}, py::return_value_policy::reference);
+
+	py::class_<EntityView> entityView(m, "EntityView");
+	entityView
+		.def("__len__", &EntityView::Size)
+		.def("__iter__", [](const EntityView& view)
+		{
+			return EntityViewIterator{ &view, std::vector<Entity>(view.begin(), view.end()) };
+		})
+		.def("__contains__", &EntityView::Contains)
+		.def_property_readonly("mask", [](const EntityView& view)
+		{
+			std::vector<ComponentTypeId> componentTypeIds;
+			for (ComponentTypeId componentTypeId = 0; componentTypeId < MAX_COMPONENT_TYPES; componentTypeId++)
+			{
+				if (view.GetMask().Test(componentTypeId))
+					componentTypeIds.push_back(componentTypeId);
+			}
+			return componentTypeIds;
+		});
+
+	py::class_<EntityViewIterator> entityViewIterator(m, "EntityViewIterator");
+	entityViewIterator
+		.def("__iter__", [](EntityViewIterator& iterator) -> EntityViewIterator& { return iterator; })
+		.def("__next__", [](EntityViewIterator& iterator)
+		{
+			while (iterator.index < iterator.entities.size())
+			{
+				const Entity entity = iterator.entities[iterator.index++];
+				if (iterator.view->Contains(entity))
+					return entity;
+			}
+			throw py::stop_iteration();
+		});
 
 	py::class_<Physics2dManager> physics2dManager(m, "Physics2dManager");
 	physics2dManager
@@ -175,12 +290,15 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 			const auto textureId = textureManager->LoadTexture(texturePath);
 			auto* texture = textureManager->GetTexture(textureId);
 			auto* sprite = spriteManager->AddComponent(entity);
-			sprite->SetTexture(texture);
+			sprite->SetTexture(texture, textureId);
 
-			auto& spriteInfo = spriteManager->GetComponentInfo(entity);
-			spriteInfo.name = "Sprite";
-			spriteInfo.textureId = textureId;
-			spriteInfo.texturePath = texturePath;
+			if (spriteManager->HasComponentInfos())
+			{
+				auto& spriteInfo = spriteManager->GetComponentInfo(entity);
+				spriteInfo.name = "Sprite";
+				spriteInfo.textureId = textureId;
+				spriteInfo.texturePath = texturePath;
+			}
 		}, py::return_value_policy::reference)
 		.def("get_component", &SpriteManager::GetComponentPtr, py::return_value_policy::reference);
 
@@ -208,11 +326,17 @@ PYBIND11_EMBEDDED_MODULE(SFGE, m)
 		.value("Transform2d", ComponentType::TRANSFORM2D)
 		.export_values();
 
-	py::class_<Transform2d> transform(m, "Transform2d");
+	py::class_<Transform2dRef> transform(m, "Transform2d");
 	transform
-		.def_readwrite("euler_angle", &Transform2d::EulerAngle)
-		.def_readwrite("position", &Transform2d::Position)
-		.def_readwrite("scale", &Transform2d::Scale);
+		.def_property("euler_angle",
+			[](const Transform2dRef& transform) { return transform.GetEulerAngle(); },
+			[](Transform2dRef& transform, float angle) { transform.SetEulerAngle(angle); })
+		.def_property("position",
+			[](const Transform2dRef& transform) { return static_cast<Vec2f>(transform.Position); },
+			[](Transform2dRef& transform, Vec2f position) { transform.Position = position; })
+		.def_property("scale",
+			[](const Transform2dRef& transform) { return static_cast<Vec2f>(transform.Scale); },
+			[](Transform2dRef& transform, Vec2f scale) { transform.Scale = scale; });
 
 	py::class_<ColliderData> colliderData(m, "ColliderData");
 	colliderData
@@ -424,6 +548,7 @@ void PythonEngine::OnEngineInit()
 	Log::GetInstance()->Msg("Initialise the python embed interpretor");
 	System::OnEngineInit();
 	m_PySystemManager.OnEngineInit();
+	m_Engine.GetMemoryManager()->AddMemoryReporter(this);
 
 	py::initialize_interpreter();
 	//Adding reference to c++ engine modules
@@ -453,6 +578,31 @@ void PythonEngine::InitScriptsInstances()
 {
 }
 
+void PythonEngine::ReportMemory(MemoryTracker& memoryTracker) const
+{
+	memoryTracker.ReportFootprint(MemoryTag::PYTHON, "Python modules",
+		GetContainerFootprint(m_PythonModulePaths) + GetContainerFootprint(m_PyClassNames) +
+		GetContainerFootprint(m_PyModuleNames) + GetContainerFootprint(m_PyModuleObjs));
+	//Python objects are not allocated by the engine, their size is only known while tracemalloc traces them
+	if (!Py_IsInitialized())
+		return;
+	try
+	{
+		py::module tracemalloc = py::module::import("tracemalloc");
+		if (tracemalloc.attr("is_tracing")().cast<bool>())
+		{
+			const auto tracedMemory = tracemalloc.attr("get_traced_memory")().cast<std::pair<size_t, size_t>>();
+			memoryTracker.ReportFootprint(MemoryTag::PYTHON, "Python heap", tracedMemory.first);
+		}
+	}
+	catch (py::error_already_set& e)
+	{
+		std::ostringstream oss;
+		oss << "[ERROR] Python already set error: " << e.what();
+		Log::GetInstance()->Error(oss.str());
+	}
+}
+
 
 void PythonEngine::OnUpdate(float dt)
 {
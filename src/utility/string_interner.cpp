@@ -0,0 +1,70 @@
+/*
+ MIT License
+
+ Copyright (c) 2017 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <utility/string_interner.h>
+
+namespace sfge
+{
+
+StringId StringInterner::Intern(std::string_view str)
+{
+	const auto it = m_StringIds.find(str);
+	if (it != m_StringIds.end())
+	{
+		return it->second;
+	}
+	m_Strings.emplace_back(str);
+	const auto stringId = static_cast<StringId>(m_Strings.size());
+	m_StringIds.emplace(m_Strings.back(), stringId);
+	return stringId;
+}
+
+StringId StringInterner::Find(std::string_view str) const
+{
+	const auto it = m_StringIds.find(str);
+	return it != m_StringIds.end() ? it->second : INVALID_STRING_ID;
+}
+
+const std::string& StringInterner::GetString(StringId stringId) const
+{
+	static const std::string emptyString;
+	if (stringId == INVALID_STRING_ID || stringId > m_Strings.size())
+	{
+		return emptyString;
+	}
+	return m_Strings[stringId - 1];
+}
+
+size_t StringInterner::GetSize() const
+{
+	return m_Strings.size();
+}
+
+void StringInterner::Clear()
+{
+	m_StringIds.clear();
+	m_Strings.clear();
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <engine/paged_vector.h>
+#include <gtest/gtest.h>
+
+TEST(Component, TestPagedVectorStableAddresses)
+{
+	sfge::PagedVector<int, 16> pagedVector(10);
+	for (auto i = 0u; i < pagedVector.size(); i++)
+	{
+		pagedVector[i] = i;
+	}
+	int* firstElement = &pagedVector[0];
+	int* lastElement = &pagedVector[9];
+
+	//Growing only allocates new pages
+	pagedVector.resize(1000);
+	ASSERT_EQ(pagedVector.size(), 1000u);
+	ASSERT_EQ(&pagedVector[0], firstElement);
+	ASSERT_EQ(&pagedVector[9], lastElement);
+	ASSERT_EQ(*lastElement, 9);
+	ASSERT_EQ(pagedVector[999], 0);
+
+	ASSERT_EQ(pagedVector.GetPageNmb(), 63u);
+	ASSERT_EQ(pagedVector.GetPageLength(0), 16u);
+	ASSERT_EQ(pagedVector.GetPageLength(62), 8u);
+	ASSERT_EQ(pagedVector.GetPage(0), firstElement);
+	ASSERT_EQ(pagedVector.IndexOf(lastElement), 9u);
+
+	size_t count = 0;
+	for (auto& element : pagedVector)
+	{
+		(void) element;
+		count++;
+	}
+	ASSERT_EQ(count, pagedVector.size());
+
+	pagedVector.pop_back();
+	ASSERT_EQ(pagedVector.size(), 999u);
+	pagedVector.emplace_back() = 42;
+	ASSERT_EQ(pagedVector.back(), 42);
+}
@@ -0,0 +1,271 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <engine/engine.h>
+#include <engine/entity.h>
+#include <engine/component.h>
+#include <engine/config.h>
+#include <engine/transform2d.h>
+#include <graphics/graphics2d.h>
+#include <graphics/sprite2d.h>
+#include <gtest/gtest.h>
+
+TEST(Entity, TestEntityView)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto& bodyView = entityManager->GetView<sfge::ComponentType::TRANSFORM2D, sfge::ComponentType::BODY2D>();
+	ASSERT_EQ(bodyView.Size(), 0u);
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(INVALID_ENTITY);
+		entityManager->AddComponentType(entity, sfge::ComponentType::TRANSFORM2D);
+		if (i % 2 == 0)
+		{
+			entityManager->AddComponentType(entity, sfge::ComponentType::BODY2D);
+		}
+		entities.push_back(entity);
+	}
+	ASSERT_EQ(bodyView.Size(), 5u);
+	ASSERT_TRUE(bodyView.Contains(entities[0]));
+	ASSERT_FALSE(bodyView.Contains(entities[1]));
+	//Views created after the entities are filled from the current masks
+	ASSERT_EQ(entityManager->GetView(static_cast<sfge::EntityMask>(sfge::ComponentType::TRANSFORM2D)).Size(), 10u);
+
+	entityManager->RemoveComponentType(entities[2], sfge::ComponentType::BODY2D);
+	entityManager->DestroyEntity(entities[4]);
+	ASSERT_EQ(bodyView.Size(), 3u);
+	ASSERT_FALSE(bodyView.Contains(entities[2]));
+	ASSERT_FALSE(bodyView.Contains(entities[4]));
+	for (const Entity entity : bodyView)
+	{
+		ASSERT_TRUE(entityManager->HasComponent(entity, sfge::ComponentType::BODY2D));
+	}
+
+	ASSERT_EQ(entityManager->GetEntitiesWithType(sfge::ComponentType::BODY2D).size(), 3u);
+	engine.Destroy();
+}
+
+TEST(Entity, TestGenerationalEntity)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+
+	const Entity firstEntity = entityManager->CreateEntity(INVALID_ENTITY);
+	const Entity secondEntity = entityManager->CreateEntity(INVALID_ENTITY);
+	//Fresh handles are equal to their index
+	ASSERT_EQ(firstEntity, 1u);
+	ASSERT_EQ(secondEntity, 2u);
+	ASSERT_TRUE(entityManager->IsEntityValid(firstEntity));
+
+	entityManager->AddComponentType(firstEntity, sfge::ComponentType::TRANSFORM2D);
+	entityManager->DestroyEntity(firstEntity);
+	ASSERT_FALSE(entityManager->IsEntityValid(firstEntity));
+
+	//The slot is recycled with a new generation
+	const Entity recycledEntity = entityManager->CreateEntity(INVALID_ENTITY);
+	ASSERT_EQ(GetEntityIndex(recycledEntity), GetEntityIndex(firstEntity));
+	ASSERT_NE(recycledEntity, firstEntity);
+	ASSERT_TRUE(entityManager->IsEntityValid(recycledEntity));
+	ASSERT_FALSE(entityManager->IsEntityValid(firstEntity));
+
+	//A stale handle cannot destroy the recycled entity
+	entityManager->AddComponentType(recycledEntity, sfge::ComponentType::TRANSFORM2D);
+	entityManager->DestroyEntity(firstEntity);
+	ASSERT_TRUE(entityManager->IsEntityValid(recycledEntity));
+	ASSERT_TRUE(entityManager->HasComponent(recycledEntity, sfge::ComponentType::TRANSFORM2D));
+
+	//Wanted entities are reserved and skipped by the free list
+	const Entity wantedEntity = entityManager->CreateEntity(3);
+	ASSERT_EQ(wantedEntity, 3u);
+	ASSERT_EQ(entityManager->CreateEntity(3), INVALID_ENTITY);
+	ASSERT_EQ(entityManager->CreateEntity(INVALID_ENTITY), 4u);
+
+	engine.Destroy();
+}
+
+TEST(Entity, TestComponentMask)
+{
+	sfge::ComponentMask entityMask(sfge::ComponentType::TRANSFORM2D);
+	entityMask.Set(100);
+	sfge::ComponentMask query = sfge::ComponentMask::FromId(100);
+	ASSERT_TRUE(query.IsSubsetOf(entityMask));
+	query |= sfge::ComponentMask(sfge::ComponentType::BODY2D);
+	ASSERT_FALSE(query.IsSubsetOf(entityMask));
+	ASSERT_TRUE(query.Intersects(entityMask));
+	entityMask.Reset(100);
+	ASSERT_FALSE(query.Intersects(entityMask));
+	ASSERT_EQ(sfge::GetComponentTypeId(sfge::ComponentType::SOUND), 5u);
+	ASSERT_TRUE(sfge::ComponentMask().None());
+}
+
+TEST(Entity, TestComponentTypeRegistry)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto& registry = entityManager->GetComponentTypeRegistry();
+	ASSERT_EQ(registry.GetTypeId("Body"), sfge::GetComponentTypeId(sfge::ComponentType::BODY2D));
+
+	//More types than an int mask can hold
+	std::vector<sfge::ComponentTypeId> typeIds;
+	for (int i = 0; i < 64; i++)
+	{
+		typeIds.push_back(registry.RegisterType("Extension" + std::to_string(i)));
+	}
+	ASSERT_EQ(registry.RegisterType("Extension0"), typeIds[0]);
+	ASSERT_LT(typeIds.back(), sfge::MAX_COMPONENT_TYPES);
+	ASSERT_EQ(registry.GetTypeName(typeIds.back()), "Extension63");
+
+	const Entity entity = entityManager->CreateEntity(INVALID_ENTITY);
+	entityManager->AddComponentType(entity, sfge::ComponentType::TRANSFORM2D);
+	entityManager->AddComponentType(entity, typeIds.back());
+	auto& view = entityManager->GetView(sfge::ComponentMask::FromId(typeIds.back()) |
+		sfge::ComponentMask(sfge::ComponentType::TRANSFORM2D));
+	ASSERT_TRUE(view.Contains(entity));
+	entityManager->RemoveComponentType(entity, typeIds.back());
+	ASSERT_FALSE(view.Contains(entity));
+	ASSERT_TRUE(entityManager->HasComponent(entity, sfge::ComponentType::TRANSFORM2D));
+	engine.Destroy();
+}
+
+TEST(Entity, TestEntityCommandBuffer)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	const Entity oldEntity = entityManager->CreateEntity(INVALID_ENTITY);
+	entityManager->AddComponentType(oldEntity, sfge::ComponentType::TRANSFORM2D);
+
+	//Record from the workers like a system scheduled on the thread pool
+	const auto transformId = sfge::GetComponentTypeId(sfge::ComponentType::TRANSFORM2D);
+	const size_t spawnNmb = 200;
+	auto& threadPool = engine.GetThreadPool();
+	std::vector<std::future<void>> futures;
+	for (int i = 0; i < threadPool.size(); i++)
+	{
+		futures.push_back(threadPool.push([entityManager, transformId](int threadId)
+		{
+			sfge::SetCommandBufferIndex(static_cast<size_t>(threadId) + 1);
+			auto& commandBuffer = entityManager->GetCommandBuffer();
+			for (size_t j = 0; j < spawnNmb; j++)
+			{
+				const auto entity = commandBuffer.CreateEntity();
+				json transformJson;
+				transformJson["position"] = { 10.0f, 20.0f };
+				commandBuffer.AddComponent(entity, transformId, transformJson);
+			}
+		}));
+	}
+	for (auto& future : futures)
+	{
+		future.get();
+	}
+	auto& mainCommandBuffer = entityManager->GetCommandBuffer();
+	mainCommandBuffer.RemoveComponent(oldEntity, transformId);
+	mainCommandBuffer.DestroyEntity(oldEntity);
+	//Nothing changes before the sync point
+	ASSERT_TRUE(entityManager->IsEntityValid(oldEntity));
+
+	auto& transformView = entityManager->GetView<sfge::ComponentType::TRANSFORM2D>();
+	entityManager->ApplyCommandBuffers();
+	ASSERT_FALSE(entityManager->IsEntityValid(oldEntity));
+	ASSERT_EQ(transformView.Size(), spawnNmb * static_cast<size_t>(threadPool.size()));
+	for (const Entity entity : transformView)
+	{
+		const auto position = engine.GetTransform2dManager()->GetTransform(entity).Position;
+		ASSERT_FLOAT_EQ(position.y, 20.0f);
+	}
+	ASSERT_TRUE(entityManager->GetCommandBuffer().IsEmpty());
+	engine.Destroy();
+}
+
+TEST(Entity, TestEntityNames)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	//Shipping configuration, the editor metadata is not allocated
+	config->editor = false;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto* spriteManager = engine.GetGraphics2dManager()->GetSpriteManager();
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 4; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(INVALID_ENTITY);
+		spriteManager->AddComponent(entity);
+		entities.push_back(entity);
+	}
+	ASSERT_FALSE(spriteManager->HasComponentInfos());
+	entityManager->SetEntityName(entities[0], "Player");
+	entityManager->SetEntityName(entities[1], "Enemy");
+	entityManager->SetEntityName(entities[2], "Enemy");
+	ASSERT_EQ(entityManager->GetEntityName(entities[0]), "Player");
+	ASSERT_EQ(entityManager->GetEntityName(entities[3]), "");
+	ASSERT_EQ(entityManager->GetEntityByName("Player"), entities[0]);
+	ASSERT_EQ(entityManager->GetEntityByName("Enemy"), entities[1]);
+	ASSERT_EQ(entityManager->GetEntityByName("Nobody"), INVALID_ENTITY);
+
+	//The next entity with the name takes over, destroyed entities lose theirs
+	entityManager->DestroyEntity(entities[1]);
+	ASSERT_EQ(entityManager->GetEntityByName("Enemy"), entities[2]);
+	entityManager->SetEntityName(entities[2], "Boss");
+	ASSERT_EQ(entityManager->GetEntityByName("Enemy"), INVALID_ENTITY);
+	ASSERT_EQ(entityManager->GetEntityByName("Boss"), entities[2]);
+	const Entity newEntity = entityManager->CreateEntity(INVALID_ENTITY);
+	ASSERT_EQ(entityManager->GetEntityName(newEntity), "");
+
+	//The editor metadata is created on demand from the current state
+	ASSERT_EQ(entityManager->GetEntityInfo(entities[0]).name, "Player");
+	ASSERT_EQ(spriteManager->GetComponentInfo(entities[3]).GetEntity(), entities[3]);
+	ASSERT_TRUE(spriteManager->HasComponentInfos());
+	spriteManager->DestroyComponent(entities[0]);
+	ASSERT_EQ(spriteManager->GetComponentInfo(entities[3]).GetEntity(), entities[3]);
+
+	engine.Destroy();
+}
@@ -149,3 +149,132 @@ TEST(Graphics2d, TestTexture)
 	engine.Destroy();
 }
 
+
+TEST(Graphics2d, TestSparseSprites)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto* spriteManager = engine.GetGraphics2dManager()->GetSpriteManager();
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(0);
+		//Every entity gets a transform, only every other one gets a sprite
+		entityManager->AddComponentType(entity, sfge::ComponentType::TRANSFORM2D);
+		if (i % 2 == 0)
+		{
+			spriteManager->AddComponent(entity);
+			entities.push_back(entity);
+		}
+	}
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), entities.size());
+	ASSERT_EQ(spriteManager->GetComponentPtr(entities[0] + 1), nullptr);
+
+	entityManager->DestroyEntity(entities[1]);
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), entities.size() - 1);
+	ASSERT_FALSE(spriteManager->HasComponent(entities[1]));
+	for (auto entity : spriteManager->GetDenseEntities())
+	{
+		ASSERT_EQ(spriteManager->GetComponentInfo(entity).GetEntity(), entity);
+	}
+
+	spriteManager->DestroyComponent(entities[0]);
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), entities.size() - 2);
+	ASSERT_FALSE(entityManager->HasComponent(entities[0], sfge::ComponentType::SPRITE2D));
+
+	engine.Destroy();
+}
+
+TEST(Graphics2d, TestDestroySpritesBatch)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto* spriteManager = engine.GetGraphics2dManager()->GetSpriteManager();
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 20; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(0);
+		entityManager->AddComponentType(entity, sfge::ComponentType::TRANSFORM2D);
+		spriteManager->AddComponent(entity);
+		entities.push_back(entity);
+	}
+	//Unsorted with a duplicate and a stale handle, only the valid ones are destroyed
+	std::vector<Entity> destroyedEntities = { entities[15], entities[3], entities[9], entities[3], entities[0] };
+	entityManager->DestroyEntity(entities[19]);
+	destroyedEntities.push_back(entities[19]);
+	entityManager->DestroyEntities(destroyedEntities);
+
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), 15u);
+	ASSERT_FALSE(entityManager->IsEntityValid(entities[9]));
+	//The remaining sprites are still packed in creation order
+	const auto& denseEntities = spriteManager->GetDenseEntities();
+	ASSERT_TRUE(std::is_sorted(denseEntities.begin(), denseEntities.end()));
+	for (auto entity : denseEntities)
+	{
+		ASSERT_EQ(spriteManager->GetComponentInfo(entity).GetEntity(), entity);
+	}
+	//The lowest destroyed index is reused first
+	ASSERT_EQ(GetEntityIndex(entityManager->CreateEntity(0)), GetEntityIndex(entities[0]));
+
+	engine.Destroy();
+}
+
+TEST(Graphics2d, TestShapePool)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	json sceneJson;
+	sceneJson["name"] = "Shape Pool";
+	json entities = json::array();
+	for (int i = 0; i < 10; i++)
+	{
+		json transformJson;
+		transformJson["type"] = sfge::ComponentType::TRANSFORM2D;
+		transformJson["position"] = { 10 * i, 10 };
+		json shapeJson;
+		shapeJson["type"] = sfge::ComponentType::SHAPE2D;
+		shapeJson["shape_type"] = i % 2 == 0 ? sfge::ShapeType::CIRCLE : sfge::ShapeType::RECTANGLE;
+		shapeJson["radius"] = 5;
+		shapeJson["size"] = { 10, 10 };
+		json entityJson;
+		entityJson["components"] = { transformJson, shapeJson };
+		entities.push_back(entityJson);
+	}
+	sceneJson["entities"] = entities;
+	engine.GetSceneManager()->LoadSceneFromJson(sceneJson);
+
+	auto* shapeManager = engine.GetGraphics2dManager()->GetShapeManager();
+	//The pool is sized from the scene
+	ASSERT_EQ(shapeManager->GetShapePoolCapacity(), 10u);
+	ASSERT_EQ(shapeManager->GetComponentsNmb(), 10u);
+
+	//Updating the shapes does not allocate
+	shapeManager->OnUpdate(0.0f);
+	sfge::ResetFrameAllocationNmb();
+	engine.GetTransform2dManager()->OnUpdate(0.0f);
+	shapeManager->OnUpdate(0.0f);
+	ASSERT_EQ(sfge::GetFrameAllocationNmb(), 0u);
+
+	//Shapes created past the pool capacity come from the heap
+	auto extraShape = shapeManager->CreateShape<sf::CircleShape>();
+	ASSERT_EQ(extraShape.get_deleter().pool, nullptr);
+	ASSERT_EQ(sfge::GetFrameAllocationNmb(), 1u);
+
+	engine.Destroy();
+}
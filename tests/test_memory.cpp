@@ -23,9 +23,19 @@ SOFTWARE.
 */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <engine/memory.h>
+#include <engine/paged_vector.h>
+#include <engine/frame_arena.h>
+#include <engine/virtual_arena.h>
+#include <engine/memory_tracker.h>
 
 TEST(Memory, TestCustomAllocator)
 {
@@ -49,3 +59,363 @@ TEST(Memory, TestCustomAllocator)
 
 }
 
+
+TEST(Memory, TestPoolAllocator)
+{
+    const size_t objectSize = 4 * sizeof(void*);
+    void* data = calloc(objectSize * 8 + alignof(void*), sizeof(char));
+    sfge::PoolAllocator poolAllocator(objectSize, alignof(void*), objectSize * 8 + alignof(void*), data);
+
+    //Consecutive slots are objectSize bytes apart
+    void* first = poolAllocator.allocate(objectSize, alignof(void*));
+    void* second = poolAllocator.allocate(objectSize, alignof(void*));
+    ASSERT_EQ((char*)second - (char*)first, (ptrdiff_t)objectSize);
+    std::vector<void*> objects = { first, second };
+    void* object = nullptr;
+    while ((object = poolAllocator.allocate(objectSize, alignof(void*))) != nullptr)
+    {
+        objects.push_back(object);
+    }
+    ASSERT_EQ(objects.size(), 8u);
+    for (auto* p : objects)
+    {
+        poolAllocator.deallocate(p);
+    }
+    ASSERT_EQ(poolAllocator.getNumAllocations(), 0u);
+    free(data);
+}
+
+TEST(Memory, TestConcurrentPoolAllocator)
+{
+    const size_t objectSize = 64;
+    const size_t objectNmb = 8;
+    void* data = calloc(objectSize * objectNmb + objectSize - 1, sizeof(char));
+    {
+        sfge::ConcurrentPoolAllocator poolAllocator(objectSize, objectSize, objectSize * objectNmb + objectSize - 1, data);
+        ASSERT_EQ(poolAllocator.getObjectNmb(), objectNmb);
+
+        //Few slots shared by many threads, popping two and pushing the first back is the ABA pattern
+        const int threadNmb = 8;
+        const int iterationNmb = 20000;
+        const std::uint32_t ownedMark = 0x80000000u;
+        std::atomic<int> errorNmb{0};
+        std::mutex handOffMutex;
+        std::vector<void*> handOff;
+        std::vector<std::thread> threads;
+        for (int threadId = 1; threadId <= threadNmb; threadId++)
+        {
+            threads.emplace_back([&, threadId]()
+            {
+                auto acquire = [&]() -> void*
+                {
+                    void* p = poolAllocator.allocate(objectSize, objectSize);
+                    if (p == nullptr)
+                        return nullptr;
+                    //The owner mark overwrites the free list link, like user data does while a stale pop may still read it.
+                    //A free slot holds a slot index, two threads owning the same slot would see the mark of the other one
+                    auto* owner = reinterpret_cast<std::atomic<std::uint32_t>*>(p);
+                    if ((owner->exchange(ownedMark | std::uint32_t(threadId)) & ownedMark) != 0)
+                        errorNmb++;
+                    if (sfge::alignForwardAdjustment(p, objectSize) != 0)
+                        errorNmb++;
+                    return p;
+                };
+                auto release = [&](void* p)
+                {
+                    if ((reinterpret_cast<std::atomic<std::uint32_t>*>(p)->exchange(0) & ownedMark) == 0)
+                        errorNmb++;
+                    poolAllocator.deallocate(p);
+                };
+                for (int i = 0; i < iterationNmb; i++)
+                {
+                    void* first = acquire();
+                    void* second = acquire();
+                    if (first != nullptr)
+                        release(first);
+                    if (second == nullptr)
+                        continue;
+                    //Every other object is freed by another thread
+                    if (i % 2 == 0)
+                    {
+                        release(second);
+                        continue;
+                    }
+                    void* other = nullptr;
+                    {
+                        std::lock_guard<std::mutex> lock(handOffMutex);
+                        if (!handOff.empty())
+                        {
+                            other = handOff.back();
+                            handOff.pop_back();
+                        }
+                        handOff.push_back(second);
+                    }
+                    if (other != nullptr)
+                        release(other);
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (void* p : handOff)
+            poolAllocator.deallocate(p);
+
+        ASSERT_EQ(errorNmb.load(), 0);
+        ASSERT_EQ(poolAllocator.getNumAllocations(), 0u);
+
+        //No slot was lost or duplicated
+        std::vector<void*> objects;
+        void* object = nullptr;
+        while ((object = poolAllocator.allocate(objectSize, objectSize)) != nullptr)
+            objects.push_back(object);
+        ASSERT_EQ(objects.size(), objectNmb);
+        //The counters are the same through the Allocator base
+        const sfge::Allocator& allocator = poolAllocator;
+        ASSERT_EQ(allocator.getNumAllocations(), objectNmb);
+        ASSERT_EQ(allocator.getUsedMemory(), objectNmb * objectSize);
+        std::sort(objects.begin(), objects.end());
+        ASSERT_EQ(std::unique(objects.begin(), objects.end()), objects.end());
+        for (void* p : objects)
+            poolAllocator.deallocate(p);
+    }
+    free(data);
+}
+
+TEST(Memory, TestEngineAllocationPolicy)
+{
+    const size_t memorySize = 64 * 1024;
+    void* data = calloc(memorySize, sizeof(char));
+    {
+        sfge::FreeListAllocator freeListAllocator(memorySize, data);
+        sfge::PagedVector<float, 1024, sfge::EngineAllocationPolicy> pagedVector;
+        pagedVector.SetAllocator(&freeListAllocator);
+
+        sfge::ResetFrameAllocationNmb();
+        pagedVector.resize(1024 * 4);
+        ASSERT_EQ(sfge::GetFrameAllocationNmb(), 4u);
+        ASSERT_EQ(freeListAllocator.getNumAllocations(), 4u);
+        ASSERT_TRUE(sfge::EngineAllocationPolicy::Owns(freeListAllocator, pagedVector.GetPage(3)));
+
+        //Growing within the capacity does not allocate
+        sfge::ResetFrameAllocationNmb();
+        pagedVector.resize(10);
+        pagedVector.resize(1024 * 4);
+        ASSERT_EQ(sfge::GetFrameAllocationNmb(), 0u);
+
+        //Pages that do not fit fall back to the heap
+        pagedVector.resize(1024 * 32);
+        ASSERT_LT(freeListAllocator.getNumAllocations(), 32u);
+        ASSERT_FALSE(sfge::EngineAllocationPolicy::Owns(freeListAllocator, pagedVector.GetPage(31)));
+        pagedVector[1024 * 32 - 1] = 1.0f;
+
+        pagedVector.clear();
+        ASSERT_EQ(freeListAllocator.getNumAllocations(), 0u);
+        ASSERT_EQ(freeListAllocator.getUsedMemory(), 0u);
+    }
+    free(data);
+}
+
+TEST(Memory, TestTlsfAllocator)
+{
+    const size_t memorySize = 256 * 1024;
+    void* data = calloc(memorySize, sizeof(char));
+    {
+        sfge::TlsfAllocator tlsfAllocator(memorySize, data);
+        const size_t initialFree = tlsfAllocator.getFreeMemory();
+        ASSERT_EQ(tlsfAllocator.getLargestFreeBlock(), initialFree);
+        ASSERT_EQ(tlsfAllocator.getFragmentation(), 0.0f);
+
+        std::vector<void*> allocations;
+        for (size_t i = 0; i < 256; i++)
+        {
+            const size_t alignment = size_t(8) << (i % 4);
+            void* p = tlsfAllocator.allocate(16 + (i * 37) % 700, alignment);
+            ASSERT_NE(p, nullptr);
+            ASSERT_EQ(sfge::alignForwardAdjustment(p, alignment), 0u);
+            memset(p, 0xFF, 16);
+            allocations.push_back(p);
+        }
+        ASSERT_EQ(tlsfAllocator.getNumAllocations(), 256u);
+
+        //Freeing every other allocation leaves holes that cannot be merged
+        for (size_t i = 0; i < allocations.size(); i += 2)
+            tlsfAllocator.deallocate(allocations[i]);
+        ASSERT_GT(tlsfAllocator.getFragmentation(), 0.0f);
+        ASSERT_LT(tlsfAllocator.getLargestFreeBlock(), tlsfAllocator.getFreeMemory());
+
+        //Freed holes are reused
+        void* reused = tlsfAllocator.allocate(16, 8);
+        ASSERT_LT(reused, allocations.back());
+        tlsfAllocator.deallocate(reused);
+
+        //Neighbours are merged back into a single block
+        for (size_t i = 1; i < allocations.size(); i += 2)
+            tlsfAllocator.deallocate(allocations[i]);
+        ASSERT_EQ(tlsfAllocator.getNumAllocations(), 0u);
+        ASSERT_EQ(tlsfAllocator.getUsedMemory(), 0u);
+        ASSERT_EQ(tlsfAllocator.getFreeMemory(), initialFree);
+        ASSERT_EQ(tlsfAllocator.getLargestFreeBlock(), initialFree);
+        ASSERT_EQ(tlsfAllocator.getFragmentation(), 0.0f);
+
+        ASSERT_EQ(tlsfAllocator.allocate(memorySize, 8), nullptr);
+        //Searches round the size up to the next list, the merged block still fits any size of a lower list
+        void* big = tlsfAllocator.allocate(initialFree / 2, 8);
+        ASSERT_NE(big, nullptr);
+        tlsfAllocator.deallocate(big);
+    }
+    free(data);
+}
+
+TEST(Memory, TestMemoryTracker)
+{
+    const size_t memorySize = 64 * 1024;
+    void* data = calloc(memorySize, sizeof(char));
+    {
+        sfge::MemoryTracker memoryTracker;
+        sfge::TlsfAllocator tlsfAllocator(memorySize, data);
+        sfge::TrackingAllocator trackingAllocator(tlsfAllocator, memoryTracker, sfge::MemoryTag::PHYSICS);
+        ASSERT_EQ(trackingAllocator.getStart(), tlsfAllocator.getStart());
+
+        void* small = trackingAllocator.allocate(24, 8);
+        void* big = trackingAllocator.allocate(4000, 16);
+        auto stats = memoryTracker.GetStats(sfge::MemoryTag::PHYSICS);
+        //Sizes are the ones of the wrapped allocator, headers included
+        ASSERT_EQ(stats.currentBytes, tlsfAllocator.getUsedMemory());
+        ASSERT_EQ(stats.allocationNmb, 2u);
+        ASSERT_EQ(stats.histogram[5], 1u);
+        ASSERT_EQ(stats.histogram[11], 1u);
+        ASSERT_TRUE(stats.tracked);
+        ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::TEXTURES).allocationNmb, 0u);
+        ASSERT_FALSE(memoryTracker.IsTagTracked(sfge::MemoryTag::TEXTURES));
+
+        const size_t peakBytes = stats.currentBytes;
+        trackingAllocator.deallocate(big);
+        stats = memoryTracker.GetStats(sfge::MemoryTag::PHYSICS);
+        ASSERT_EQ(stats.peakBytes, peakBytes);
+        ASSERT_EQ(stats.currentBytes, tlsfAllocator.getUsedMemory());
+        ASSERT_EQ(stats.deallocationNmb, 1u);
+        trackingAllocator.deallocate(small);
+        ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::PHYSICS).currentBytes, 0u);
+        ASSERT_EQ(trackingAllocator.getNumAllocations(), 0u);
+
+        //Footprints are replaced at every report
+        memoryTracker.ReportFootprint(sfge::MemoryTag::TEXTURES, "Textures", 1024);
+        memoryTracker.ReportFootprint(sfge::MemoryTag::TEXTURES, "Texture cache", 256);
+        ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::TEXTURES).footprintBytes, 1280u);
+        const json memoryJson = memoryTracker.ToJson();
+        ASSERT_EQ(memoryJson["tags"]["Physics"]["peakBytes"].get<size_t>(), peakBytes);
+        ASSERT_EQ(memoryJson["tags"]["Physics"]["histogram"]["32"].get<size_t>(), 1u);
+        //Tags with only footprints do not show allocation counters
+        ASSERT_EQ(memoryJson["tags"]["Textures"]["footprintBytes"].get<size_t>(), 1280u);
+        ASSERT_EQ(memoryJson["tags"]["Textures"].count("peakBytes"), 0u);
+        ASSERT_EQ(memoryJson["footprints"].size(), 2u);
+        ASSERT_EQ(memoryJson["footprints"][1]["name"].get<std::string>(), "Texture cache");
+        memoryTracker.ClearFootprints();
+        ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::TEXTURES).footprintBytes, 0u);
+    }
+    free(data);
+}
+
+TEST(Memory, TestVirtualArena)
+{
+    const size_t pageSize = sfge::VirtualArena::getPageSize();
+    sfge::VirtualArena virtualArena(64 * 1024 * 1024, pageSize);
+    ASSERT_EQ(virtualArena.getSize(), 64u * 1024 * 1024);
+    ASSERT_EQ(virtualArena.getCommittedMemory(), 0u);
+
+    //Pages are committed when the allocations reach them
+    auto* first = static_cast<char*>(virtualArena.allocate(100, 16));
+    ASSERT_NE(first, nullptr);
+    memset(first, 1, 100);
+    ASSERT_GE(virtualArena.getCommittedMemory(), 100u);
+    ASSERT_LT(virtualArena.getCommittedMemory(), 1024u * 1024);
+
+    const size_t bigSize = 8 * 1024 * 1024;
+    auto* big = static_cast<char*>(virtualArena.allocate(bigSize, 64));
+    ASSERT_NE(big, nullptr);
+    ASSERT_EQ(sfge::alignForwardAdjustment(big, 64), 0u);
+    big[bigSize - 1] = 1;
+    ASSERT_GE(virtualArena.getCommittedMemory(), bigSize);
+    ASSERT_EQ(virtualArena.allocate(64 * 1024 * 1024, 16), nullptr);
+
+    //Clearing decommits what is above the high-water mark
+    virtualArena.clear();
+    ASSERT_EQ(virtualArena.getUsedMemory(), 0u);
+    ASSERT_EQ(virtualArena.getCommittedMemory(), pageSize);
+    ASSERT_EQ(virtualArena.allocate(100, 16), first);
+    auto* again = static_cast<char*>(virtualArena.allocate(bigSize, 64));
+    ASSERT_EQ(again, big);
+    ASSERT_EQ(again[bigSize - 1], 0);
+    virtualArena.clear();
+}
+
+TEST(Memory, TestFrameArena)
+{
+    sfge::FrameArena frameArena(1024, 64 * 1024);
+    auto* first = static_cast<int*>(frameArena.Allocate(16 * sizeof(int), alignof(int)));
+    first[0] = 42;
+    ASSERT_EQ(frameArena.GetUsedMemory(), 16 * sizeof(int));
+
+    //Double-buffered, the memory of the previous frame is still valid
+    frameArena.Swap();
+    ASSERT_EQ(frameArena.GetUsedMemory(), 0u);
+    auto* second = static_cast<int*>(frameArena.Allocate(16 * sizeof(int), alignof(int)));
+    ASSERT_NE(first, second);
+    ASSERT_EQ(first[0], 42);
+    //The buffer of the first frame is reused two frames later
+    frameArena.Swap();
+    ASSERT_EQ(frameArena.Allocate(16 * sizeof(int), alignof(int)), first);
+
+    //Containers opt in through std::pmr or the STL allocator
+    std::pmr::vector<int> pmrVector(&frameArena);
+    for (int i = 0; i < 64; i++)
+        pmrVector.push_back(i);
+    std::vector<double, sfge::FrameAllocator<double>> frameVector{ sfge::FrameAllocator<double>(frameArena) };
+    frameVector.resize(16, 1.0);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(frameVector.data()) % alignof(double), 0u);
+    ASSERT_EQ(pmrVector[63], 63);
+    ASSERT_EQ(frameArena.GetOverflowNmb(), 0u);
+
+    //A frame can use more than the buffer size, up to the reservation
+    ASSERT_NE(frameArena.Allocate(16 * 1024), nullptr);
+    ASSERT_EQ(frameArena.GetOverflowNmb(), 0u);
+
+    //Allocations too big for the reservation go to the heap until the buffer is cleared
+    const size_t allocationNmb = sfge::GetFrameAllocationNmb();
+    void* big = frameArena.Allocate(128 * 1024);
+    ASSERT_NE(big, nullptr);
+    ASSERT_EQ(frameArena.GetOverflowNmb(), 1u);
+    ASSERT_EQ(sfge::GetFrameAllocationNmb(), allocationNmb + 1);
+    frameArena.Swap();
+    frameArena.Swap();
+    ASSERT_EQ(frameArena.GetOverflowNmb(), 0u);
+}
+
+TEST(Memory, TestFrameArenaTracking)
+{
+    sfge::MemoryTracker memoryTracker;
+    {
+        sfge::FrameArena frameArena(1024, 64 * 1024);
+        frameArena.SetMemoryTracker(&memoryTracker);
+        ASSERT_TRUE(memoryTracker.IsTagTracked(sfge::MemoryTag::FRAME));
+
+        frameArena.Allocate(100, 4);
+        frameArena.Allocate(128 * 1024);
+        auto stats = memoryTracker.GetStats(sfge::MemoryTag::FRAME);
+        ASSERT_EQ(stats.allocationNmb, 2u);
+        ASSERT_EQ(stats.currentBytes, 100u + 128u * 1024);
+        ASSERT_EQ(stats.histogram[17], 1u);
+
+        //The allocations of a frame are given back when its buffer is cleared
+        frameArena.Swap();
+        frameArena.Allocate(64, 4);
+        ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::FRAME).deallocationNmb, 0u);
+        frameArena.Swap();
+        stats = memoryTracker.GetStats(sfge::MemoryTag::FRAME);
+        ASSERT_EQ(stats.deallocationNmb, 2u);
+        ASSERT_EQ(stats.currentBytes, 64u);
+        ASSERT_EQ(stats.peakBytes, 100u + 128u * 1024 + 64u);
+    }
+    ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::FRAME).currentBytes, 0u);
+    ASSERT_EQ(memoryTracker.GetStats(sfge::MemoryTag::FRAME).deallocationNmb, 3u);
+}
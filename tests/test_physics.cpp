@@ -26,6 +26,15 @@ SOFTWARE.
 #include <gtest/gtest.h>
 #include "graphics/shape2d.h"
 #include "physics/collider2d.h"
+#include <p2aabbtree.h>
+#include <p2world.h>
+#include <p2grid.h>
+#include <p2sweepandprune.h>
+#include <p2narrowphase.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <chrono>
 
 TEST(Physics, TestBallFallingToGround)
 {
@@ -203,4 +212,789 @@ TEST(Physics, TestShapeContact)
 	);
 	sceneManager->LoadSceneFromJson(sceneJson);
 	engine.Start();
-}
\ No newline at end of file
+}
+
+namespace
+{
+std::vector<std::pair<p2Body*, p2Body*>> SortPairs(const std::vector<p2BodyPair>& bodyPairs)
+{
+	std::vector<std::pair<p2Body*, p2Body*>> pairs;
+	for (auto& bodyPair : bodyPairs)
+	{
+		pairs.emplace_back(std::min(bodyPair.bodyA, bodyPair.bodyB), std::max(bodyPair.bodyA, bodyPair.bodyB));
+	}
+	std::sort(pairs.begin(), pairs.end());
+	return pairs;
+}
+}
+
+TEST(Physics, TestAABBTree)
+{
+	const int bodiesNmb = 500;
+	std::vector<p2Body> bodies(bodiesNmb);
+	std::vector<p2AABB> aabbs(bodiesNmb);
+	std::vector<int> proxies(bodiesNmb);
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> positionDistribution(0.0f, 50.0f);
+	std::uniform_real_distribution<float> sizeDistribution(0.1f, 1.0f);
+	std::uniform_real_distribution<float> moveDistribution(-0.5f, 0.5f);
+
+	p2AABBTree tree;
+	for (int i = 0; i < bodiesNmb; i++)
+	{
+		const p2Vec2 position(positionDistribution(generator), positionDistribution(generator));
+		const p2Vec2 halfSize(sizeDistribution(generator), sizeDistribution(generator));
+		aabbs[i] = p2AABB(position - halfSize, position + halfSize);
+		proxies[i] = tree.CreateProxy(aabbs[i], &bodies[i]);
+	}
+	EXPECT_EQ(tree.GetProxyNmb(), bodiesNmb);
+	//Balanced tree
+	EXPECT_LE(tree.GetHeight(), 2 * static_cast<int>(std::log2(bodiesNmb)) + 2);
+
+	auto checkPairs = [&]()
+	{
+		std::vector<p2BodyPair> treePairs;
+		tree.FindPairs(treePairs);
+
+		std::vector<p2BodyPair> bruteForcePairs;
+		for (int i = 0; i < bodiesNmb; i++)
+		{
+			EXPECT_TRUE(tree.GetFatAABB(proxies[i]).Contains(aabbs[i]));
+			for (int j = i + 1; j < bodiesNmb; j++)
+			{
+				if (tree.GetFatAABB(proxies[i]).Overlaps(tree.GetFatAABB(proxies[j])))
+					bruteForcePairs.push_back({ &bodies[i], &bodies[j] });
+			}
+		}
+		EXPECT_EQ(SortPairs(treePairs), SortPairs(bruteForcePairs));
+	};
+	checkPairs();
+
+	for (int step = 0; step < 10; step++)
+	{
+		int reinsertedNmb = 0;
+		for (int i = 0; i < bodiesNmb; i++)
+		{
+			const p2Vec2 displacement(moveDistribution(generator), moveDistribution(generator));
+			aabbs[i] = p2AABB(aabbs[i].m_BottomLeft + displacement, aabbs[i].m_TopRight + displacement);
+			if (tree.MoveProxy(proxies[i], aabbs[i], displacement))
+				reinsertedNmb++;
+		}
+		EXPECT_LE(reinsertedNmb, bodiesNmb);
+		checkPairs();
+	}
+
+	//Moving inside the fat AABB does not reinsert
+	const p2Vec2 smallDisplacement(AABB_TREE_MARGIN * 0.1f, 0.0f);
+	const p2AABB fatAABB = tree.GetFatAABB(proxies[0]);
+	const p2AABB tightAABB(fatAABB.m_BottomLeft + p2Vec2(AABB_TREE_MARGIN, AABB_TREE_MARGIN) + smallDisplacement,
+		fatAABB.m_TopRight - p2Vec2(AABB_TREE_MARGIN, AABB_TREE_MARGIN) + smallDisplacement);
+	EXPECT_FALSE(tree.MoveProxy(proxies[0], tightAABB, smallDisplacement));
+
+	//Destroyed nodes are reused
+	const size_t footprint = tree.GetMemoryFootprint();
+	for (int i = 0; i < bodiesNmb / 2; i++)
+	{
+		tree.DestroyProxy(proxies[i]);
+	}
+	for (int i = 0; i < bodiesNmb / 2; i++)
+	{
+		proxies[i] = tree.CreateProxy(aabbs[i], &bodies[i]);
+	}
+	EXPECT_EQ(tree.GetMemoryFootprint(), footprint);
+	EXPECT_EQ(tree.GetProxyNmb(), bodiesNmb);
+	checkPairs();
+}
+
+TEST(Physics, TestWorldBroadPhase)
+{
+	for (auto broadPhaseType : { p2BroadPhaseType::QUADTREE, p2BroadPhaseType::AABB_TREE, p2BroadPhaseType::GRID, p2BroadPhaseType::SWEEP_AND_PRUNE })
+	{
+		p2WorldDef worldDef;
+		worldDef.gravity = p2Vec2(0.0f, 0.0f);
+		worldDef.screenResolution = p2Vec2(1280.0f, 720.0f);
+		worldDef.broadPhaseType = broadPhaseType;
+		p2World world(worldDef);
+		EXPECT_EQ(world.GetBroadPhaseType(), broadPhaseType);
+
+		p2RectShape rectShape(p2Vec2(0.5f, 0.5f));
+		p2ColliderDef colliderDef;
+		colliderDef.shape = &rectShape;
+
+		p2BodyDef bodyDef;
+		bodyDef.type = p2BodyType::DYNAMIC;
+		bodyDef.gravityScale = 1.0f;
+		bodyDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+
+		//Two overlapping bodies and a far away one
+		const p2Vec2 positions[] = { p2Vec2(1.0f, 1.0f), p2Vec2(1.5f, 1.5f), p2Vec2(10.0f, 5.0f) };
+		p2Body* bodies[3];
+		for (int i = 0; i < 3; i++)
+		{
+			bodyDef.position = positions[i];
+			bodies[i] = world.CreateBody(&bodyDef);
+			EXPECT_NE(bodies[i]->CreateCollider(&colliderDef), nullptr);
+			EXPECT_EQ(bodies[i]->GetColliderNmb(), 1);
+		}
+		EXPECT_FLOAT_EQ(bodies[0]->GetAABB().m_TopRight.x, 1.5f);
+		EXPECT_FLOAT_EQ(bodies[0]->GetAABB().m_BottomLeft.y, 0.5f);
+
+		world.Step(0.02f);
+		auto pairs = world.GetBodyPairs();
+		if (broadPhaseType != p2BroadPhaseType::QUADTREE)
+		{
+			ASSERT_EQ(pairs.size(), 1u);
+		}
+		EXPECT_TRUE(std::any_of(pairs.begin(), pairs.end(), [&](const p2BodyPair& pair)
+		{
+			return (pair.bodyA == bodies[0] && pair.bodyB == bodies[1]) || (pair.bodyA == bodies[1] && pair.bodyB == bodies[0]);
+		}));
+	}
+}
+
+namespace
+{
+/**
+ * \brief Random square bodies of similar size with a rect collider
+ */
+void CreateRandomBodies(std::vector<p2Body>& bodies, p2RectShape& rectShape, float worldSize, std::mt19937& generator)
+{
+	std::uniform_real_distribution<float> positionDistribution(0.0f, worldSize);
+	p2ColliderDef colliderDef;
+	colliderDef.shape = &rectShape;
+	p2BodyDef bodyDef;
+	bodyDef.type = p2BodyType::DYNAMIC;
+	bodyDef.gravityScale = 1.0f;
+	bodyDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+	for (auto& body : bodies)
+	{
+		bodyDef.position = p2Vec2(positionDistribution(generator), positionDistribution(generator));
+		body.Init(&bodyDef);
+		body.CreateCollider(&colliderDef);
+	}
+}
+
+std::vector<std::pair<p2Body*, p2Body*>> FindOverlappingPairs(std::vector<p2Body>& bodies)
+{
+	std::vector<p2BodyPair> pairs;
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		for (size_t j = i + 1; j < bodies.size(); j++)
+		{
+			if (bodies[i].GetAABB().Overlaps(bodies[j].GetAABB()))
+				pairs.push_back({ &bodies[i], &bodies[j] });
+		}
+	}
+	return SortPairs(pairs);
+}
+}
+
+TEST(Physics, TestGridBroadPhase)
+{
+	const int bodiesNmb = 2000;
+	std::vector<p2Body> bodies(bodiesNmb);
+	p2RectShape rectShape(p2Vec2(0.25f, 0.25f));
+	std::mt19937 generator(42);
+	CreateRandomBodies(bodies, rectShape, 40.0f, generator);
+	const std::vector<p2Vec2> displacements(bodiesNmb, p2Vec2(0.0f, 0.0f));
+	const auto overlappingPairs = FindOverlappingPairs(bodies);
+	ASSERT_FALSE(overlappingPairs.empty());
+
+	//Cell size from the bodies, bigger and smaller than the bodies, then over several threads
+	std::unique_ptr<p2GridBroadPhase> grids[] =
+	{
+		std::unique_ptr<p2GridBroadPhase>(new p2GridBroadPhase()),
+		std::unique_ptr<p2GridBroadPhase>(new p2GridBroadPhase(2.0f)),
+		std::unique_ptr<p2GridBroadPhase>(new p2GridBroadPhase(0.2f)),
+		std::unique_ptr<p2GridBroadPhase>(new p2GridBroadPhase(0.0f, 4))
+	};
+	for (auto& grid : grids)
+	{
+		//The threads of the grid are kept from one step to the next
+		for (int step = 0; step < 3; step++)
+		{
+			std::vector<p2BodyPair> pairs;
+			grid->FindPairs(bodies, bodiesNmb, displacements, pairs);
+			//Each overlapping pair is emitted once
+			EXPECT_EQ(pairs.size(), overlappingPairs.size());
+			EXPECT_EQ(SortPairs(pairs), overlappingPairs);
+		}
+	}
+	EXPECT_NEAR(grids[0]->GetCellSize(), 0.5f, 1e-4f);
+	EXPECT_GE(grids[0]->GetBucketNmb(), 2u * bodiesNmb);
+}
+
+TEST(Physics, TestGridBroadPhaseFarBodies)
+{
+	//Bodies out of the int range of the cells share the border cells
+	std::vector<p2Body> bodies(3);
+	p2RectShape rectShape(p2Vec2(0.25f, 0.25f));
+	const p2Vec2 positions[] = { p2Vec2(1e6f, 0.0f), p2Vec2(1e6f + 0.1f, 0.0f), p2Vec2(-1e6f, -1e6f) };
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		p2BodyDef bodyDef;
+		bodyDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+		bodyDef.position = positions[i];
+		bodies[i].Init(&bodyDef);
+		p2ColliderDef colliderDef;
+		colliderDef.shape = &rectShape;
+		bodies[i].CreateCollider(&colliderDef);
+	}
+	const std::vector<p2Vec2> displacements(bodies.size(), p2Vec2(0.0f, 0.0f));
+	p2GridBroadPhase grid(1e-4f, 2);
+	std::vector<p2BodyPair> pairs;
+	grid.FindPairs(bodies, static_cast<int>(bodies.size()), displacements, pairs);
+	ASSERT_EQ(pairs.size(), 1u);
+	EXPECT_EQ(SortPairs(pairs), FindOverlappingPairs(bodies));
+}
+
+TEST(Physics, TestGridBroadPhaseHugeBody)
+{
+	//A ground far bigger than the cells tuned for the small bodies
+	const int bodiesNmb = 200;
+	std::vector<p2Body> bodies(bodiesNmb + 1);
+	p2RectShape rectShape(p2Vec2(0.05f, 0.05f));
+	std::mt19937 generator(3);
+	CreateRandomBodies(bodies, rectShape, 20.0f, generator);
+	p2RectShape groundShape(p2Vec2(5000.0f, 5.0f));
+	p2BodyDef groundDef;
+	groundDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+	groundDef.position = p2Vec2(0.0f, 0.0f);
+	p2ColliderDef groundColliderDef;
+	groundColliderDef.shape = &groundShape;
+	bodies[bodiesNmb].Init(&groundDef);
+	bodies[bodiesNmb].CreateCollider(&groundColliderDef);
+
+	const std::vector<p2Vec2> displacements(bodies.size(), p2Vec2(0.0f, 0.0f));
+	const auto overlappingPairs = FindOverlappingPairs(bodies);
+	ASSERT_FALSE(overlappingPairs.empty());
+	for (int threadNmb = 1; threadNmb <= 2; threadNmb++)
+	{
+		p2GridBroadPhase grid(0.01f, threadNmb);
+		std::vector<p2BodyPair> pairs;
+		const auto start = std::chrono::high_resolution_clock::now();
+		grid.FindPairs(bodies, static_cast<int>(bodies.size()), displacements, pairs);
+		const std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+		EXPECT_EQ(SortPairs(pairs), overlappingPairs);
+		EXPECT_LT(duration.count(), 1.0);
+	}
+}
+
+TEST(Physics, TestBroadPhaseComparison)
+{
+	const int bodiesNmb = 1000;
+	const int stepNmb = 10;
+	p2RectShape rectShape(p2Vec2(0.25f, 0.25f));
+
+	std::unique_ptr<p2BroadPhase> broadPhases[] =
+	{
+		std::unique_ptr<p2BroadPhase>(new p2QuadTreeBroadPhase(p2AABB({ 0.0f, 0.0f }, { 30.0f, 30.0f }))),
+		std::unique_ptr<p2BroadPhase>(new p2AABBTreeBroadPhase()),
+		std::unique_ptr<p2BroadPhase>(new p2GridBroadPhase()),
+		std::unique_ptr<p2BroadPhase>(new p2SweepAndPruneBroadPhase())
+	};
+	const char* broadPhaseNames[] = { "QuadTree", "AABBTree", "Grid", "SweepAndPrune" };
+
+	for (int broadPhaseIndex = 0; broadPhaseIndex < 4; broadPhaseIndex++)
+	{
+		//Same bodies and movements for every broad phase
+		std::mt19937 generator(42);
+		std::uniform_real_distribution<float> moveDistribution(-0.05f, 0.05f);
+		std::vector<p2Body> bodies(bodiesNmb);
+		CreateRandomBodies(bodies, rectShape, 30.0f, generator);
+		std::vector<p2Vec2> displacements(bodiesNmb);
+		std::vector<p2BodyPair> pairs;
+
+		std::chrono::duration<double, std::milli> duration(0.0);
+		for (int step = 0; step < stepNmb; step++)
+		{
+			for (int i = 0; i < bodiesNmb; i++)
+			{
+				displacements[i] = p2Vec2(moveDistribution(generator), moveDistribution(generator));
+				bodies[i].SetPosition(bodies[i].GetPosition() + displacements[i]);
+			}
+
+			pairs.clear();
+			const auto start = std::chrono::high_resolution_clock::now();
+			broadPhases[broadPhaseIndex]->FindPairs(bodies, bodiesNmb, displacements, pairs);
+			duration += std::chrono::high_resolution_clock::now() - start;
+		}
+
+		//The quadtree is only timed, the others find at least every overlapping pair
+		if (broadPhaseIndex != 0)
+		{
+			auto foundPairs = SortPairs(pairs);
+			for (auto& overlappingPair : FindOverlappingPairs(bodies))
+			{
+				EXPECT_TRUE(std::binary_search(foundPairs.begin(), foundPairs.end(), overlappingPair));
+			}
+		}
+		std::cout << broadPhaseNames[broadPhaseIndex] << " broad phase: " << duration.count() / stepNmb << " ms per step, " <<
+			pairs.size() << " pairs, " << broadPhases[broadPhaseIndex]->GetMemoryFootprint() << " bytes\n";
+	}
+}
+
+TEST(Physics, TestSweepAndPrune)
+{
+	const int bodiesNmb = 1000;
+	std::vector<p2Body> bodies(bodiesNmb);
+	p2RectShape rectShape(p2Vec2(0.25f, 0.25f));
+	std::mt19937 generator(42);
+	CreateRandomBodies(bodies, rectShape, 30.0f, generator);
+	std::uniform_real_distribution<float> moveDistribution(-0.05f, 0.05f);
+	std::vector<p2Vec2> displacements(bodiesNmb, p2Vec2(0.0f, 0.0f));
+
+	p2SweepAndPruneBroadPhase sweepAndPrune;
+	std::vector<std::pair<p2Body*, p2Body*>> previousPairs;
+	size_t insertionSwapNmb = 0;
+	for (int step = 0; step < 20; step++)
+	{
+		//Half of the bodies are added at the first step, the others at the second one
+		const int bodyNmb = step == 0 ? bodiesNmb / 2 : bodiesNmb;
+		std::vector<p2BodyPair> pairs;
+		sweepAndPrune.FindPairs(bodies, bodyNmb, displacements, pairs);
+		if (step == 1)
+			insertionSwapNmb = sweepAndPrune.GetSwapNmb();
+
+		std::vector<p2Body> addedBodies(bodies.begin(), bodies.begin() + bodyNmb);
+		auto currentPairs = SortPairs(pairs);
+		std::vector<std::pair<p2Body*, p2Body*>> overlappingPairs;
+		for (auto& pair : FindOverlappingPairs(addedBodies))
+		{
+			overlappingPairs.emplace_back(&bodies[pair.first - &addedBodies[0]], &bodies[pair.second - &addedBodies[0]]);
+		}
+		std::sort(overlappingPairs.begin(), overlappingPairs.end());
+		EXPECT_EQ(currentPairs, overlappingPairs);
+
+		//The previous pairs plus the began ones minus the ended ones give the current ones
+		auto beganPairs = SortPairs(sweepAndPrune.GetBeganPairs());
+		auto endedPairs = SortPairs(sweepAndPrune.GetEndedPairs());
+		std::vector<std::pair<p2Body*, p2Body*>> expectedPairs;
+		std::set_difference(previousPairs.begin(), previousPairs.end(), endedPairs.begin(), endedPairs.end(),
+			std::back_inserter(expectedPairs));
+		expectedPairs.insert(expectedPairs.end(), beganPairs.begin(), beganPairs.end());
+		std::sort(expectedPairs.begin(), expectedPairs.end());
+		EXPECT_EQ(expectedPairs, currentPairs);
+		EXPECT_TRUE(std::includes(previousPairs.begin(), previousPairs.end(), endedPairs.begin(), endedPairs.end()));
+		previousPairs = currentPairs;
+
+		for (int i = 0; i < bodiesNmb; i++)
+		{
+			displacements[i] = p2Vec2(moveDistribution(generator), moveDistribution(generator));
+			bodies[i].SetPosition(bodies[i].GetPosition() + displacements[i]);
+		}
+	}
+	//Coherent movements need far less swaps than sorting the added bodies
+	EXPECT_LT(sweepAndPrune.GetSwapNmb() * 10, insertionSwapNmb);
+}
+
+namespace
+{
+class CountingContactListener : public p2ContactListener
+{
+public:
+	void BeginContact(p2Contact* contact) override
+	{
+		(void)contact;
+		beginNmb++;
+	}
+	void EndContact(p2Contact* contact) override
+	{
+		(void)contact;
+		endNmb++;
+	}
+	int beginNmb = 0;
+	int endNmb = 0;
+};
+}
+
+TEST(Physics, TestContactManager)
+{
+	const int collidersNmb = 100;
+	std::vector<p2Collider> colliders(collidersNmb);
+	p2ContactManager contactManager;
+
+	//Every pair with the first collider, the addresses must survive the growth of the pool
+	std::vector<p2Contact*> contacts;
+	for (int i = 1; i < collidersNmb; i++)
+	{
+		contacts.push_back(contactManager.CreateContact(&colliders[0], &colliders[i]));
+		ASSERT_NE(contacts.back(), nullptr);
+	}
+	for (int i = 1; i < 20; i++)
+	{
+		for (int j = i + 1; j < collidersNmb; j++)
+		{
+			contactManager.CreateContact(&colliders[j], &colliders[i]);
+		}
+	}
+	const int contactNmb = contactManager.GetContactNmb();
+	for (int i = 1; i < collidersNmb; i++)
+	{
+		//Same contact whatever the order of the colliders
+		const int contactID = contactManager.GetContactID(&colliders[i], &colliders[0]);
+		ASSERT_NE(contactID, -1);
+		EXPECT_EQ(contactManager.GetContactByID(contactID), contacts[i - 1]);
+		EXPECT_EQ(contacts[i - 1]->GetColliderA(), &colliders[0]);
+		EXPECT_EQ(contacts[i - 1]->GetColliderB(), &colliders[i]);
+		EXPECT_EQ(contactManager.CreateContact(&colliders[0], &colliders[i]), nullptr);
+	}
+	EXPECT_EQ(contactManager.GetContactID(&colliders[collidersNmb - 1], &colliders[collidersNmb - 2]), -1);
+
+	//Destroying in the middle keeps the other contacts reachable
+	for (int i = 1; i < collidersNmb; i += 2)
+	{
+		contactManager.DestroyContact(&colliders[0], &colliders[i]);
+	}
+	EXPECT_EQ(contactManager.GetContactNmb(), contactNmb - collidersNmb / 2);
+	for (int i = 1; i < collidersNmb; i++)
+	{
+		const int contactID = contactManager.GetContactID(&colliders[0], &colliders[i]);
+		if (i % 2 == 1)
+		{
+			EXPECT_EQ(contactID, -1);
+		}
+		else
+		{
+			ASSERT_NE(contactID, -1);
+			EXPECT_EQ(contactManager.GetContactByID(contactID), contacts[i - 1]);
+		}
+	}
+	for (int i = 1; i < 20; i++)
+	{
+		for (int j = i + 1; j < collidersNmb; j++)
+		{
+			EXPECT_NE(contactManager.GetContactID(&colliders[i], &colliders[j]), -1);
+		}
+	}
+
+	//Freed contacts are reused
+	const size_t footprint = contactManager.GetMemoryFootprint();
+	contactManager.CreateContact(&colliders[0], &colliders[1]);
+	EXPECT_EQ(contactManager.GetMemoryFootprint(), footprint);
+
+	//Only the contacts touched during the step survive it
+	CountingContactListener contactListener;
+	contactManager.BeginStep();
+	contactManager.UpdateContact(&colliders[0], &colliders[2]);
+	contactManager.UpdateContact(&colliders[50], &colliders[51]);
+	contactManager.EndStep(&contactListener);
+	EXPECT_EQ(contactListener.beginNmb, 1);
+	EXPECT_EQ(contactListener.endNmb, contactNmb - collidersNmb / 2);
+	EXPECT_EQ(contactManager.GetContactNmb(), 2);
+	EXPECT_EQ(contactManager.GetContactByID(contactManager.GetContactID(&colliders[0], &colliders[2])), contacts[1]);
+}
+
+TEST(Physics, TestWorldContacts)
+{
+	for (auto broadPhaseType : { p2BroadPhaseType::AABB_TREE, p2BroadPhaseType::SWEEP_AND_PRUNE })
+	{
+		p2WorldDef worldDef;
+		worldDef.gravity = p2Vec2(0.0f, 0.0f);
+		worldDef.screenResolution = p2Vec2(1280.0f, 720.0f);
+		worldDef.broadPhaseType = broadPhaseType;
+		p2World world(worldDef);
+		CountingContactListener contactListener;
+		world.SetContactListener(&contactListener);
+
+		p2CircleShape circleShape(0.5f);
+		p2ColliderDef colliderDef;
+		colliderDef.shape = &circleShape;
+		p2BodyDef bodyDef;
+		bodyDef.type = p2BodyType::DYNAMIC;
+		bodyDef.gravityScale = 1.0f;
+		bodyDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+		bodyDef.position = p2Vec2(1.0f, 1.0f);
+		p2Body* body1 = world.CreateBody(&bodyDef);
+		body1->CreateCollider(&colliderDef);
+		bodyDef.position = p2Vec2(1.5f, 1.0f);
+		p2Body* body2 = world.CreateBody(&bodyDef);
+		body2->CreateCollider(&colliderDef);
+
+		//The contact begins once and lasts while the bodies touch
+		for (int step = 0; step < 5; step++)
+		{
+			world.Step(0.02f);
+		}
+		EXPECT_EQ(contactListener.beginNmb, 1);
+		EXPECT_EQ(contactListener.endNmb, 0);
+
+		body2->SetPosition(p2Vec2(10.0f, 5.0f));
+		for (int step = 0; step < 5; step++)
+		{
+			world.Step(0.02f);
+		}
+		EXPECT_EQ(contactListener.beginNmb, 1);
+		EXPECT_EQ(contactListener.endNmb, 1);
+	}
+}
+
+TEST(Physics, TestNarrowPhaseShapes)
+{
+	p2Manifold manifold;
+	EXPECT_TRUE(p2CollideCircles(p2Vec2(0.0f, 0.0f), 1.0f, p2Vec2(1.5f, 0.0f), 1.0f, manifold));
+	EXPECT_NEAR(manifold.normal.x, 1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.normal.y, 0.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.5f, 1e-5f);
+	EXPECT_EQ(manifold.pointNmb, 1);
+	EXPECT_FALSE(p2CollideCircles(p2Vec2(0.0f, 0.0f), 1.0f, p2Vec2(2.5f, 0.0f), 1.0f, manifold));
+
+	const p2AABB rectA(p2Vec2(-1.0f, -1.0f), p2Vec2(1.0f, 1.0f));
+	EXPECT_TRUE(p2CollideRects(rectA, p2AABB(p2Vec2(0.5f, -0.5f), p2Vec2(2.5f, 1.5f)), manifold));
+	EXPECT_NEAR(manifold.normal.x, 1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.5f, 1e-5f);
+	EXPECT_EQ(manifold.pointNmb, 2);
+	EXPECT_NEAR(manifold.points[0].y, -0.5f, 1e-5f);
+	EXPECT_NEAR(manifold.points[1].y, 1.0f, 1e-5f);
+	EXPECT_FALSE(p2CollideRects(rectA, p2AABB(p2Vec2(1.5f, -0.5f), p2Vec2(2.5f, 1.5f)), manifold));
+
+	EXPECT_TRUE(p2CollideCircleRect(p2Vec2(0.0f, 1.5f), 1.0f, rectA, manifold));
+	EXPECT_NEAR(manifold.normal.y, -1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.5f, 1e-5f);
+	EXPECT_NEAR(manifold.points[0].y, 1.0f, 1e-5f);
+	//Center inside the rect, the circle is pushed out through the closest edge
+	EXPECT_TRUE(p2CollideCircleRect(p2Vec2(0.8f, 0.0f), 0.5f, rectA, manifold));
+	EXPECT_NEAR(manifold.normal.x, -1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.7f, 1e-5f);
+	EXPECT_FALSE(p2CollideCircleRect(p2Vec2(1.8f, 1.8f), 1.0f, rectA, manifold));
+
+	p2PolygonShape box;
+	box.SetAsBox(p2Vec2(1.0f, 1.0f));
+	EXPECT_TRUE(p2CollideCirclePolygon(p2Vec2(0.0f, 1.5f), 1.0f, box, p2Vec2(0.0f, 0.0f), manifold));
+	EXPECT_NEAR(manifold.normal.y, -1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.5f, 1e-5f);
+	EXPECT_FALSE(p2CollideCirclePolygon(p2Vec2(1.8f, 1.8f), 1.0f, box, p2Vec2(0.0f, 0.0f), manifold));
+
+	//Clockwise triangle, reversed by SetVertices
+	p2PolygonShape triangle;
+	const p2Vec2 vertices[] = { p2Vec2(0.0f, 1.0f), p2Vec2(1.0f, -1.0f), p2Vec2(-1.0f, -1.0f) };
+	EXPECT_TRUE(triangle.SetVertices(vertices, 3));
+	EXPECT_TRUE(p2CollidePolygons(box, p2Vec2(0.0f, 0.0f), triangle, p2Vec2(0.0f, 1.5f), manifold));
+	EXPECT_NEAR(manifold.normal.x, 0.0f, 1e-5f);
+	EXPECT_NEAR(manifold.normal.y, 1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.5f, 1e-5f);
+	EXPECT_EQ(manifold.pointNmb, 2);
+	//Same contact seen from the triangle
+	EXPECT_TRUE(p2CollidePolygons(triangle, p2Vec2(0.0f, 1.5f), box, p2Vec2(0.0f, 0.0f), manifold));
+	EXPECT_NEAR(manifold.normal.y, -1.0f, 1e-5f);
+	EXPECT_NEAR(manifold.penetration, 0.5f, 1e-5f);
+
+	p2SeparatingAxis separatingAxis;
+	EXPECT_FALSE(p2CollidePolygons(box, p2Vec2(0.0f, 0.0f), triangle, p2Vec2(3.0f, 0.0f), manifold, &separatingAxis));
+	EXPECT_GT(p2GetPolygonSeparation(box, p2Vec2(0.0f, 0.0f), triangle, p2Vec2(3.0f, 0.0f), separatingAxis), 0.0f);
+	EXPECT_LE(p2GetPolygonSeparation(box, p2Vec2(0.0f, 0.0f), triangle, p2Vec2(0.5f, 0.0f), separatingAxis), 0.0f);
+}
+
+TEST(Physics, TestPolygonVertices)
+{
+	p2PolygonShape polygon;
+	const p2Vec2 segment[] = { p2Vec2(0.0f, 0.0f), p2Vec2(1.0f, 0.0f) };
+	EXPECT_FALSE(polygon.SetVertices(segment, 2));
+	EXPECT_EQ(polygon.GetVertexNmb(), 0);
+
+	//Duplicate and collinear vertices are dropped, their edges have no normal
+	const p2Vec2 square[] = { p2Vec2(0.0f, 0.0f), p2Vec2(0.0f, 0.0f), p2Vec2(1.0f, 0.0f), p2Vec2(2.0f, 0.0f),
+		p2Vec2(2.0f, 2.0f), p2Vec2(0.0f, 2.0f), p2Vec2(0.0f, 0.0f) };
+	EXPECT_TRUE(polygon.SetVertices(square, 7));
+	ASSERT_EQ(polygon.GetVertexNmb(), 4);
+	for (int i = 0; i < polygon.GetVertexNmb(); i++)
+	{
+		const p2Vec2& normal = polygon.GetNormal(i);
+		EXPECT_FALSE(std::isnan(normal.x) || std::isnan(normal.y));
+		EXPECT_NEAR(normal.GetMagnitude(), 1.0f, 1e-5f);
+	}
+
+	const p2Vec2 line[] = { p2Vec2(0.0f, 0.0f), p2Vec2(1.0f, 1.0f), p2Vec2(2.0f, 2.0f) };
+	EXPECT_FALSE(polygon.SetVertices(line, 3));
+	EXPECT_EQ(polygon.GetVertexNmb(), 0);
+	const p2Vec2 point[] = { p2Vec2(1.0f, 1.0f), p2Vec2(1.0f, 1.0f), p2Vec2(1.0f, 1.0f) };
+	EXPECT_FALSE(polygon.SetVertices(point, 3));
+
+	//Concave and self-intersecting polygons are rejected
+	const p2Vec2 arrow[] = { p2Vec2(0.0f, 0.0f), p2Vec2(2.0f, 1.0f), p2Vec2(0.0f, 2.0f), p2Vec2(0.5f, 1.0f) };
+	EXPECT_FALSE(polygon.SetVertices(arrow, 4));
+	const p2Vec2 star[] = { p2Vec2(0.0f, 1.0f), p2Vec2(0.59f, -0.81f), p2Vec2(-0.95f, 0.31f), p2Vec2(0.95f, 0.31f), p2Vec2(-0.59f, -0.81f) };
+	EXPECT_FALSE(polygon.SetVertices(star, 5));
+	EXPECT_EQ(polygon.GetVertexNmb(), 0);
+}
+
+TEST(Physics, TestNarrowPhaseBatch)
+{
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> positionDistribution(0.0f, 8.0f);
+	std::uniform_real_distribution<float> sizeDistribution(0.2f, 0.8f);
+
+	p2CircleShape circleShape;
+	p2RectShape rectShape;
+	p2PolygonShape polygonShape;
+	p2ColliderDef colliderDef;
+	p2BodyDef bodyDef;
+	bodyDef.type = p2BodyType::DYNAMIC;
+	bodyDef.gravityScale = 1.0f;
+	bodyDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+
+	//Every shape type, the shapes are copied by the colliders
+	std::vector<p2Body> bodies(90);
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		bodyDef.position = p2Vec2(positionDistribution(generator), positionDistribution(generator));
+		bodies[i].Init(&bodyDef);
+		const float size = sizeDistribution(generator);
+		switch (i % 3)
+		{
+		case 0:
+			circleShape.SetRadius(size);
+			colliderDef.shape = &circleShape;
+			break;
+		case 1:
+			rectShape.SetSize(p2Vec2(size, size * 0.5f));
+			colliderDef.shape = &rectShape;
+			break;
+		default:
+		{
+			const p2Vec2 vertices[] = { p2Vec2(-size, -size), p2Vec2(size, -size * 0.5f), p2Vec2(0.0f, size) };
+			polygonShape.SetVertices(vertices, 3);
+			colliderDef.shape = &polygonShape;
+			break;
+		}
+		}
+		bodies[i].CreateCollider(&colliderDef);
+	}
+	std::vector<p2BodyPair> pairs;
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		for (size_t j = i + 1; j < bodies.size(); j++)
+		{
+			pairs.push_back({ &bodies[i], &bodies[j] });
+		}
+	}
+
+	p2NarrowPhase narrowPhase;
+	std::vector<p2ColliderManifold> manifolds;
+	narrowPhase.Collide(pairs, manifolds);
+	size_t totalShapePairNmb = 0;
+	for (int i = 0; i < static_cast<int>(p2ShapePairType::LENGTH); i++)
+	{
+		EXPECT_GT(narrowPhase.GetShapePairNmb(static_cast<p2ShapePairType>(i)), 0u);
+		totalShapePairNmb += narrowPhase.GetShapePairNmb(static_cast<p2ShapePairType>(i));
+	}
+	EXPECT_EQ(totalShapePairNmb, pairs.size());
+	EXPECT_EQ(narrowPhase.GetCachedAxisRejectNmb(), 0u);
+
+	//The batched results match the scalar tests of each pair
+	size_t touchingNmb = 0;
+	size_t polygonTouchingNmb = 0;
+	for (auto& pair : pairs)
+	{
+		p2Collider* colliderA = pair.bodyA->GetCollider();
+		p2Collider* colliderB = pair.bodyB->GetCollider();
+		p2Vec2 positionA = pair.bodyA->GetPosition();
+		p2Vec2 positionB = pair.bodyB->GetPosition();
+		if (colliderA->GetShape()->m_Type > colliderB->GetShape()->m_Type)
+		{
+			std::swap(colliderA, colliderB);
+			std::swap(positionA, positionB);
+		}
+		const ShapeType typeA = colliderA->GetShape()->m_Type;
+		const ShapeType typeB = colliderB->GetShape()->m_Type;
+
+		p2Manifold manifold;
+		bool touching = false;
+		if (typeA == ShapeType::CIRCLE && typeB == ShapeType::CIRCLE)
+		{
+			touching = p2CollideCircles(positionA, static_cast<const p2CircleShape*>(colliderA->GetShape())->GetRadius(),
+				positionB, static_cast<const p2CircleShape*>(colliderB->GetShape())->GetRadius(), manifold);
+		}
+		else if (typeA == ShapeType::CIRCLE && typeB == ShapeType::RECT)
+		{
+			const p2Vec2 size = static_cast<const p2RectShape*>(colliderB->GetShape())->GetSize();
+			touching = p2CollideCircleRect(positionA, static_cast<const p2CircleShape*>(colliderA->GetShape())->GetRadius(),
+				p2AABB(positionB - size, positionB + size), manifold);
+		}
+		else if (typeA == ShapeType::RECT && typeB == ShapeType::RECT)
+		{
+			const p2Vec2 sizeA = static_cast<const p2RectShape*>(colliderA->GetShape())->GetSize();
+			const p2Vec2 sizeB = static_cast<const p2RectShape*>(colliderB->GetShape())->GetSize();
+			touching = p2CollideRects(p2AABB(positionA - sizeA, positionA + sizeA), p2AABB(positionB - sizeB, positionB + sizeB), manifold);
+		}
+		else if (typeA == ShapeType::CIRCLE)
+		{
+			touching = p2CollideCirclePolygon(positionA, static_cast<const p2CircleShape*>(colliderA->GetShape())->GetRadius(),
+				*static_cast<const p2PolygonShape*>(colliderB->GetShape()), positionB, manifold);
+		}
+		else
+		{
+			p2PolygonShape box;
+			const p2PolygonShape* polygonA = static_cast<const p2PolygonShape*>(colliderA->GetShape());
+			if (typeA == ShapeType::RECT)
+			{
+				box.SetAsBox(static_cast<const p2RectShape*>(colliderA->GetShape())->GetSize());
+				polygonA = &box;
+			}
+			touching = p2CollidePolygons(*polygonA, positionA, *static_cast<const p2PolygonShape*>(colliderB->GetShape()), positionB, manifold);
+			if (touching)
+				polygonTouchingNmb++;
+		}
+
+		auto found = std::find_if(manifolds.begin(), manifolds.end(), [&](const p2ColliderManifold& colliderManifold)
+		{
+			return (colliderManifold.colliderA == colliderA && colliderManifold.colliderB == colliderB) ||
+				(colliderManifold.colliderA == colliderB && colliderManifold.colliderB == colliderA);
+		});
+		EXPECT_EQ(touching, found != manifolds.end());
+		if (touching && found != manifolds.end())
+		{
+			touchingNmb++;
+			EXPECT_NEAR(found->manifold.penetration, manifold.penetration, 1e-5f);
+			EXPECT_EQ(found->manifold.pointNmb, manifold.pointNmb);
+		}
+	}
+	EXPECT_EQ(touchingNmb, manifolds.size());
+	EXPECT_GT(touchingNmb, 0u);
+
+	//Nothing moved, the separated polygon pairs are rejected by their cached axis
+	manifolds.clear();
+	narrowPhase.Collide(pairs, manifolds);
+	EXPECT_EQ(manifolds.size(), touchingNmb);
+	EXPECT_EQ(narrowPhase.GetCachedAxisRejectNmb(),
+		narrowPhase.GetShapePairNmb(p2ShapePairType::RECT_POLYGON) +
+		narrowPhase.GetShapePairNmb(p2ShapePairType::POLYGON_POLYGON) - polygonTouchingNmb);
+
+	//The axes of the pairs that left the broad phase are forgotten
+	pairs.clear();
+	narrowPhase.Collide(pairs, manifolds);
+	EXPECT_EQ(narrowPhase.GetCachedAxisRejectNmb(), 0u);
+	EXPECT_GT(narrowPhase.GetMemoryFootprint(), 0u);
+}
+
+TEST(Physics, TestWorldManifolds)
+{
+	p2World world(p2Vec2(0.0f, 0.0f), p2Vec2(1280.0f, 720.0f));
+	p2BodyDef bodyDef;
+	bodyDef.type = p2BodyType::DYNAMIC;
+	bodyDef.gravityScale = 1.0f;
+	bodyDef.linearVelocity = p2Vec2(0.0f, 0.0f);
+
+	p2ColliderDef colliderDef;
+	{
+		//The shapes are copied, they can be destroyed once the colliders are created
+		p2PolygonShape polygonShape;
+		polygonShape.SetAsBox(p2Vec2(1.0f, 1.0f));
+		colliderDef.shape = &polygonShape;
+		bodyDef.position = p2Vec2(2.0f, 2.0f);
+		world.CreateBody(&bodyDef)->CreateCollider(&colliderDef);
+
+		p2CircleShape circleShape(1.0f);
+		colliderDef.shape = &circleShape;
+		bodyDef.position = p2Vec2(2.0f, 3.5f);
+		world.CreateBody(&bodyDef)->CreateCollider(&colliderDef);
+	}
+
+	world.Step(0.02f);
+	ASSERT_EQ(world.GetManifolds().size(), 1u);
+	const p2ColliderManifold& colliderManifold = world.GetManifolds()[0];
+	EXPECT_EQ(colliderManifold.colliderA->GetShape()->m_Type, ShapeType::CIRCLE);
+	EXPECT_NEAR(colliderManifold.manifold.normal.y, -1.0f, 1e-5f);
+	EXPECT_NEAR(colliderManifold.manifold.penetration, 0.5f, 1e-5f);
+}
@@ -26,6 +26,9 @@ SOFTWARE.
 #include <utility/json_utility.h>
 #include <graphics/shape2d.h>
 #include <engine/scene.h>
+#include <engine/config.h>
+#include <python/python_engine.h>
+#include <pybind11/stl.h>
 #include <gtest/gtest.h>
 
 TEST(OldPython, TestPyComponent)
@@ -64,3 +67,48 @@ TEST(OldPython, TestPyComponent)
 	
 	engine.Start();
 }
+
+TEST(Python, TestEntityViewIterationChanges)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto* transformManager = engine.GetTransform2dManager();
+	for (int i = 0; i < 10; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(INVALID_ENTITY);
+		transformManager->AddComponent(entity);
+	}
+
+	//Destroying, creating and adding components while looping changes the view under the iterator
+	engine.GetPythonEngine()->ExecutePythonCommand(
+		"from SFGE import *\n"
+		"view = entity_manager.get_view(System.Transform2d)\n"
+		"originals = list(view)\n"
+		"visited = []\n"
+		"stale_nmb = 0\n"
+		"for entity in view:\n"
+		"    if not entity_manager.is_entity_valid(entity) or entity in visited:\n"
+		"        stale_nmb += 1\n"
+		"    visited.append(entity)\n"
+		"    if len(visited) == 1:\n"
+		"        entity_manager.destroy_entity(originals[-1])\n"
+		"    entity_manager.destroy_entity(entity)\n"
+		"    for i in range(4):\n"
+		"        transform2d_manager.add_component(entity_manager.create_entity(0))\n"
+		"view_nmb = len(view)\n");
+
+	const auto globals = py::globals();
+	ASSERT_TRUE(globals.contains("view_nmb"));
+	//The entity destroyed ahead is skipped and the new ones wait for the next loop
+	EXPECT_EQ(globals["stale_nmb"].cast<int>(), 0);
+	auto originals = globals["originals"].cast<std::vector<Entity>>();
+	originals.pop_back();
+	EXPECT_EQ(globals["visited"].cast<std::vector<Entity>>(), originals);
+	EXPECT_EQ(globals["view_nmb"].cast<size_t>(), 9u * 4u);
+	engine.Destroy();
+}
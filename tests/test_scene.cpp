@@ -24,6 +24,13 @@ SOFTWARE.
 
 #include <engine/engine.h>
 #include <engine/scene.h>
+#include <engine/entity.h>
+#include <engine/transform2d.h>
+#include <engine/snapshot.h>
+#include <engine/prefab.h>
+#include <graphics/graphics2d.h>
+#include <graphics/sprite2d.h>
+#include <graphics/texture.h>
 #include <utility/json_utility.h>
 #include <gtest/gtest.h>
 
@@ -58,4 +65,134 @@ TEST(Scene, TestSwitchSceneLeak)
 
 
 
-}
\ No newline at end of file
+}
+
+TEST(Scene, TestSnapshotRestore)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto* transformManager = engine.GetTransform2dManager();
+	auto* spriteManager = engine.GetGraphics2dManager()->GetSpriteManager();
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 10; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(0);
+		transformManager->AddComponent(entity)->Position = sfge::Vec2f(10.0f * i, 0.0f);
+		if (i % 2 == 0)
+			spriteManager->AddComponent(entity);
+		entities.push_back(entity);
+	}
+	transformManager->SetParent(entities[1], entities[0]);
+	transformManager->UpdateWorldTransforms();
+	//Not part of the snapshot
+	entityManager->AddComponentType(entities[3], sfge::ComponentType::SOUND);
+
+	sfge::WorldSnapshot snapshot;
+	engine.SaveSnapshot(snapshot);
+	ASSERT_FALSE(snapshot.IsEmpty());
+	const unsigned childVersion = transformManager->GetWorldVersion(entities[1]);
+
+	//Play: move, detach, destroy and create entities
+	transformManager->GetComponentRef(entities[0]).Position = sfge::Vec2f(100.0f, 100.0f);
+	transformManager->SetParent(entities[1], INVALID_ENTITY);
+	entityManager->DestroyEntities({ entities[2], entities[3] });
+	const Entity newEntity = entityManager->CreateEntity(0);
+	spriteManager->AddComponent(newEntity);
+	//The slot of entities[2] is used again
+	ASSERT_EQ(GetEntityIndex(newEntity), GetEntityIndex(entities[2]));
+
+	//A truncated snapshot fails without touching the world
+	sfge::WorldSnapshot truncatedSnapshot;
+	truncatedSnapshot.Write(size_t(10));
+	ASSERT_FALSE(engine.RestoreSnapshot(truncatedSnapshot));
+	ASSERT_TRUE(entityManager->IsEntityValid(newEntity));
+	ASSERT_FALSE(entityManager->IsEntityValid(entities[3]));
+
+	ASSERT_TRUE(engine.RestoreSnapshot(snapshot));
+	//The saved handle is valid again when its slot was not used since, and the entity created after the snapshot is gone
+	ASSERT_TRUE(entityManager->IsEntityValid(entities[3]));
+	ASSERT_FALSE(entityManager->IsEntityValid(newEntity));
+	//The reused slot comes back with a new handle so the handle of newEntity can never be valid again
+	ASSERT_FALSE(entityManager->IsEntityValid(entities[2]));
+	const Entity restoredEntity = entityManager->GetEntity(GetEntityIndex(entities[2]));
+	ASSERT_TRUE(entityManager->IsEntityValid(restoredEntity));
+	ASSERT_NE(restoredEntity, newEntity);
+	ASSERT_NE(entityManager->CreateEntity(0), newEntity);
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), 5u);
+	ASSERT_TRUE(spriteManager->HasComponent(restoredEntity));
+	ASSERT_TRUE(entityManager->HasComponent(entities[3], sfge::ComponentType::TRANSFORM2D));
+	//Components outside of the snapshot were destroyed with the entity
+	ASSERT_FALSE(entityManager->HasComponent(entities[3], sfge::ComponentType::SOUND));
+
+	ASSERT_EQ(transformManager->GetTransform(entities[0]).Position, sfge::Vec2f(0.0f, 0.0f));
+	ASSERT_EQ(transformManager->GetParent(entities[1]), entities[0]);
+	ASSERT_EQ(transformManager->GetWorldTransform(entities[1]).Position, sfge::Vec2f(10.0f, 0.0f));
+	//Readers see the restored transforms as changed
+	ASSERT_GT(transformManager->GetWorldVersion(entities[1]), childVersion);
+
+	engine.Destroy();
+}
+
+TEST(Scene, TestInstantiatePrefab)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* sceneManager = engine.GetSceneManager();
+	auto* entityManager = engine.GetEntityManager();
+	auto* transformManager = engine.GetTransform2dManager();
+	auto* spriteManager = engine.GetGraphics2dManager()->GetSpriteManager();
+	auto* textureManager = engine.GetGraphics2dManager()->GetTextureManager();
+
+	json prefabJson = {
+		{ "name", "Planet" },
+		{ "components", json::array({
+			{ { "type", sfge::ComponentType::TRANSFORM2D }, { "position", { 0, 0 } } },
+			{ { "type", sfge::ComponentType::SPRITE2D }, { "path", "data/sprites/round.png" } }
+		}) }
+	};
+	const auto prefab = sceneManager->CreatePrefab(prefabJson);
+	ASSERT_EQ(prefab.GetName(), "Planet");
+	ASSERT_EQ(prefab.GetComponents().size(), 2u);
+
+	const size_t count = 100;
+	const auto entities = sceneManager->Instantiate(prefab, count, [transformManager](Entity entity, size_t instanceIndex)
+	{
+		transformManager->GetComponentRef(entity).Position = sfge::Vec2f(instanceIndex, 0.0f);
+	});
+	ASSERT_EQ(entities.size(), count);
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), count);
+
+	//Every sprite shares the texture loaded once from the prefab
+	const auto textureId = textureManager->LoadTexture("data/sprites/round.png");
+	for (size_t i = 0; i < count; i++)
+	{
+		ASSERT_TRUE(entityManager->IsEntityValid(entities[i]));
+		ASSERT_TRUE(entityManager->HasComponent(entities[i], sfge::ComponentType::TRANSFORM2D));
+		ASSERT_TRUE(entityManager->HasComponent(entities[i], sfge::ComponentType::SPRITE2D));
+		ASSERT_EQ(transformManager->GetTransform(entities[i]).Position, sfge::Vec2f(i, 0.0f));
+		ASSERT_EQ(spriteManager->GetComponentRef(entities[i]).GetTextureId(), textureId);
+	}
+
+	//Instances of the same prefab can be created in parallel
+	const auto parallelEntities = sceneManager->Instantiate(prefab, count, [transformManager](Entity entity, size_t instanceIndex)
+	{
+		transformManager->GetComponentRef(entity).Position = sfge::Vec2f(0.0f, instanceIndex);
+	}, true);
+	ASSERT_EQ(spriteManager->GetComponentsNmb(), 2 * count);
+	for (size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQ(transformManager->GetTransform(parallelEntities[i]).Position, sfge::Vec2f(0.0f, i));
+	}
+
+	engine.Destroy();
+}
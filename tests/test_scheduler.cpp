@@ -0,0 +1,204 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <mutex>
+#include <algorithm>
+#include <engine/engine.h>
+#include <engine/scheduler.h>
+#include <engine/component.h>
+#include <engine/config.h>
+#include <engine/entity.h>
+#include <engine/transform2d.h>
+#include <gtest/gtest.h>
+
+class RecordingSystem : public sfge::System
+{
+public:
+	RecordingSystem(sfge::Engine& engine, int id, sfge::EntityMask readMask, sfge::EntityMask writeMask,
+		std::vector<int>& order, std::mutex& orderMutex) :
+		System(engine), m_Id(id), m_Order(order), m_OrderMutex(orderMutex)
+	{
+		SetComponentAccess(readMask, writeMask, false);
+	}
+	void OnUpdate(float dt) override
+	{
+		(void) dt;
+		std::lock_guard<std::mutex> lock(m_OrderMutex);
+		m_Order.push_back(m_Id);
+	}
+private:
+	int m_Id;
+	std::vector<int>& m_Order;
+	std::mutex& m_OrderMutex;
+};
+
+class SpawningSystem : public sfge::System
+{
+public:
+	SpawningSystem(sfge::Engine& engine, float id, size_t spawnNmb) :
+		System(engine), m_Id(id), m_SpawnNmb(spawnNmb)
+	{
+		SetComponentAccess(sfge::EntityMask(), sfge::EntityMask(), false);
+	}
+	void OnUpdate(float dt) override
+	{
+		(void) dt;
+		const auto transformId = sfge::GetComponentTypeId(sfge::ComponentType::TRANSFORM2D);
+		auto& commandBuffer = m_Engine.GetEntityManager()->GetCommandBuffer();
+		for (size_t i = 0; i < m_SpawnNmb; i++)
+		{
+			const auto entity = commandBuffer.CreateEntity();
+			json transformJson;
+			transformJson["position"] = { m_Id, static_cast<float>(i) };
+			commandBuffer.AddComponent(entity, transformId, transformJson);
+		}
+	}
+private:
+	float m_Id;
+	size_t m_SpawnNmb;
+};
+
+TEST(Scheduler, TestSystemWaves)
+{
+	sfge::Engine engine;
+	std::vector<int> order;
+	std::mutex orderMutex;
+	const auto transformMask = static_cast<sfge::EntityMask>(sfge::ComponentType::TRANSFORM2D);
+	const auto spriteMask = static_cast<sfge::EntityMask>(sfge::ComponentType::SPRITE2D);
+	const auto shapeMask = static_cast<sfge::EntityMask>(sfge::ComponentType::SHAPE2D);
+	const auto soundMask = static_cast<sfge::EntityMask>(sfge::ComponentType::SOUND);
+
+	const sfge::EntityMask noMask;
+
+	RecordingSystem transformSystem(engine, 0, noMask, transformMask, order, orderMutex);
+	RecordingSystem audioSystem(engine, 1, noMask, soundMask, order, orderMutex);
+	RecordingSystem spriteSystem(engine, 2, transformMask, spriteMask, order, orderMutex);
+	RecordingSystem shapeSystem(engine, 3, transformMask, shapeMask, order, orderMutex);
+	RecordingSystem drawSystem(engine, 4, spriteMask | shapeMask, noMask, order, orderMutex);
+	//Undeclared access conflicts with everything
+	sfge::System barrierSystem(engine);
+
+	sfge::SystemScheduler scheduler;
+	scheduler.AddSystem(&transformSystem);
+	scheduler.AddSystem(&audioSystem);
+	scheduler.AddSystem(&spriteSystem);
+	scheduler.AddSystem(&shapeSystem);
+	scheduler.AddSystem(&drawSystem);
+	scheduler.AddSystem(&barrierSystem);
+	scheduler.Build();
+
+	const auto& waves = scheduler.GetWaves();
+	ASSERT_EQ(waves.size(), 4u);
+	ASSERT_EQ(waves[0], std::vector<size_t>({ 0, 1 }));
+	ASSERT_EQ(waves[1], std::vector<size_t>({ 2, 3 }));
+	ASSERT_EQ(waves[2], std::vector<size_t>({ 4 }));
+	ASSERT_EQ(waves[3], std::vector<size_t>({ 5 }));
+
+	ctpl::thread_pool threadPool(2);
+	for (int frame = 0; frame < 100; frame++)
+	{
+		order.clear();
+		scheduler.Update(0.0f, threadPool);
+		ASSERT_EQ(order.size(), 5u);
+		//Dependencies are always respected whatever the order inside a wave
+		const auto position = [&order](int id) { return std::find(order.begin(), order.end(), id) - order.begin(); };
+		ASSERT_LT(position(0), position(2));
+		ASSERT_LT(position(0), position(3));
+		ASSERT_LT(position(2), position(4));
+		ASSERT_LT(position(3), position(4));
+	}
+}
+
+TEST(Scheduler, TestSystemDependency)
+{
+	sfge::Engine engine;
+	std::vector<int> order;
+	std::mutex orderMutex;
+	const auto transformMask = static_cast<sfge::EntityMask>(sfge::ComponentType::TRANSFORM2D);
+	const sfge::EntityMask noMask;
+
+	RecordingSystem transformSystem(engine, 0, noMask, transformMask, order, orderMutex);
+	//Declares no component, like the window clear
+	RecordingSystem clearSystem(engine, 1, noMask, noMask, order, orderMutex);
+
+	sfge::SystemScheduler scheduler;
+	scheduler.AddSystem(&transformSystem);
+	scheduler.AddSystem(&clearSystem);
+	scheduler.Build();
+	ASSERT_EQ(scheduler.GetWaves().size(), 1u);
+
+	scheduler.AddDependency(&transformSystem, &clearSystem);
+	scheduler.Build();
+	const auto& waves = scheduler.GetWaves();
+	ASSERT_EQ(waves.size(), 2u);
+	ASSERT_EQ(waves[0], std::vector<size_t>({ 0 }));
+	ASSERT_EQ(waves[1], std::vector<size_t>({ 1 }));
+}
+
+TEST(Scheduler, TestCommandBufferOrder)
+{
+	const size_t spawnNmb = 100;
+	std::vector<Entity> firstEntities;
+	for (int run = 0; run < 20; run++)
+	{
+		sfge::Engine engine;
+		auto config = std::make_unique<sfge::Configuration>();
+		config->devMode = false;
+		config->windowLess = true;
+		engine.Init(std::move(config));
+		auto* entityManager = engine.GetEntityManager();
+
+		SpawningSystem firstSystem(engine, 0.0f, spawnNmb);
+		SpawningSystem secondSystem(engine, 1.0f, spawnNmb);
+		sfge::SystemScheduler scheduler;
+		scheduler.AddSystem(&firstSystem);
+		scheduler.AddSystem(&secondSystem);
+		scheduler.Build();
+		ASSERT_EQ(scheduler.GetWaves().size(), 1u);
+
+		ctpl::thread_pool threadPool(2);
+		scheduler.Update(0.0f, threadPool, &entityManager->GetCommandBuffer());
+		entityManager->ApplyCommandBuffers();
+
+		//Same handles as running the first system then the second one, whatever worker ran them
+		std::vector<Entity> entities;
+		auto& transformView = entityManager->GetView<sfge::ComponentType::TRANSFORM2D>();
+		for (const Entity entity : transformView)
+		{
+			entities.push_back(entity);
+		}
+		std::sort(entities.begin(), entities.end());
+		ASSERT_EQ(entities.size(), 2 * spawnNmb);
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			const auto position = engine.GetTransform2dManager()->GetTransform(entities[i]).Position;
+			ASSERT_FLOAT_EQ(position.x, i < spawnNmb ? 0.0f : 1.0f);
+			ASSERT_FLOAT_EQ(position.y, static_cast<float>(i % spawnNmb));
+		}
+		if (run == 0)
+			firstEntities = entities;
+		ASSERT_EQ(entities, firstEntities);
+		engine.Destroy();
+	}
+}
@@ -0,0 +1,214 @@
+/*
+MIT License
+
+Copyright (c) 2017 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <engine/engine.h>
+#include <engine/config.h>
+#include <engine/transform2d.h>
+#include <gtest/gtest.h>
+
+TEST(Transform, TestWrapAngles)
+{
+	//Odd length to go through the vectorized and the scalar loops
+	std::vector<float> angles = { 190.0f, -190.0f, 0.0f, 180.0f, -180.0f, 359.0f, -359.0f, 90.0f, 270.0f, -270.0f, 45.0f };
+	std::vector<float> expected = angles;
+	for (auto& angle : expected)
+	{
+		if (angle > 180.0f)
+			angle -= 360.0f;
+		if (angle < -180.0f)
+			angle += 360.0f;
+	}
+	sfge::WrapAngles(angles.data(), angles.size());
+	for (auto i = 0u; i < angles.size(); i++)
+	{
+		ASSERT_FLOAT_EQ(angles[i], expected[i]);
+	}
+}
+
+TEST(Transform, TestTransformKernels)
+{
+	const size_t length = 13;
+	std::vector<float> positionsX(length, 1.0f);
+	std::vector<float> positionsY(length, 2.0f);
+	sfge::TranslatePositions(positionsX.data(), positionsY.data(), length, sfge::Vec2f(3.0f, -1.0f));
+	for (auto i = 0u; i < length; i++)
+	{
+		ASSERT_FLOAT_EQ(positionsX[i], 4.0f);
+		ASSERT_FLOAT_EQ(positionsY[i], 1.0f);
+	}
+
+	std::vector<float> offsetsX(length, 10.0f);
+	std::vector<float> offsetsY(length, 0.0f);
+	sfge::MetersToPixels(positionsX.data(), positionsY.data(), offsetsX.data(), offsetsY.data(),
+		positionsX.data(), positionsY.data(), length, 100.0f);
+	for (auto i = 0u; i < length; i++)
+	{
+		ASSERT_FLOAT_EQ(positionsX[i], 390.0f);
+		ASSERT_FLOAT_EQ(positionsY[i], 100.0f);
+	}
+}
+
+TEST(Transform, TestTransformStorageProxy)
+{
+	sfge::Transform2dStorage storage;
+	storage.resize(10);
+	auto transform = storage[3];
+	ASSERT_FLOAT_EQ(transform.Scale.x, 1.0f);
+
+	transform.Position = sfge::Vec2f(5.0f, 6.0f);
+	transform.SetEulerAngle(30.0f);
+	transform.Position += sfge::Vec2f(1.0f, 1.0f);
+	ASSERT_FLOAT_EQ(storage.GetPositionsX()[3], 6.0f);
+	ASSERT_FLOAT_EQ(storage.GetPositionsY()[3], 7.0f);
+
+	const sfge::Transform2d copy = storage[3];
+	ASSERT_FLOAT_EQ(copy.EulerAngle, 30.0f);
+
+	//Proxies stay valid when the storage grows
+	storage.resize(1000);
+	ASSERT_FLOAT_EQ(transform.Position.x, 6.0f);
+	ASSERT_FLOAT_EQ(storage[999].Scale.y, 1.0f);
+
+	auto transformPtr = storage.GetPtr(3);
+	transformPtr->Scale = sfge::Vec2f(2.0f, 2.0f);
+	ASSERT_FLOAT_EQ(storage.GetScalesX()[3], 2.0f);
+}
+
+TEST(Transform, TestTransformVersions)
+{
+	sfge::Transform2dStorage storage;
+	storage.resize(20);
+
+	//Reads do not count as changes
+	const unsigned version = storage.GetVersion(5);
+	const sfge::Transform2d transform = storage.Get(5);
+	ASSERT_FLOAT_EQ(transform.Scale.x, 1.0f);
+	ASSERT_EQ(storage.GetVersion(5), version);
+
+	//Nor do the reads through the mutable proxy
+	const sfge::Vec2f position = storage[5].Position;
+	ASSERT_FLOAT_EQ(storage.GetPtr(5)->GetEulerAngle(), 0.0f);
+	ASSERT_FLOAT_EQ(position.x, 0.0f);
+	ASSERT_EQ(storage.GetVersion(5), version);
+
+	storage[5].Position = sfge::Vec2f(1.0f, 1.0f);
+	ASSERT_NE(storage.GetVersion(5), version);
+	ASSERT_EQ(storage.GetVersion(4), version);
+	unsigned lastVersion = storage.GetVersion(5);
+	storage[5].Scale += sfge::Vec2f(1.0f, 1.0f);
+	ASSERT_NE(storage.GetVersion(5), lastVersion);
+	lastVersion = storage.GetVersion(5);
+	storage[5].SetEulerAngle(45.0f);
+	ASSERT_NE(storage.GetVersion(5), lastVersion);
+
+	//Only the wrapped angles get a new version
+	auto& angles = storage.GetAngles();
+	auto& versions = storage.GetVersions();
+	angles[2] = 270.0f;
+	angles[17] = -200.0f;
+	std::vector<unsigned> before(versions.begin(), versions.end());
+	sfge::WrapAngles(angles.GetPage(0), angles.GetPageLength(0), versions.GetPage(0));
+	for (auto i = 0u; i < storage.size(); i++)
+	{
+		if (i == 2 || i == 17)
+			ASSERT_NE(versions[i], before[i]);
+		else
+			ASSERT_EQ(versions[i], before[i]);
+	}
+	ASSERT_FLOAT_EQ(angles[2], -90.0f);
+	ASSERT_FLOAT_EQ(angles[17], 160.0f);
+}
+
+TEST(Transform, TestComposeTransforms)
+{
+	sfge::Transform2d parent;
+	parent.Position = sfge::Vec2f(100.0f, 50.0f);
+	parent.Scale = sfge::Vec2f(2.0f, 2.0f);
+	parent.EulerAngle = 90.0f;
+	sfge::Transform2d local;
+	local.Position = sfge::Vec2f(10.0f, 0.0f);
+	local.EulerAngle = 10.0f;
+
+	const auto world = sfge::ComposeTransforms(parent, local);
+	ASSERT_NEAR(world.Position.x, 100.0f, 0.001f);
+	ASSERT_NEAR(world.Position.y, 70.0f, 0.001f);
+	ASSERT_FLOAT_EQ(world.Scale.x, 2.0f);
+	ASSERT_FLOAT_EQ(world.EulerAngle, 100.0f);
+
+	const auto localPosition = sfge::InverseTransformPosition(parent, world.Position);
+	ASSERT_NEAR(localPosition.x, 10.0f, 0.001f);
+	ASSERT_NEAR(localPosition.y, 0.0f, 0.001f);
+}
+
+TEST(Transform, TestTransformHierarchy)
+{
+	sfge::Engine engine;
+	auto config = std::make_unique<sfge::Configuration>();
+	config->devMode = false;
+	config->windowLess = true;
+	engine.Init(std::move(config));
+
+	auto* entityManager = engine.GetEntityManager();
+	auto* transformManager = engine.GetTransform2dManager();
+	std::vector<Entity> entities;
+	for (int i = 0; i < 3; i++)
+	{
+		const Entity entity = entityManager->CreateEntity(INVALID_ENTITY);
+		transformManager->AddComponent(entity)->Position = sfge::Vec2f(10.0f, 0.0f);
+		entities.push_back(entity);
+	}
+	//Children attached before their parent still update after it
+	ASSERT_TRUE(transformManager->SetParent(entities[2], entities[1]));
+	ASSERT_TRUE(transformManager->SetParent(entities[1], entities[0]));
+	ASSERT_FALSE(transformManager->SetParent(entities[0], entities[2]));
+	transformManager->UpdateWorldTransforms();
+	ASSERT_FLOAT_EQ(transformManager->GetWorldTransform(entities[2]).Position.x, 30.0f);
+	ASSERT_EQ(transformManager->GetHierarchy().front().entity, entities[1]);
+
+	//Nothing changed, the world versions stay the same
+	const unsigned version = transformManager->GetWorldVersion(entities[2]);
+	transformManager->UpdateWorldTransforms();
+	ASSERT_EQ(transformManager->GetWorldVersion(entities[2]), version);
+
+	//Reading a transform like the Python systems do is not a change
+	const unsigned localVersion = transformManager->GetVersion(entities[0]);
+	const sfge::Vec2f rootPosition = transformManager->GetComponentRef(entities[0]).Position;
+	ASSERT_FLOAT_EQ(rootPosition.x, 10.0f);
+	ASSERT_FLOAT_EQ(transformManager->GetComponentPtr(entities[0])->Position.y, 0.0f);
+	ASSERT_EQ(transformManager->GetVersion(entities[0]), localVersion);
+
+	//Moving the root updates the whole branch
+	transformManager->GetComponentPtr(entities[0])->Position = sfge::Vec2f(0.0f, 5.0f);
+	transformManager->UpdateWorldTransforms();
+	ASSERT_NE(transformManager->GetWorldVersion(entities[2]), version);
+	ASSERT_FLOAT_EQ(transformManager->GetWorldTransform(entities[2]).Position.x, 20.0f);
+	ASSERT_FLOAT_EQ(transformManager->GetWorldTransform(entities[2]).Position.y, 5.0f);
+
+	//Destroying a parent keeps the children where they are
+	entityManager->DestroyEntity(entities[1]);
+	ASSERT_EQ(transformManager->GetParent(entities[2]), INVALID_ENTITY);
+	ASSERT_FLOAT_EQ(transformManager->GetWorldTransform(entities[2]).Position.x, 20.0f);
+	ASSERT_TRUE(transformManager->GetHierarchy().empty());
+	engine.Destroy();
+}